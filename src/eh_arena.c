@@ -0,0 +1,169 @@
+/**
+ * @file eh_arena.c
+ * @brief 区域(arena)分配器的实现，块以单链表串起来，cur之前的块已用过，
+ *        reset时只把cur拨回第一个块，后面的块在重新走到时才清零游标
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <eh.h>
+#include <eh_error.h>
+#include <eh_list.h>
+#include <eh_event.h>
+#include <eh_mem.h>
+#include <eh_platform.h>
+#include <eh_internal.h>
+#include <eh_arena.h>
+
+#define EH_ARENA_ALIGN              (sizeof(void*)*2)
+#define EH_ARENA_CHUNK_HEAD_SIZE    eh_align_up(sizeof(struct eh_arena_chunk), EH_ARENA_ALIGN)
+#define EH_ARENA_ALLOC_MAX          (SIZE_MAX - EH_ARENA_ALIGN - EH_ARENA_CHUNK_HEAD_SIZE)
+
+struct eh_arena_chunk{
+    struct eh_arena_chunk       *next;
+    size_t                      size;
+    size_t                      pos;
+};
+
+struct eh_arena{
+    struct eh_arena_chunk       *head;
+    struct eh_arena_chunk       *cur;
+    size_t                      chunk_size;
+    eh_task_t                   *task;
+    struct eh_list_head         task_node;
+    size_t                      chunk_cnt;
+    size_t                      capacity;
+    size_t                      used;
+    size_t                      high_water;
+    size_t                      alloc_cnt;
+};
+
+#define chunk_data(chunk)           ((uint8_t*)(chunk) + EH_ARENA_CHUNK_HEAD_SIZE)
+
+eh_arena_t eh_arena_create(size_t chunk_size){
+    struct eh_arena *arena;
+    if(chunk_size == 0 || chunk_size > EH_ARENA_ALLOC_MAX)
+        return eh_error_to_ptr(EH_RET_INVALID_PARAM);
+    arena = eh_malloc(sizeof(struct eh_arena));
+    if(arena == NULL)
+        return eh_error_to_ptr(EH_RET_MALLOC_ERROR);
+    arena->head = NULL;
+    arena->cur = NULL;
+    arena->chunk_size = eh_align_up(chunk_size, EH_ARENA_ALIGN);
+    arena->task = NULL;
+    eh_list_head_init(&arena->task_node);
+    arena->chunk_cnt = 0;
+    arena->capacity = 0;
+    arena->used = 0;
+    arena->high_water = 0;
+    arena->alloc_cnt = 0;
+    return (eh_arena_t)arena;
+}
+
+void eh_arena_destroy(eh_arena_t _arena){
+    struct eh_arena *arena = (struct eh_arena *)_arena;
+    struct eh_arena_chunk *chunk, *next;
+    eh_list_del(&arena->task_node);
+    for(chunk = arena->head; chunk; chunk = next){
+        next = chunk->next;
+        eh_free(chunk);
+    }
+    eh_free(arena);
+}
+
+static struct eh_arena_chunk* arena_chunk_new(struct eh_arena *arena, size_t size){
+    struct eh_arena_chunk *chunk;
+    chunk = eh_malloc(EH_ARENA_CHUNK_HEAD_SIZE + size);
+    if(chunk == NULL)
+        return NULL;
+    chunk->size = size;
+    chunk->pos = 0;
+    arena->chunk_cnt++;
+    arena->capacity += size;
+    return chunk;
+}
+
+void* eh_arena_alloc(eh_arena_t _arena, size_t size){
+    struct eh_arena *arena = (struct eh_arena *)_arena;
+    struct eh_arena_chunk *chunk = arena->cur;
+    struct eh_arena_chunk *new_chunk;
+    void *ptr;
+
+    /* 对齐和加上块头都不能溢出 */
+    if(size > EH_ARENA_ALLOC_MAX)
+        return NULL;
+    size = eh_align_up(size, EH_ARENA_ALIGN);
+    if(chunk && chunk->size - chunk->pos >= size)
+        goto out;
+
+    /* 当前块放不下，复用后面上一轮留下的块 */
+    if(chunk && chunk->next && chunk->next->size >= size){
+        chunk = chunk->next;
+        chunk->pos = 0;
+        goto out;
+    }
+    if(chunk == NULL && arena->head && arena->head->size >= size){
+        chunk = arena->head;
+        chunk->pos = 0;
+        goto out;
+    }
+
+    /* 插入到当前块之后，后面留下的块保持不动 */
+    new_chunk = arena_chunk_new(arena, size > arena->chunk_size ? size : arena->chunk_size);
+    if(new_chunk == NULL)
+        return NULL;
+    if(chunk){
+        new_chunk->next = chunk->next;
+        chunk->next = new_chunk;
+    }else{
+        new_chunk->next = arena->head;
+        arena->head = new_chunk;
+    }
+    chunk = new_chunk;
+out:
+    arena->cur = chunk;
+    ptr = chunk_data(chunk) + chunk->pos;
+    chunk->pos += size;
+    arena->used += size;
+    arena->alloc_cnt++;
+    if(arena->used > arena->high_water)
+        arena->high_water = arena->used;
+    return ptr;
+}
+
+void eh_arena_reset(eh_arena_t _arena){
+    struct eh_arena *arena = (struct eh_arena *)_arena;
+    arena->cur = NULL;
+    arena->used = 0;
+    arena->alloc_cnt = 0;
+}
+
+int eh_arena_bind_task(eh_arena_t _arena, eh_task_t *task){
+    struct eh_arena *arena = (struct eh_arena *)_arena;
+    eh_param_assert(arena);
+    eh_list_del_init(&arena->task_node);
+    arena->task = task;
+    if(task)
+        eh_list_add_tail(&arena->task_node, &task->arena_list_head);
+    return EH_RET_OK;
+}
+
+void eh_arena_get_stat(eh_arena_t _arena, struct eh_arena_stat *stat){
+    struct eh_arena *arena = (struct eh_arena *)_arena;
+    stat->chunk_cnt = arena->chunk_cnt;
+    stat->capacity = arena->capacity;
+    stat->used = arena->used;
+    stat->high_water = arena->high_water;
+    stat->alloc_cnt = arena->alloc_cnt;
+}
+
+void eh_arena_task_release(eh_task_t *task){
+    struct eh_arena *arena, *n;
+    eh_list_for_each_entry_safe(arena, n, &task->arena_list_head, task_node)
+        eh_arena_destroy((eh_arena_t)arena);
+}
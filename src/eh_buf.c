@@ -0,0 +1,248 @@
+/**
+ * @file eh_buf.c
+ * @brief 引用计数零拷贝缓冲区的实现，存储块头部记录引用计数和来源内存池，
+ *        视图对象从对象缓存(slab)分配，创建切片只需分配一个视图并增加引用计数
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <eh.h>
+#include <eh_atomic.h>
+#include <eh_error.h>
+#include <eh_mem.h>
+#include <eh_mem_pool.h>
+#include <eh_slab.h>
+#include <eh_platform.h>
+#include <eh_buf.h>
+
+#define EH_BUF_ALIGN                (sizeof(void*)*2)
+#define EH_BUF_STORAGE_HEAD_SIZE    eh_align_up(sizeof(struct eh_buf_storage), EH_BUF_ALIGN)
+
+struct eh_buf_pool{
+    eh_mem_pool_t               mem_pool;
+    size_t                      buf_size;
+    size_t                      inuse_cnt;
+    size_t                      max_inuse_cnt;
+    size_t                      alloc_cnt;
+};
+
+struct eh_buf_storage{
+    uint32_t                    refcnt;
+    struct eh_buf_pool          *pool;                  /* 来自eh_malloc时为NULL */
+};
+
+#define storage_data(storage)       ((uint8_t*)(storage) + EH_BUF_STORAGE_HEAD_SIZE)
+
+EH_DEFINE_STATIC_SLAB_CACHE(eh_buf_cache, struct eh_buf);
+
+eh_buf_pool_t eh_buf_pool_create(size_t buf_size, size_t chunk_num){
+    struct eh_buf_pool *pool;
+    if(buf_size == 0 || chunk_num == 0)
+        return eh_error_to_ptr(EH_RET_INVALID_PARAM);
+    pool = eh_malloc(sizeof(struct eh_buf_pool));
+    if(pool == NULL)
+        return eh_error_to_ptr(EH_RET_MALLOC_ERROR);
+    pool->mem_pool = eh_mem_pool_create_growable(EH_BUF_ALIGN, EH_BUF_STORAGE_HEAD_SIZE + buf_size,
+        chunk_num, EH_MEM_POOL_FLAGS_RELEASE_EMPTY_CHUNK);
+    if(eh_ptr_to_error(pool->mem_pool) < 0){
+        eh_free(pool);
+        return eh_error_to_ptr(EH_RET_MALLOC_ERROR);
+    }
+    pool->buf_size = buf_size;
+    pool->inuse_cnt = 0;
+    pool->max_inuse_cnt = 0;
+    pool->alloc_cnt = 0;
+    return (eh_buf_pool_t)pool;
+}
+
+void eh_buf_pool_destroy(eh_buf_pool_t _pool){
+    struct eh_buf_pool *pool = (struct eh_buf_pool *)_pool;
+    eh_mem_pool_destroy(pool->mem_pool);
+    eh_free(pool);
+}
+
+void eh_buf_pool_get_stat(eh_buf_pool_t _pool, struct eh_buf_pool_stat *stat){
+    struct eh_buf_pool *pool = (struct eh_buf_pool *)_pool;
+    eh_save_state_t state;
+    state = eh_enter_critical();
+    stat->buf_size = pool->buf_size;
+    stat->inuse_cnt = pool->inuse_cnt;
+    stat->max_inuse_cnt = pool->max_inuse_cnt;
+    stat->alloc_cnt = pool->alloc_cnt;
+    eh_exit_critical(state);
+}
+
+static eh_buf_t* buf_view_new(struct eh_buf_storage *storage, uint8_t *data, size_t len){
+    eh_buf_t *buf = eh_slab_alloc(&eh_buf_cache);
+    if(buf == NULL)
+        return NULL;
+    buf->storage = storage;
+    buf->data = data;
+    buf->len = len;
+    buf->next = NULL;
+    return buf;
+}
+
+static void buf_storage_put(struct eh_buf_storage *storage){
+    struct eh_buf_pool *pool;
+    eh_save_state_t state;
+
+    if(eh_atomic_fetch_sub_explicit(&storage->refcnt, 1, eh_memory_order_acq_rel) != 1)
+        return ;
+    pool = storage->pool;
+    if(pool == NULL){
+        eh_free(storage);
+        return ;
+    }
+    state = eh_enter_critical();
+    pool->inuse_cnt--;
+    eh_mem_pool_free(pool->mem_pool, storage);
+    eh_exit_critical(state);
+}
+
+eh_buf_t* eh_buf_pool_alloc(eh_buf_pool_t _pool){
+    struct eh_buf_pool *pool = (struct eh_buf_pool *)_pool;
+    struct eh_buf_storage *storage;
+    eh_save_state_t state;
+    eh_buf_t *buf;
+
+    state = eh_enter_critical();
+    storage = eh_mem_pool_alloc(pool->mem_pool);
+    if(storage){
+        pool->alloc_cnt++;
+        pool->inuse_cnt++;
+        if(pool->inuse_cnt > pool->max_inuse_cnt)
+            pool->max_inuse_cnt = pool->inuse_cnt;
+    }
+    eh_exit_critical(state);
+    if(storage == NULL)
+        return NULL;
+    storage->refcnt = 1;
+    storage->pool = pool;
+    buf = buf_view_new(storage, storage_data(storage), pool->buf_size);
+    if(buf == NULL)
+        buf_storage_put(storage);
+    return buf;
+}
+
+eh_buf_t* eh_buf_alloc(size_t size){
+    struct eh_buf_storage *storage;
+    eh_buf_t *buf;
+
+    if(size > SIZE_MAX - EH_BUF_STORAGE_HEAD_SIZE)
+        return NULL;
+    storage = eh_malloc(EH_BUF_STORAGE_HEAD_SIZE + size);
+    if(storage == NULL)
+        return NULL;
+    storage->refcnt = 1;
+    storage->pool = NULL;
+    buf = buf_view_new(storage, storage_data(storage), size);
+    if(buf == NULL)
+        eh_free(storage);
+    return buf;
+}
+
+eh_buf_t* eh_buf_slice(eh_buf_t *buf, size_t offset, size_t len){
+    eh_buf_t *slice;
+    if(offset > buf->len || len > buf->len - offset)
+        return NULL;
+    slice = buf_view_new(buf->storage, buf->data + offset, len);
+    if(slice == NULL)
+        return NULL;
+    eh_atomic_fetch_add_explicit(&buf->storage->refcnt, 1, eh_memory_order_relaxed);
+    return slice;
+}
+
+eh_buf_t* eh_buf_ref(eh_buf_t *buf){
+    return eh_buf_slice(buf, 0, buf->len);
+}
+
+void eh_buf_unref(eh_buf_t *buf){
+    if(buf == NULL)
+        return ;
+    buf_storage_put(buf->storage);
+    eh_slab_free(&eh_buf_cache, buf);
+}
+
+bool eh_buf_is_shared(const eh_buf_t *buf){
+    return eh_atomic_load_explicit(&buf->storage->refcnt, eh_memory_order_acquire) > 1;
+}
+
+void eh_buf_chain_append(struct eh_buf_chain *chain, eh_buf_t *buf){
+    buf->next = NULL;
+    *chain->tail = buf;
+    chain->tail = &buf->next;
+    chain->len += buf->len;
+    chain->cnt++;
+}
+
+void eh_buf_chain_splice(struct eh_buf_chain *dst, struct eh_buf_chain *src){
+    if(src->head == NULL)
+        return ;
+    *dst->tail = src->head;
+    dst->tail = src->tail;
+    dst->len += src->len;
+    dst->cnt += src->cnt;
+    eh_buf_chain_init(src);
+}
+
+eh_buf_t* eh_buf_chain_pop(struct eh_buf_chain *chain){
+    eh_buf_t *buf = chain->head;
+    if(buf == NULL)
+        return NULL;
+    chain->head = buf->next;
+    if(chain->head == NULL)
+        chain->tail = &chain->head;
+    chain->len -= buf->len;
+    chain->cnt--;
+    buf->next = NULL;
+    return buf;
+}
+
+void eh_buf_chain_pull(struct eh_buf_chain *chain, size_t len){
+    eh_buf_t *buf;
+    while(len && chain->head){
+        buf = chain->head;
+        if(len < buf->len){
+            eh_buf_pull(buf, len);
+            chain->len -= len;
+            return ;
+        }
+        len -= buf->len;
+        eh_buf_unref(eh_buf_chain_pop(chain));
+    }
+}
+
+size_t eh_buf_chain_copy_out(const struct eh_buf_chain *chain, size_t offset, void *dst, size_t len){
+    const eh_buf_t *buf;
+    uint8_t *out = (uint8_t*)dst;
+    size_t n, copied = 0;
+
+    for(buf = chain->head; buf && copied < len; buf = buf->next){
+        if(offset >= buf->len){
+            offset -= buf->len;
+            continue;
+        }
+        n = buf->len - offset;
+        n = n < len - copied ? n : len - copied;
+        memcpy(out + copied, buf->data + offset, n);
+        copied += n;
+        offset = 0;
+    }
+    return copied;
+}
+
+void eh_buf_chain_clear(struct eh_buf_chain *chain){
+    eh_buf_t *buf, *next;
+    for(buf = chain->head; buf; buf = next){
+        next = buf->next;
+        eh_buf_unref(buf);
+    }
+    eh_buf_chain_init(chain);
+}
@@ -0,0 +1,243 @@
+/**
+ * @file eh_channel.c
+ * @brief 任务间的定长元素通道，元素存放在按元素计的环形缓冲区中，所有状态在临界区内修改，
+ *        等待借助 eh_event_wait_condition_timeout，被唤醒后重新检查条件，因此只在状态跳变时通知也不会丢失唤醒
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <eh.h>
+#include <eh_error.h>
+#include <eh_event.h>
+#include <eh_mem.h>
+#include <eh_platform.h>
+#include <eh_slab.h>
+#include <eh_channel.h>
+
+/* 无界通道的初始缓冲区元素个数 */
+#define EH_CHANNEL_UNBOUNDED_INIT_CNT       16
+
+struct eh_channel{
+    eh_event_t                  recv_event;             /* 由空变为非空或关闭时通知 */
+    eh_event_t                  send_event;             /* 由满变为不满或关闭时通知 */
+    uint8_t                     *buf;
+    uint32_t                    elem_size;
+    uint32_t                    buf_cnt;                /* 缓冲区能放下的元素个数 */
+    uint32_t                    limit;                  /* 0表示无界 */
+    uint32_t                    head;
+    uint32_t                    cnt;
+    bool                        closed;
+};
+
+EH_DEFINE_STATIC_SLAB_CACHE(channel_cache, struct eh_channel);
+
+static bool condition_recv(void *arg){
+    struct eh_channel *channel = (struct eh_channel *)arg;
+    return channel->cnt > 0 || channel->closed;
+}
+
+static bool condition_send(void *arg){
+    struct eh_channel *channel = (struct eh_channel *)arg;
+    return channel->limit == 0 || channel->cnt < channel->limit || channel->closed;
+}
+
+eh_channel_t eh_channel_create(size_t elem_size, uint32_t capacity){
+    struct eh_channel *channel;
+    uint32_t buf_cnt = capacity ? capacity : EH_CHANNEL_UNBOUNDED_INIT_CNT;
+
+    if(elem_size == 0 || elem_size > UINT16_MAX || buf_cnt > SIZE_MAX / elem_size)
+        return eh_error_to_ptr(EH_RET_INVALID_PARAM);
+    channel = eh_slab_alloc(&channel_cache);
+    if(channel == NULL)
+        return eh_error_to_ptr(EH_RET_MALLOC_ERROR);
+    channel->buf = eh_malloc(elem_size * buf_cnt);
+    if(channel->buf == NULL){
+        eh_slab_free(&channel_cache, channel);
+        return eh_error_to_ptr(EH_RET_MALLOC_ERROR);
+    }
+    channel->elem_size = (uint32_t)elem_size;
+    channel->buf_cnt = buf_cnt;
+    channel->limit = capacity;
+    channel->head = 0;
+    channel->cnt = 0;
+    channel->closed = false;
+    eh_event_init(&channel->recv_event);
+    eh_event_init(&channel->send_event);
+    return (eh_channel_t)channel;
+}
+
+void eh_channel_destroy(eh_channel_t _channel){
+    struct eh_channel *channel = (struct eh_channel *)_channel;
+    eh_event_clean(&channel->recv_event);
+    eh_event_clean(&channel->send_event);
+    eh_free(channel->buf);
+    eh_slab_free(&channel_cache, channel);
+}
+
+void eh_channel_close(eh_channel_t _channel){
+    struct eh_channel *channel = (struct eh_channel *)_channel;
+    eh_save_state_t state;
+    state = eh_enter_critical();
+    channel->closed = true;
+    eh_event_notify(&channel->recv_event);
+    eh_event_notify(&channel->send_event);
+    eh_exit_critical(state);
+}
+
+/* 无界通道空间不足时倍增，在临界区外申请内存，回到临界区后缓冲区可能已被其他发送者扩大 */
+static int channel_grow(struct eh_channel *channel, uint32_t need){
+    eh_save_state_t state;
+    uint32_t buf_cnt, first;
+    uint8_t *buf, *old_buf;
+
+    state = eh_enter_critical();
+    buf_cnt = channel->buf_cnt;
+    eh_exit_critical(state);
+    if(need > UINT32_MAX / 2)
+        return EH_RET_MALLOC_ERROR;
+    while(buf_cnt < need)
+        buf_cnt <<= 1;
+    buf = eh_malloc((size_t)channel->elem_size * buf_cnt);
+    if(buf == NULL)
+        return EH_RET_MALLOC_ERROR;
+    state = eh_enter_critical();
+    if(channel->buf_cnt >= buf_cnt){
+        eh_exit_critical(state);
+        eh_free(buf);
+        return EH_RET_OK;
+    }
+    /* 按顺序搬到新缓冲区开头 */
+    first = channel->buf_cnt - channel->head;
+    first = first < channel->cnt ? first : channel->cnt;
+    memcpy(buf, channel->buf + (size_t)channel->head * channel->elem_size, (size_t)first * channel->elem_size);
+    memcpy(buf + (size_t)first * channel->elem_size, channel->buf, (size_t)(channel->cnt - first) * channel->elem_size);
+    old_buf = channel->buf;
+    channel->buf = buf;
+    channel->buf_cnt = buf_cnt;
+    channel->head = 0;
+    eh_exit_critical(state);
+    eh_free(old_buf);
+    return EH_RET_OK;
+}
+
+static uint32_t channel_put_no_lock(struct eh_channel *channel, const uint8_t *elems, uint32_t n){
+    uint32_t space = (channel->limit ? channel->limit : channel->buf_cnt) - channel->cnt;
+    uint32_t tail, first;
+
+    n = n < space ? n : space;
+    if(n == 0)
+        return 0;
+    tail = (channel->head + channel->cnt) % channel->buf_cnt;
+    first = channel->buf_cnt - tail;
+    first = first < n ? first : n;
+    memcpy(channel->buf + (size_t)tail * channel->elem_size, elems, (size_t)first * channel->elem_size);
+    memcpy(channel->buf, elems + (size_t)first * channel->elem_size, (size_t)(n - first) * channel->elem_size);
+    if(channel->cnt == 0)
+        eh_event_notify(&channel->recv_event);
+    channel->cnt += n;
+    return n;
+}
+
+static uint32_t channel_get_no_lock(struct eh_channel *channel, uint8_t *elems, uint32_t n){
+    uint32_t first;
+
+    n = n < channel->cnt ? n : channel->cnt;
+    if(n == 0)
+        return 0;
+    first = channel->buf_cnt - channel->head;
+    first = first < n ? first : n;
+    memcpy(elems, channel->buf + (size_t)channel->head * channel->elem_size, (size_t)first * channel->elem_size);
+    memcpy(elems + (size_t)first * channel->elem_size, channel->buf, (size_t)(n - first) * channel->elem_size);
+    if(channel->limit && channel->cnt == channel->limit)
+        eh_event_notify(&channel->send_event);
+    channel->head = (channel->head + n) % channel->buf_cnt;
+    channel->cnt -= n;
+    return n;
+}
+
+static int channel_put(struct eh_channel *channel, const void *elems, uint32_t n){
+    eh_save_state_t state;
+    uint32_t need = 0;
+    int ret;
+
+    for(;;){
+        state = eh_enter_critical();
+        if(channel->closed){
+            ret = EH_RET_INVALID_STATE;
+        }else if(channel->limit == 0 && channel->buf_cnt - channel->cnt < n){
+            need = channel->cnt + n;
+            ret = EH_RET_AGAIN;
+        }else{
+            ret = (int)channel_put_no_lock(channel, (const uint8_t *)elems, n);
+            if(ret == 0)
+                ret = EH_RET_BUSY;
+        }
+        eh_exit_critical(state);
+        if(ret != EH_RET_AGAIN)
+            return ret;
+        ret = channel_grow(channel, need);
+        if(ret < 0)
+            return ret;
+    }
+}
+
+int __async eh_channel_send_many(eh_channel_t _channel, const void *elems, uint32_t n, eh_sclock_t timeout){
+    struct eh_channel *channel = (struct eh_channel *)_channel;
+    int ret;
+
+    if(n == 0 || n > INT32_MAX)
+        return EH_RET_INVALID_PARAM;
+    for(;;){
+        ret = __await eh_event_wait_condition_timeout(&channel->send_event, channel, condition_send, timeout);
+        if(ret < 0)
+            return ret;
+        /* 其他线程中的 eh_channel_try_send 可能先一步填满了通道 */
+        ret = channel_put(channel, elems, n);
+        if(ret != EH_RET_BUSY)
+            return ret;
+    }
+}
+
+int __async eh_channel_recv_many(eh_channel_t _channel, void *elems, uint32_t max, eh_sclock_t timeout){
+    struct eh_channel *channel = (struct eh_channel *)_channel;
+    eh_save_state_t state;
+    int ret;
+
+    if(max == 0 || max > INT32_MAX)
+        return EH_RET_INVALID_PARAM;
+    ret = __await eh_event_wait_condition_timeout(&channel->recv_event, channel, condition_recv, timeout);
+    if(ret < 0)
+        return ret;
+    state = eh_enter_critical();
+    ret = (int)channel_get_no_lock(channel, (uint8_t *)elems, max);
+    if(ret == 0)
+        ret = EH_RET_INVALID_STATE;
+    eh_exit_critical(state);
+    return ret;
+}
+
+int __async eh_channel_send(eh_channel_t channel, const void *elem, eh_sclock_t timeout){
+    int ret = __await eh_channel_send_many(channel, elem, 1, timeout);
+    return ret < 0 ? ret : EH_RET_OK;
+}
+
+int __async eh_channel_recv(eh_channel_t channel, void *elem, eh_sclock_t timeout){
+    int ret = __await eh_channel_recv_many(channel, elem, 1, timeout);
+    return ret < 0 ? ret : EH_RET_OK;
+}
+
+int eh_channel_try_send(eh_channel_t _channel, const void *elem){
+    int ret = channel_put((struct eh_channel *)_channel, elem, 1);
+    return ret < 0 ? ret : EH_RET_OK;
+}
+
+uint32_t eh_channel_len(eh_channel_t _channel){
+    struct eh_channel *channel = (struct eh_channel *)_channel;
+    return channel->cnt;
+}
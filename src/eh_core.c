@@ -56,6 +56,7 @@ static void _task_destroy(eh_task_t *task){
     eh_save_state_t state;
     if(task->system_data && task->system_data_destruct_function)
         task->system_data_destruct_function(task);
+    eh_arena_task_release(task);
     eh_event_clean(&task->event);
     state = eh_enter_critical();
     eh_list_del(&task->task_list_node);
@@ -234,6 +235,7 @@ static void _eh_task_struct_init(eh_task_t *task, int is_static_stack, uint32_t
     task->is_static_stack = !!is_static_stack;
     task->system_data = NULL;
     task->system_data_destruct_function = NULL;
+    eh_list_head_init(&task->arena_list_head);
     eh_event_init(&task->event);
 }
 
@@ -443,6 +445,7 @@ static __exit void main_task_exit(void){
     /* 清理main 任务的一些资源 */
     if(s_main_task.system_data && s_main_task.system_data_destruct_function)
         s_main_task.system_data_destruct_function(&s_main_task);
+    eh_arena_task_release(&s_main_task);
 }
 
 eh_main_task_module_export(main_task_init, main_task_exit);
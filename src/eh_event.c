@@ -19,6 +19,10 @@
 #include <eh_rbtree.h>
 #include <eh_timer.h>
 #include <eh_types.h>
+#include <eh_slab.h>
+
+EH_DEFINE_STATIC_SLAB_CACHE(epoll_receptor_cache, struct eh_event_epoll_receptor);
+EH_DEFINE_STATIC_SLAB_CACHE(epoll_cache, struct eh_epoll);
 
 
 static int __async _eh_event_wait(eh_event_t *e, void* arg, bool (*condition)(void* arg)){
@@ -146,7 +150,7 @@ struct epoll_new_node_param{
 static struct eh_rbtree_node *_eh_event_epoll_new_node_callback(void *user_data){
     struct epoll_new_node_param *param = user_data;
     struct eh_event_epoll_receptor *receptor;
-    receptor = eh_malloc(sizeof(struct eh_event_epoll_receptor));
+    receptor = eh_slab_alloc(&epoll_receptor_cache);
     if( receptor == NULL ){
         param->ret = EH_RET_MALLOC_ERROR;
         return NULL;
@@ -261,7 +265,7 @@ static int __epoll_rbtree_match(const void *key, const struct eh_rbtree_node *b)
 }
 
 eh_epoll_t eh_epoll_new(void){
-    struct eh_epoll *epoll = eh_malloc(sizeof(struct eh_epoll));
+    struct eh_epoll *epoll = eh_slab_alloc(&epoll_cache);
     if( epoll == NULL )
         return eh_error_to_ptr(EH_RET_MALLOC_ERROR);
     eh_list_head_init(&epoll->pending_list_head);
@@ -279,10 +283,10 @@ void eh_epoll_del_advanced(eh_epoll_t _epoll, void (*free_func)(void *node_handl
         if(free_func)
             free_func(pos);
         eh_event_remove_receptor_no_lock(&pos->receptor);
-        eh_free(pos);
+        eh_slab_free(&epoll_receptor_cache, pos);
     }
     eh_exit_critical(state);
-    eh_free(epoll);
+    eh_slab_free(&epoll_cache, epoll);
 }
 
 
@@ -368,7 +372,7 @@ extern void eh_epoll_del_event_from_handle_no_lock(eh_epoll_t _epoll, void* node
     eh_event_remove_receptor_no_lock(&epoll_receptor->receptor);
     eh_list_del(&epoll_receptor->pending_list_node);
     eh_rb_del(&epoll_receptor->rb_node, &epoll->all_receptor_tree);
-    eh_free(epoll_receptor);
+    eh_slab_free(&epoll_receptor_cache, epoll_receptor);
 }
 
 
@@ -394,7 +398,7 @@ int eh_epoll_del_event(eh_epoll_t _epoll,eh_event_t *e){
     eh_list_del(&epoll_receptor->pending_list_node);
     eh_rb_del(&epoll_receptor->rb_node, &epoll->all_receptor_tree);
     eh_exit_critical(state);
-    eh_free(epoll_receptor);
+    eh_slab_free(&epoll_receptor_cache, epoll_receptor);
     return EH_RET_OK;
 }
 
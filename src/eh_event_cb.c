@@ -16,6 +16,7 @@
 #include <eh_internal.h>
 #include <eh_debug.h>
 #include <eh_mem.h>
+#include <eh_slab.h>
 
 
 #define EH_EVENT_CB_EPOLL_SLOT_SIZE 8
@@ -27,6 +28,8 @@ struct eh_event_cb_trigger{
     uint32_t                forced_ref:1;
 };
 
+EH_DEFINE_STATIC_SLAB_CACHE(trigger_cache, struct eh_event_cb_trigger);
+
 #define trigger_init(trigger) do{               \
     eh_list_head_init(&trigger->cb_head);       \
     trigger->rc = 0;                            \
@@ -34,7 +37,7 @@ struct eh_event_cb_trigger{
 
 
 static struct eh_event_cb_trigger * trigger_weak_ref_new(void){
-    struct eh_event_cb_trigger *trigger = eh_malloc(sizeof(struct eh_event_cb_trigger));
+    struct eh_event_cb_trigger *trigger = eh_slab_alloc(&trigger_cache);
     if(trigger == NULL){
         return NULL;
     }
@@ -56,7 +59,7 @@ static inline uint32_t trigger_disconnect(struct eh_event_cb_trigger *trigger, e
     if(trigger->connect_cnt == 0 && trigger->forced_ref == 0){
         if(!eh_list_empty(&trigger->cb_head))
             eh_warnfl("trigger_disconnect: trigger %#p is not empty", trigger);
-        eh_free(trigger);
+        eh_slab_free(&trigger_cache, trigger);
     }
     return ret;
 }
@@ -68,7 +71,7 @@ static inline void trigger_forced_get_ref(struct eh_event_cb_trigger *trigger){
 static inline void trigger_forced_release_ref(struct eh_event_cb_trigger *trigger){
     trigger->forced_ref = 0;
     if(trigger->connect_cnt == 0){
-        eh_free(trigger);
+        eh_slab_free(&trigger_cache, trigger);
     }
 }
 
@@ -81,7 +84,7 @@ static void trigger_clean(struct eh_event_cb_trigger *trigger){
     }
     trigger->connect_cnt = 0;
     if(trigger->forced_ref == 0)
-        eh_free(trigger);
+        eh_slab_free(&trigger_cache, trigger);
 }
 
 static void epoll_userdata_free(void *node_handle){
@@ -96,7 +99,7 @@ static void epoll_userdata_free(void *node_handle){
         eh_warnfl("slot %#p is not disconnected", slot);
         eh_list_del_init(&slot->cb_node);
     }
-    eh_free(trigger);
+    eh_slab_free(&trigger_cache, trigger);
 }
 
 static void task_system_data_destruct_function(eh_task_t *task){
@@ -9,6 +9,8 @@
  */
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 #include <eh.h>
 #include <eh_debug.h>
 #include <eh_error.h>
@@ -17,6 +19,16 @@
 #include <eh_config.h>
 #include <eh_platform.h>
 
+#if EH_CONFIG_MEM_PROFILE
+/* 分析模式下由 eh_mem_profile.c 提供 eh_malloc/eh_free 并调用这里的实现 */
+#define eh_malloc                   eh_mem_raw_malloc
+#define eh_free                     eh_mem_raw_free
+#define eh_calloc                   eh_mem_raw_calloc
+#define eh_realloc                  eh_mem_raw_realloc
+#define eh_malloc_aligned           eh_mem_raw_malloc_aligned
+#define eh_malloc_from              eh_mem_raw_malloc_from
+#endif
+
 typedef unsigned long eh_size_t;
 
 #ifndef EH_DBG_MODULE_LEVEL_MEM_ALLOC
@@ -42,9 +54,53 @@ void  eh_free(void* ptr){
     free(ptr);
     eh_exit_critical(state);
 }
+void* eh_calloc(size_t nmemb, size_t size){
+    void *new;
+    eh_save_state_t state;
+    if(size && nmemb > SIZE_MAX / size)
+        return NULL;
+    state = eh_enter_critical();
+    new = calloc(nmemb, size);
+    eh_exit_critical(state);
+    return new;
+}
+void* eh_realloc(void* ptr, size_t size){
+    void *new;
+    eh_save_state_t state;
+    if(size == 0){
+        eh_free(ptr);
+        return NULL;
+    }
+    state = eh_enter_critical();
+    new = realloc(ptr, size);
+    eh_exit_critical(state);
+    return new;
+}
+/* libc下没有多个堆，heap_id被忽略 */
+void* eh_malloc_from(int heap_id, size_t size){
+    (void)heap_id;
+    return eh_malloc(size);
+}
+void* eh_malloc_aligned(size_t align, size_t size){
+    void *new;
+    eh_save_state_t state;
+    if(align == 0 || (align & (align - 1)) || size == 0)
+        return NULL;
+    if(align < sizeof(void*))
+        align = sizeof(void*);
+    /* C11要求aligned_alloc的size是align的整数倍 */
+    if(size + align - 1 < size)
+        return NULL;
+    size = eh_align_up(size, align);
+    state = eh_enter_critical();
+    new = aligned_alloc(align, size);
+    eh_exit_critical(state);
+    return new;
+}
 
-#else 
+#elif (EH_CONFIG_MEM_USE_TLSF == 0)
 
+/* EH_CONFIG_MEM_USE_TLSF 为1时使用 eh_mem_tlsf.c 中的实现 */
 
 struct eh_mem_block {
     struct eh_mem_block*    next;
@@ -76,30 +132,67 @@ static size_t mem_heap_array_cnt = 0;
 #endif
 
 /**
- *   此处使用结构体将内部变量放在结构体中，避免编译器优化时将 first_block 
- *   和 mem_heap_array优化为前后关系，这样会在插入时触发合并算法，
- *   会导致eh_malloc运行异常
+ *   每个堆一条独立的按地址排序的空闲链表，first_block 为链表头，
+ *   first_block 后面紧跟其他成员，避免堆空间与 first_block 前后相邻时
+ *   在插入时触发合并算法，导致eh_malloc运行异常
  */
-struct {
+struct eh_mem_heap_ctl {
     struct eh_mem_block first_block;
+    uint8_t   *start;
+    uint8_t   *end;
+    uint32_t  flags;
     eh_size_t mem_total_size;
     eh_size_t mem_free_size;
     eh_size_t mem_use_block_cnt;
     eh_size_t mem_min_ever_free_size_level;
-}_eh_mem_run;
+    eh_size_t mem_free_block_cnt;
+    eh_size_t mem_largest_free;
+    bool      mem_largest_dirty;                /* 最大的空闲块被分配走后置位，查询时再遍历一次，合并出的块更大，不需要遍历 */
+    eh_size_t mem_free_hist[EH_MEM_FREE_HIST_BIN_CNT];
+};
 
-#define first_block                     (_eh_mem_run.first_block)
-#define mem_total_size                  (_eh_mem_run.mem_total_size)
-#define mem_free_size                   (_eh_mem_run.mem_free_size)
-#define mem_use_block_cnt               (_eh_mem_run.mem_use_block_cnt)
-#define mem_min_ever_free_size_level    (_eh_mem_run.mem_min_ever_free_size_level)
+static struct eh_mem_heap_ctl mem_heap_ctl[EH_MEM_HEAP_ARRAY_NUM];
+static bool mem_heap_ready;                     /* eh_mem_init之后注册的堆立即生效 */
+
+static inline unsigned int mem_free_hist_bin(eh_size_t size){
+    unsigned int bin;
+    if((size >> (EH_MEM_FREE_HIST_SHIFT_MIN + 1)) == 0)
+        return 0;
+    bin = (unsigned int)(sizeof(unsigned long) * 8 - 1 - (unsigned int)__builtin_clzl(size)) - EH_MEM_FREE_HIST_SHIFT_MIN;
+    return bin < EH_MEM_FREE_HIST_BIN_CNT ? bin : EH_MEM_FREE_HIST_BIN_CNT - 1;
+}
+
+/* 空闲块加入或移出时增量维护碎片统计 */
+static inline void mem_free_stat_add(struct eh_mem_heap_ctl *ctl, eh_size_t size){
+    ctl->mem_free_block_cnt++;
+    ctl->mem_free_hist[mem_free_hist_bin(size)]++;
+    if(size >= ctl->mem_largest_free){
+        ctl->mem_largest_free = size;
+        ctl->mem_largest_dirty = false;
+    }
+}
 
-static void eh_mem_insert(struct eh_mem_block *new_free_block){
+static inline void mem_free_stat_del(struct eh_mem_heap_ctl *ctl, eh_size_t size){
+    ctl->mem_free_block_cnt--;
+    ctl->mem_free_hist[mem_free_hist_bin(size)]--;
+    if(size == ctl->mem_largest_free)
+        ctl->mem_largest_dirty = true;
+}
+
+static inline struct eh_mem_heap_ctl *eh_mem_heap_find(const void *ptr){
+    for(eh_size_t i = 0; i < mem_heap_array_cnt; i++){
+        if((const uint8_t*)ptr >= mem_heap_ctl[i].start && (const uint8_t*)ptr < mem_heap_ctl[i].end)
+            return &mem_heap_ctl[i];
+    }
+    return NULL;
+}
+
+static void eh_mem_insert(struct eh_mem_heap_ctl *ctl, struct eh_mem_block *new_free_block){
     struct eh_mem_block *prev_block;
     struct eh_mem_block *pos_block;
     
     /* 循环寻找插入点 */
-    for( prev_block = &first_block, pos_block = first_block.next; 
+    for( prev_block = &ctl->first_block, pos_block = ctl->first_block.next; 
          pos_block && pos_block < new_free_block; 
          prev_block = pos_block, pos_block = pos_block->next ){
         
@@ -108,25 +201,32 @@ static void eh_mem_insert(struct eh_mem_block *new_free_block){
     /* 加入链表 */
     prev_block->next = new_free_block;
     new_free_block->next = pos_block;
-    mem_free_size += new_free_block->size;
+    ctl->mem_free_size += new_free_block->size;
+    mem_free_stat_add(ctl, new_free_block->size);
     /* 
      * 尝试合并prev_block和new_free_block
      */
     if((uint8_t*)prev_block + prev_block->size + EH_MEM_BLOCK_HEAD_SIZE == (uint8_t*)new_free_block){
+        mem_free_stat_del(ctl, prev_block->size);
+        mem_free_stat_del(ctl, new_free_block->size);
         prev_block->size += new_free_block->size + EH_MEM_BLOCK_HEAD_SIZE;
+        mem_free_stat_add(ctl, prev_block->size);
         prev_block->next = new_free_block->next;
-        mem_free_size += EH_MEM_BLOCK_HEAD_SIZE;
+        ctl->mem_free_size += EH_MEM_BLOCK_HEAD_SIZE;
         new_free_block = prev_block;
     }
     /*
      * 尝试合并new_free_block和pos_block
      */
     if((uint8_t*)new_free_block + new_free_block->size + EH_MEM_BLOCK_HEAD_SIZE == (uint8_t*)pos_block){
+        mem_free_stat_del(ctl, new_free_block->size);
+        mem_free_stat_del(ctl, pos_block->size);
         new_free_block->size += pos_block->size + EH_MEM_BLOCK_HEAD_SIZE;
+        mem_free_stat_add(ctl, new_free_block->size);
         new_free_block->next = pos_block->next;
-        mem_free_size += EH_MEM_BLOCK_HEAD_SIZE;
+        ctl->mem_free_size += EH_MEM_BLOCK_HEAD_SIZE;
     }
-    mem_use_block_cnt--;
+    ctl->mem_use_block_cnt--;
 }
 
 void eh_free_block_dump(void dump_func(void* start, size_t size)){
@@ -134,40 +234,24 @@ void eh_free_block_dump(void dump_func(void* start, size_t size)){
     struct eh_mem_block *pos_block;
 
     state = eh_enter_critical();
-    for( pos_block = first_block.next; pos_block; pos_block = pos_block->next )
-        dump_func(pos_block, pos_block->size + EH_MEM_BLOCK_HEAD_SIZE);
+    for(eh_size_t i = 0; i < mem_heap_array_cnt; i++){
+        for( pos_block = mem_heap_ctl[i].first_block.next; pos_block; pos_block = pos_block->next )
+            dump_func(pos_block, pos_block->size + EH_MEM_BLOCK_HEAD_SIZE);
+    }
     eh_exit_critical(state);
 }
 
-void* eh_malloc(size_t _size){
-    eh_save_state_t state;
-    eh_size_t size = (eh_size_t)_size;
-    eh_size_t align_size = EH_MEM_ALIGN_UP(size);
-
-    struct eh_mem_block *new_block = NULL;
-    struct eh_mem_block *new_free_block = NULL;
+/**
+ * @brief                   将空闲块new_block从链表中摘下作为已用块，尾部剩余足够大时拆分出新的空闲块
+ * @param  prev_block       new_block在空闲链表中的前一个块
+ */
+static void *eh_mem_take(struct eh_mem_heap_ctl *ctl, struct eh_mem_block *prev_block, 
+    struct eh_mem_block *new_block, eh_size_t align_size){
+    struct eh_mem_block *new_free_block;
     eh_size_t new_free_block_size;
-    void *new_mem = NULL;
-    struct eh_mem_block *prev_block;
-    struct eh_mem_block *pos_block;
-    
-    /* 如果size == 0, 或者向上对齐过的align_size比以前小，那么说明溢出了，要分配的内存太大了 */
-    if(align_size == 0 || align_size < size) 
-        return NULL;
-    state = eh_enter_critical();
-    /* 向上取整 */
-    if(mem_free_size < align_size)
-        goto out;
-    /* 遍历查找合适的块 */
-    for( prev_block = &first_block, pos_block = first_block.next; 
-         pos_block && pos_block->size < align_size; 
-         prev_block = pos_block, pos_block = pos_block->next ){
-    }
-    /* 没有找到，退出 */
-    if(pos_block == NULL)
-        goto out;
-    new_block = pos_block;
-    mem_free_size -= new_block->size;
+
+    ctl->mem_free_size -= new_block->size;
+    mem_free_stat_del(ctl, new_block->size);
     /* 是否具有能够拆分出一个空闲块 */
     new_free_block_size = new_block->size - align_size - EH_MEM_BLOCK_HEAD_SIZE;
 
@@ -181,87 +265,352 @@ void* eh_malloc(size_t _size){
         new_block->size = align_size;
         new_block->next = new_free_block;
         
-        mem_free_size += new_free_block_size;
+        ctl->mem_free_size += new_free_block_size;
+        mem_free_stat_add(ctl, new_free_block_size);
     }
-    if(mem_free_size < mem_min_ever_free_size_level)
-        mem_min_ever_free_size_level = mem_free_size;
-    new_mem = (void*)((uint8_t*)new_block + EH_MEM_BLOCK_HEAD_SIZE);
+    if(ctl->mem_free_size < ctl->mem_min_ever_free_size_level)
+        ctl->mem_min_ever_free_size_level = ctl->mem_free_size;
     prev_block->next = new_block->next;
-    mem_use_block_cnt++;
-out:
+    ctl->mem_use_block_cnt++;
+    return (void*)((uint8_t*)new_block + EH_MEM_BLOCK_HEAD_SIZE);
+}
+
+static void *eh_mem_heap_malloc(struct eh_mem_heap_ctl *ctl, eh_size_t align_size){
+    struct eh_mem_block *prev_block;
+    struct eh_mem_block *pos_block;
+
+    if(ctl->mem_free_size < align_size)
+        return NULL;
+    /* 遍历查找合适的块 */
+    for( prev_block = &ctl->first_block, pos_block = ctl->first_block.next; 
+         pos_block && pos_block->size < align_size; 
+         prev_block = pos_block, pos_block = pos_block->next ){
+    }
+    /* 没有找到，退出 */
+    if(pos_block == NULL)
+        return NULL;
+    return eh_mem_take(ctl, prev_block, pos_block, align_size);
+}
+
+static void *eh_mem_heap_malloc_aligned(struct eh_mem_heap_ctl *ctl, eh_size_t align, eh_size_t align_size){
+    struct eh_mem_block *prev_block;
+    struct eh_mem_block *pos_block;
+    struct eh_mem_block *new_block;
+    uint8_t *user, *end;
+    eh_size_t gap;
+
+    for( prev_block = &ctl->first_block, pos_block = ctl->first_block.next; 
+         pos_block; 
+         prev_block = pos_block, pos_block = pos_block->next ){
+        if(pos_block->size < align_size)
+            continue;
+        /* 对齐后前面留下的空隙要么为0，要么足够放下一个空闲块 */
+        user = (uint8_t*)eh_align_up((uintptr_t)pos_block + EH_MEM_BLOCK_HEAD_SIZE, (uintptr_t)align);
+        gap = (eh_size_t)(user - ((uint8_t*)pos_block + EH_MEM_BLOCK_HEAD_SIZE));
+        while(gap != 0 && gap <= EH_MEM_BLOCK_HEAD_SIZE + EH_MEM_ALIGN_SIZE){
+            user += align;
+            gap += align;
+        }
+        end = (uint8_t*)pos_block + EH_MEM_BLOCK_HEAD_SIZE + pos_block->size;
+        if(user > end || (eh_size_t)(end - user) < align_size)
+            continue;
+        if(gap){
+            /* 前面的空隙留作空闲块，仍在原位置 */
+            new_block = (struct eh_mem_block*)(user - EH_MEM_BLOCK_HEAD_SIZE);
+            new_block->size = pos_block->size - gap;
+            new_block->next = pos_block->next;
+            mem_free_stat_del(ctl, pos_block->size);
+            pos_block->size = gap - EH_MEM_BLOCK_HEAD_SIZE;
+            pos_block->next = new_block;
+            ctl->mem_free_size -= EH_MEM_BLOCK_HEAD_SIZE;
+            mem_free_stat_add(ctl, pos_block->size);
+            mem_free_stat_add(ctl, new_block->size);
+            prev_block = pos_block;
+            pos_block = new_block;
+        }
+        return eh_mem_take(ctl, prev_block, pos_block, align_size);
+    }
+    return NULL;
+}
+
+void* eh_malloc(size_t _size){
+    eh_save_state_t state;
+    eh_size_t size = (eh_size_t)_size;
+    eh_size_t align_size = EH_MEM_ALIGN_UP(size);
+    void *new_mem = NULL;
+    
+    /* 如果size == 0, 或者向上对齐过的align_size比以前小，那么说明溢出了，要分配的内存太大了 */
+    if(align_size == 0 || align_size < size) 
+        return NULL;
+    state = eh_enter_critical();
+    /* 按注册顺序尝试所有非专用堆 */
+    for(eh_size_t i = 0; i < mem_heap_array_cnt && new_mem == NULL; i++){
+        if(mem_heap_ctl[i].flags & EH_MEM_HEAP_FLAGS_EXCLUSIVE)
+            continue;
+        new_mem = eh_mem_heap_malloc(&mem_heap_ctl[i], align_size);
+    }
     eh_exit_critical(state);
     eh_mdebugfl(MEM_ALLOC,"malloc @%#p size:%d", new_mem, align_size);
     return new_mem;
 }
 
+void* eh_malloc_from(int heap_id, size_t _size){
+    eh_save_state_t state;
+    eh_size_t size = (eh_size_t)_size;
+    eh_size_t align_size = EH_MEM_ALIGN_UP(size);
+    struct eh_mem_heap_ctl *ctl;
+    void *new_mem;
+
+    if(heap_id < 0 || (eh_size_t)heap_id >= mem_heap_array_cnt)
+        return NULL;
+    if(align_size == 0 || align_size < size) 
+        return NULL;
+    ctl = &mem_heap_ctl[heap_id];
+    state = eh_enter_critical();
+    new_mem = eh_mem_heap_malloc(ctl, align_size);
+    eh_exit_critical(state);
+    eh_mdebugfl(MEM_ALLOC,"malloc from %d @%#p size:%d", heap_id, new_mem, align_size);
+    if(new_mem == NULL && !(ctl->flags & EH_MEM_HEAP_FLAGS_NO_FALLBACK))
+        return eh_malloc(_size);
+    return new_mem;
+}
+
+void* eh_malloc_aligned(size_t align, size_t _size){
+    eh_save_state_t state;
+    eh_size_t size = (eh_size_t)_size;
+    eh_size_t align_size = EH_MEM_ALIGN_UP(size);
+    void *new_mem = NULL;
 
+    if(align == 0 || (align & (align - 1)))
+        return NULL;
+    if(align <= EH_MEM_ALIGN_SIZE)
+        return eh_malloc(_size);
+    if(align_size == 0 || align_size < size) 
+        return NULL;
+    state = eh_enter_critical();
+    for(eh_size_t i = 0; i < mem_heap_array_cnt && new_mem == NULL; i++){
+        if(mem_heap_ctl[i].flags & EH_MEM_HEAP_FLAGS_EXCLUSIVE)
+            continue;
+        new_mem = eh_mem_heap_malloc_aligned(&mem_heap_ctl[i], (eh_size_t)align, align_size);
+    }
+    eh_exit_critical(state);
+    eh_mdebugfl(MEM_ALLOC,"malloc aligned(%d) @%#p size:%d", align, new_mem, align_size);
+    return new_mem;
+}
+
+void* eh_calloc(size_t nmemb, size_t size){
+    void *new_mem;
+    if(size && nmemb > SIZE_MAX / size)
+        return NULL;
+    new_mem = eh_malloc(nmemb * size);
+    if(new_mem)
+        memset(new_mem, 0, nmemb * size);
+    return new_mem;
+}
 
 void  eh_free(void* ptr){
     eh_save_state_t state;
     struct eh_mem_block *new_free_block = (struct eh_mem_block *)((uint8_t*)ptr - EH_MEM_BLOCK_HEAD_SIZE);
+    struct eh_mem_heap_ctl *ctl;
     if(ptr == NULL) return ;
     eh_mdebugfl(MEM_ALLOC,"free @%#p size:%d", ptr, new_free_block->size);
     state = eh_enter_critical();
-    eh_mem_insert(new_free_block);
+    ctl = mem_heap_array_cnt == 1 ? &mem_heap_ctl[0] : eh_mem_heap_find(ptr);
+    if(ctl)
+        eh_mem_insert(ctl, new_free_block);
     eh_exit_critical(state);
 }
 
+void* eh_realloc(void* ptr, size_t _size){
+    eh_save_state_t state;
+    eh_size_t size = (eh_size_t)_size;
+    eh_size_t align_size = EH_MEM_ALIGN_UP(size);
+    struct eh_mem_block *block, *tail_block;
+    struct eh_mem_block *prev_block;
+    struct eh_mem_block *pos_block;
+    struct eh_mem_heap_ctl *ctl;
+    eh_size_t tail_size;
+    void *new_mem;
+
+    if(size == 0){
+        eh_free(ptr);
+        return NULL;
+    }
+    if(ptr == NULL)
+        return eh_malloc(_size);
+    if(align_size < size)
+        return NULL;
+    block = (struct eh_mem_block *)((uint8_t*)ptr - EH_MEM_BLOCK_HEAD_SIZE);
+    state = eh_enter_critical();
+    ctl = eh_mem_heap_find(ptr);
+    if(ctl == NULL){
+        eh_exit_critical(state);
+        return NULL;
+    }
+    if(align_size > block->size){
+        /* 空闲链表按地址排序，找到block之后的第一个空闲块，看是否紧挨着block */
+        for( prev_block = &ctl->first_block, pos_block = ctl->first_block.next; 
+             pos_block && pos_block < block; 
+             prev_block = pos_block, pos_block = pos_block->next ){
+        }
+        if( pos_block == NULL || 
+            (uint8_t*)block + EH_MEM_BLOCK_HEAD_SIZE + block->size != (uint8_t*)pos_block ||
+            block->size + EH_MEM_BLOCK_HEAD_SIZE + pos_block->size < align_size ){
+            eh_exit_critical(state);
+            goto copy;
+        }
+        /* 原地吞并后面的空闲块，多出的部分再拆回空闲链表 */
+        ctl->mem_free_size -= pos_block->size;
+        mem_free_stat_del(ctl, pos_block->size);
+        prev_block->next = pos_block->next;
+        block->size += EH_MEM_BLOCK_HEAD_SIZE + pos_block->size;
+        tail_size = block->size - align_size - EH_MEM_BLOCK_HEAD_SIZE;
+        if(tail_size > EH_MEM_ALIGN_SIZE && block->size > tail_size){
+            tail_block = (struct eh_mem_block*)((uint8_t*)block + align_size + EH_MEM_BLOCK_HEAD_SIZE);
+            tail_block->size = tail_size;
+            tail_block->next = prev_block->next;
+            prev_block->next = tail_block;
+            block->size = align_size;
+            ctl->mem_free_size += tail_size;
+            mem_free_stat_add(ctl, tail_size);
+        }
+        if(ctl->mem_free_size < ctl->mem_min_ever_free_size_level)
+            ctl->mem_min_ever_free_size_level = ctl->mem_free_size;
+    }else{
+        /* 缩小，尾部足够大时拆出来归还，eh_mem_insert会与后面的空闲块合并 */
+        tail_size = block->size - align_size - EH_MEM_BLOCK_HEAD_SIZE;
+        if(tail_size > EH_MEM_ALIGN_SIZE && block->size > tail_size){
+            tail_block = (struct eh_mem_block*)((uint8_t*)block + align_size + EH_MEM_BLOCK_HEAD_SIZE);
+            tail_block->size = tail_size;
+            block->size = align_size;
+            ctl->mem_use_block_cnt++;
+            eh_mem_insert(ctl, tail_block);
+        }
+    }
+    eh_exit_critical(state);
+    eh_mdebugfl(MEM_ALLOC,"realloc in place @%#p size:%d", ptr, align_size);
+    return ptr;
+copy:
+    /* 优先留在原来的堆里 */
+    new_mem = eh_malloc_from((int)(ctl - mem_heap_ctl), _size);
+    if(new_mem == NULL)
+        return NULL;
+    memcpy(new_mem, ptr, block->size);
+    eh_free(ptr);
+    return new_mem;
+}
+
+static void eh_mem_heap_setup(struct eh_mem_heap_ctl *ctl, const struct eh_mem_heap *heap){
+    struct eh_mem_block *block;
+    uint8_t *end;
+
+    memset(ctl, 0, sizeof(struct eh_mem_heap_ctl));
+    block = (struct eh_mem_block*)EH_MEM_ALIGN_UP(heap->heap_start);
+    end = (uint8_t*)EH_MEM_ALIGN_DOWN((uint8_t*)heap->heap_start + heap->heap_size);
+    block->next = NULL;
+    block->size = (eh_size_t)(end - (uint8_t*)block) - EH_MEM_BLOCK_HEAD_SIZE;
+    ctl->start = (uint8_t*)block;
+    ctl->end = end;
+    ctl->flags = heap->flags;
+    eh_mem_insert(ctl, block);
+    ctl->mem_use_block_cnt = 0;
+    ctl->mem_total_size = ctl->mem_free_size;
+    ctl->mem_min_ever_free_size_level = ctl->mem_free_size;
+}
 
 int eh_mem_heap_register(const struct eh_mem_heap *heap){
+    eh_save_state_t state;
+    int heap_id;
     eh_param_assert(heap);
     eh_param_assert(heap->heap_start);
     eh_param_assert(heap->heap_size > EH_MEM_BLOCK_HEAD_SIZE);
-    if(mem_heap_array_cnt >= EH_MEM_HEAP_ARRAY_NUM)
+    state = eh_enter_critical();
+    if(mem_heap_array_cnt >= EH_MEM_HEAP_ARRAY_NUM){
+        eh_exit_critical(state);
         return EH_RET_BUSY;
-    mem_heap_array[mem_heap_array_cnt].heap_start = heap->heap_start;
-    mem_heap_array[mem_heap_array_cnt].heap_size = heap->heap_size;
+    }
+    heap_id = (int)mem_heap_array_cnt;
+    mem_heap_array[heap_id] = *heap;
+    if(mem_heap_ready)
+        eh_mem_heap_setup(&mem_heap_ctl[heap_id], heap);
     mem_heap_array_cnt++;
-    return EH_RET_OK;
+    eh_exit_critical(state);
+    return heap_id;
 }
 
+static void eh_mem_heap_info_fill(struct eh_mem_heap_ctl *ctl, struct eh_mem_heap_info *heap_info){
+    struct eh_mem_block *pos_block;
+    if(ctl->mem_largest_dirty){
+        ctl->mem_largest_free = 0;
+        for( pos_block = ctl->first_block.next; pos_block; pos_block = pos_block->next ){
+            if(pos_block->size > ctl->mem_largest_free)
+                ctl->mem_largest_free = pos_block->size;
+        }
+        ctl->mem_largest_dirty = false;
+    }
+    heap_info->free_size += ctl->mem_free_size;
+    heap_info->total_size += ctl->mem_total_size;
+    heap_info->min_ever_free_size_level += ctl->mem_min_ever_free_size_level;
+    if(ctl->mem_largest_free > heap_info->largest_free_block)
+        heap_info->largest_free_block = ctl->mem_largest_free;
+    heap_info->free_block_cnt += ctl->mem_free_block_cnt;
+    for(unsigned int i = 0; i < EH_MEM_FREE_HIST_BIN_CNT; i++)
+        heap_info->free_hist[i] += ctl->mem_free_hist[i];
+}
 
 void eh_mem_get_heap_info(struct eh_mem_heap_info *heap_info){
     eh_save_state_t state;
+    memset(heap_info, 0, sizeof(struct eh_mem_heap_info));
+    state = eh_enter_critical();
+    for(eh_size_t i = 0; i < mem_heap_array_cnt; i++)
+        eh_mem_heap_info_fill(&mem_heap_ctl[i], heap_info);
+    eh_exit_critical(state);
+}
+
+int eh_mem_get_heap_info_by_id(int heap_id, struct eh_mem_heap_info *heap_info){
+    eh_save_state_t state;
+    eh_param_assert(heap_info);
+    eh_param_assert(heap_id >= 0 && (eh_size_t)heap_id < mem_heap_array_cnt);
+    memset(heap_info, 0, sizeof(struct eh_mem_heap_info));
     state = eh_enter_critical();
-    heap_info->free_size = mem_free_size;
-    heap_info->total_size = mem_total_size;
-    heap_info->min_ever_free_size_level = mem_min_ever_free_size_level;
+    eh_mem_heap_info_fill(&mem_heap_ctl[heap_id], heap_info);
     eh_exit_critical(state);
+    return EH_RET_OK;
+}
+
+static void eh_mem_heap_info_print(const char *title){
+    struct eh_mem_heap_info info;
+    eh_size_t use_block_cnt = 0;
+    eh_mem_get_heap_info(&info);
+    for(eh_size_t i = 0; i < mem_heap_array_cnt; i++)
+        use_block_cnt += mem_heap_ctl[i].mem_use_block_cnt;
+    eh_infoln("%s", title);
+    eh_infoln("%11s\t%11s\t%11s\t%11s","total", "used" ,"free" ,"mefsl");
+    eh_infoln("%11lu\t%11lu(%d)\t%11lu\t%11lu", info.total_size, info.total_size - info.free_size, 
+        (int)use_block_cnt, info.free_size, info.min_ever_free_size_level);
+    if(mem_heap_array_cnt > 1){
+        for(eh_size_t i = 0; i < mem_heap_array_cnt; i++){
+            eh_infoln("    heap %lu: total %lu free %lu flags %#x", i, mem_heap_ctl[i].mem_total_size, 
+                mem_heap_ctl[i].mem_free_size, mem_heap_ctl[i].flags);
+        }
+    }
 }
 
 static int __init eh_mem_init(void){
-    struct eh_mem_block *block = NULL;
-    uint8_t *end;
-    first_block.next = NULL;
-    first_block.size = 0;
-    mem_total_size = 0;
-    mem_free_size = 0;
-    mem_min_ever_free_size_level = 0;
     eh_param_assert(mem_heap_array_cnt);
-    for(eh_size_t i=0;i < mem_heap_array_cnt;i++){
-        block = (struct eh_mem_block*)EH_MEM_ALIGN_UP(mem_heap_array[i].heap_start);
-        end = (uint8_t*)EH_MEM_ALIGN_DOWN((uint8_t*)mem_heap_array[i].heap_start + mem_heap_array[i].heap_size);
-        block->next = NULL;
-        block->size = (eh_size_t)(end - (uint8_t*)block) - EH_MEM_BLOCK_HEAD_SIZE;
-        eh_mem_insert(block);
-    }
-    mem_use_block_cnt = 0;
-    mem_total_size = mem_free_size;
-    mem_min_ever_free_size_level = mem_free_size;
-    eh_infoln("Initializes the heap information:");
-    eh_infoln("%11s\t%11s\t%11s\t%11s","total", "used" ,"free" ,"mefsl");
-    eh_infoln("%11lu\t%11lu(%d)\t%11lu\t%11lu", mem_total_size, mem_total_size - mem_free_size, mem_use_block_cnt, mem_free_size, mem_min_ever_free_size_level);
+    for(eh_size_t i=0;i < mem_heap_array_cnt;i++)
+        eh_mem_heap_setup(&mem_heap_ctl[i], &mem_heap_array[i]);
+    mem_heap_ready = true;
+    eh_mem_heap_info_print("Initializes the heap information:");
     return 0;
 }
 
 static void __exit eh_mem_exit(void){
-    eh_infoln("Exits the heap information:");
-    eh_infoln("%11s\t%11s\t%11s\t%11s","total", "used" ,"free" ,"mefsl");
-    eh_infoln("%11lu\t%11lu(%d)\t%11lu\t%11lu", mem_total_size, mem_total_size - mem_free_size, mem_use_block_cnt, mem_free_size, mem_min_ever_free_size_level);
-    
+    eh_mem_heap_info_print("Exits the heap information:");
+    mem_heap_ready = false;
 }
 
 eh_memory_module_export(eh_mem_init, eh_mem_exit);
 
 
-#endif
\ No newline at end of file
+#endif
@@ -10,6 +10,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 #include <eh.h>
 #include <eh_types.h>
 #include <eh_platform.h>
@@ -18,6 +19,13 @@
 #include <eh_mem_pool.h>
 #include <eh_debug.h>
 
+#ifndef EH_DBG_MODULE_LEVEL_MEM_POOL
+#define EH_DBG_MODULE_LEVEL_MEM_POOL EH_DBG_INFO
+#endif
+
+#define pool_is_growable(pool)  ((pool)->flags & EH_MEM_POOL_FLAGS_GROWABLE)
+/* 可增长内存池每项前面放一个所属块的指针，保持内存块的对齐 */
+#define pool_slot_head_size(pool)   eh_align_up(sizeof(struct eh_mem_pool*), (pool)->align)
 
 eh_mem_pool_t eh_mem_pool_create(size_t align, size_t size, size_t num){
     size_t allocation_size = sizeof(struct eh_mem_pool) + 
@@ -31,6 +39,13 @@ eh_mem_pool_t eh_mem_pool_create(size_t align, size_t size, size_t num){
     pool->base = (void*)eh_align_up((uintptr_t)(pool->free_list + num), align);
     pool->align_size = eh_align_up(size, align);
     pool->num = num;
+    pool->used = 0;
+    pool->flags = 0;
+    pool->align = align;
+    pool->chunk_cnt = 1;
+    pool->spare_chunk = NULL;
+    eh_list_head_init(&pool->chunk_list_head);
+    eh_list_head_init(&pool->chunk_node);
     pool->free_list_head.next = pool->free_list;
     for(i = 0; i < (num - 1); i++){
         pool->free_list[i].next = pool->free_list + i + 1;
@@ -40,10 +55,30 @@ eh_mem_pool_t eh_mem_pool_create(size_t align, size_t size, size_t num){
     return (eh_mem_pool_t)pool;
 }
 
-void  eh_mem_pool_destroy(eh_mem_pool_t _pool){
+eh_mem_pool_t eh_mem_pool_create_growable(size_t align, size_t size, size_t chunk_num, uint32_t flags){
+    struct eh_mem_pool *pool;
+    if(chunk_num == 0)
+        return eh_error_to_ptr(EH_RET_INVALID_PARAM);
+    pool = eh_malloc(sizeof(struct eh_mem_pool));
+    if( pool == NULL )
+        return eh_error_to_ptr(EH_RET_MALLOC_ERROR);
+    pool->base = NULL;
+    pool->align_size = eh_align_up(size, align);
+    pool->num = chunk_num;
+    pool->used = 0;
+    pool->flags = (flags & EH_MEM_POOL_FLAGS_RELEASE_EMPTY_CHUNK) | EH_MEM_POOL_FLAGS_GROWABLE;
+    pool->align = align;
+    pool->chunk_cnt = 0;
+    pool->spare_chunk = NULL;
+    eh_list_head_init(&pool->chunk_list_head);
+    eh_list_head_init(&pool->chunk_node);
+    pool->free_list_head.next = NULL;
+    return (eh_mem_pool_t)pool;
+}
+
+static void pool_fixed_destroy(struct eh_mem_pool *pool){
     int i;
     void *ptr;
-    struct eh_mem_pool *pool = (struct eh_mem_pool *)_pool;
     eh_mem_pool_for_each(i, pool, ptr){
         if(eh_mem_pool_idx_is_used(pool, i)){
             eh_mwarnfl(MEM_POOL, "pool mem is not freed pool=%p idx=%d", pool, i);
@@ -52,67 +87,175 @@ void  eh_mem_pool_destroy(eh_mem_pool_t _pool){
     eh_free(pool);
 }
 
-void* eh_mem_pool_alloc(eh_mem_pool_t _pool){
-    void *new_mem = NULL;
-    eh_save_state_t state;
-    struct eh_mem_pool_list     *new_mem_node;
-    
+void  eh_mem_pool_destroy(eh_mem_pool_t _pool){
     struct eh_mem_pool *pool = (struct eh_mem_pool *)_pool;
+    struct eh_mem_pool *chunk, *n;
+    if(pool_is_growable(pool)){
+        eh_list_for_each_entry_safe(chunk, n, &pool->chunk_list_head, chunk_node){
+            eh_list_del(&chunk->chunk_node);
+            pool_fixed_destroy(chunk);
+        }
+        if(pool->spare_chunk)
+            pool_fixed_destroy(pool->spare_chunk);
+        eh_free(pool);
+        return ;
+    }
+    pool_fixed_destroy(pool);
+}
+
+static void* pool_fixed_alloc(struct eh_mem_pool *pool){
+    void *new_mem;
+    struct eh_mem_pool_list     *new_mem_node;
     size_t index;
-    
-    state = eh_enter_critical();
 
     if(pool->free_list_head.next == NULL)
-        goto quit;
+        return NULL;
 
     index = (size_t)(pool->free_list_head.next - pool->free_list);
     if(index >= pool->num){
         eh_mwarnfl(MEM_POOL, "pool index out of range pool=%p index=%d num=%d", pool, index, pool->num);
-        goto quit;
+        return NULL;
     }
     new_mem_node = pool->free_list_head.next;
     new_mem = (char*)pool->base + index*pool->align_size;
     pool->free_list_head.next = new_mem_node->next;
     /* 如果节点的下一个节点指向自己，那么意味着该节点已经被分配出去 */
     new_mem_node->next = new_mem_node;
+    pool->used++;
     eh_mdebugfl(MEM_POOL, "pool=%p index=%d new_mem=%p new_mem_node=%p", pool, index, new_mem, new_mem_node);
-quit:
-    eh_exit_critical(state);
     return new_mem;
 }
 
-void  eh_mem_pool_free(eh_mem_pool_t _pool, void* ptr){
-    struct eh_mem_pool *pool = (struct eh_mem_pool *)_pool;
+static int pool_fixed_free(struct eh_mem_pool *pool, void* ptr){
     size_t index;
-    eh_save_state_t state;
 
     index = (size_t)((char*)ptr - (char*)pool->base)/pool->align_size;
     if(index >= pool->num){
         eh_mwarnfl(MEM_POOL, "pool index out of range pool=%p index=%d num=%d", pool, index, pool->num);
-        return ;
+        return EH_RET_INVALID_PARAM;
     }
 
-    state = eh_enter_critical();
-    if(!eh_mem_pool_idx_is_used(_pool, index)){
+    if(!eh_mem_pool_idx_is_used(pool, index)){
         /* 释放一个没有被分配的pool mem */
         eh_mwarnfl(MEM_POOL, "Release an unallocated pool. mempool=%p index=%d num=%d", pool, index, pool->num);
-        goto quit;
+        return EH_RET_INVALID_STATE;
     }
 
     pool->free_list[index].next = pool->free_list_head.next;
     pool->free_list_head.next = pool->free_list + index;
-
-quit:
-    eh_exit_critical(state);
-    
+    pool->used--;
     eh_mdebugfl(MEM_POOL, "pool=%p index=%d ptr=%p", pool, index, ptr);
+    return EH_RET_OK;
 }
 
-void eh_mem_pool_dump(eh_mem_pool_t _pool){
+static void* pool_growable_alloc(struct eh_mem_pool *pool){
+    struct eh_mem_pool *chunk = NULL;
+    uint8_t *slot;
+
+    if(!eh_list_empty(&pool->chunk_list_head)){
+        chunk = eh_list_entry(pool->chunk_list_head.next, struct eh_mem_pool, chunk_node);
+        if(chunk->used == chunk->num)
+            chunk = NULL;
+    }
+    if(chunk == NULL && pool->spare_chunk){
+        chunk = pool->spare_chunk;
+        pool->spare_chunk = NULL;
+        eh_list_add(&chunk->chunk_node, &pool->chunk_list_head);
+    }
+    if(chunk == NULL){
+        chunk = (struct eh_mem_pool *)eh_mem_pool_create(pool->align, pool_slot_head_size(pool) + pool->align_size, pool->num);
+        if(eh_ptr_to_error(chunk) < 0)
+            return NULL;
+        eh_list_add(&chunk->chunk_node, &pool->chunk_list_head);
+        pool->chunk_cnt++;
+    }
+    slot = pool_fixed_alloc(chunk);
+    memcpy(slot, &chunk, sizeof(chunk));
+    /* 用满的块移到队尾，保证队头总是有空闲内存块的块 */
+    if(chunk->used == chunk->num)
+        eh_list_move_tail(&chunk->chunk_node, &pool->chunk_list_head);
+    pool->used++;
+    return slot + pool_slot_head_size(pool);
+}
+
+static void pool_growable_free(struct eh_mem_pool *pool, void* ptr){
+    struct eh_mem_pool *chunk;
+    uint8_t *slot = (uint8_t*)ptr - pool_slot_head_size(pool);
+
+    memcpy(&chunk, slot, sizeof(chunk));
+    if(pool_fixed_free(chunk, slot) < 0)
+        return ;
+    pool->used--;
+    if(chunk->used == 0 && (pool->flags & EH_MEM_POOL_FLAGS_RELEASE_EMPTY_CHUNK)){
+        /* 保留一个空块备用，已经有备用块时才释放，避免在块边界上反复申请释放 */
+        eh_list_del(&chunk->chunk_node);
+        if(pool->spare_chunk == NULL){
+            pool->spare_chunk = chunk;
+            return ;
+        }
+        pool->chunk_cnt--;
+        pool_fixed_destroy(chunk);
+        return ;
+    }
+    eh_list_move(&chunk->chunk_node, &pool->chunk_list_head);
+}
+
+void* eh_mem_pool_alloc_no_lock(eh_mem_pool_t _pool){
     struct eh_mem_pool *pool = (struct eh_mem_pool *)_pool;
-    
+    if(pool_is_growable(pool))
+        return pool_growable_alloc(pool);
+    return pool_fixed_alloc(pool);
+}
+
+void  eh_mem_pool_free_no_lock(eh_mem_pool_t _pool, void* ptr){
+    struct eh_mem_pool *pool = (struct eh_mem_pool *)_pool;
+    if(pool_is_growable(pool)){
+        pool_growable_free(pool, ptr);
+        return ;
+    }
+    pool_fixed_free(pool, ptr);
+}
+
+void* eh_mem_pool_alloc(eh_mem_pool_t pool){
+    void *new_mem;
+    eh_save_state_t state;
+    state = eh_enter_critical();
+    new_mem = eh_mem_pool_alloc_no_lock(pool);
+    eh_exit_critical(state);
+    return new_mem;
+}
+
+void  eh_mem_pool_free(eh_mem_pool_t pool, void* ptr){
+    eh_save_state_t state;
+    state = eh_enter_critical();
+    eh_mem_pool_free_no_lock(pool, ptr);
+    eh_exit_critical(state);
+}
+
+size_t eh_mem_pool_alloc_bulk(eh_mem_pool_t pool, void **ptrs, size_t n){
+    eh_save_state_t state;
+    size_t i;
+    state = eh_enter_critical();
+    for(i = 0; i < n; i++){
+        ptrs[i] = eh_mem_pool_alloc_no_lock(pool);
+        if(ptrs[i] == NULL)
+            break;
+    }
+    eh_exit_critical(state);
+    return i;
+}
+
+void  eh_mem_pool_free_bulk(eh_mem_pool_t pool, void * const *ptrs, size_t n){
+    eh_save_state_t state;
+    state = eh_enter_critical();
+    for(size_t i = 0; i < n; i++)
+        eh_mem_pool_free_no_lock(pool, ptrs[i]);
+    eh_exit_critical(state);
+}
+
+static void pool_fixed_dump(struct eh_mem_pool *pool){
     struct eh_mem_pool_list  *new_mem_node = pool->free_list_head.next;
-    eh_minfoln(MEM_POOL, "pool=%0#p base=%0#p align_size=%d num=%d\n", pool, pool->base, pool->align_size, pool->num);
+    eh_minfoln(MEM_POOL, "pool=%0#p base=%0#p align_size=%d num=%d used=%d\n", pool, pool->base, pool->align_size, pool->num, pool->used);
     eh_minforaw(MEM_POOL, "free list:");
     while(new_mem_node != NULL){
         eh_minforaw(MEM_POOL, " %d", new_mem_node - pool->free_list);
@@ -121,10 +264,27 @@ void eh_mem_pool_dump(eh_mem_pool_t _pool){
     eh_minforaw(MEM_POOL, "\n");
 }
 
+void eh_mem_pool_dump(eh_mem_pool_t _pool){
+    struct eh_mem_pool *pool = (struct eh_mem_pool *)_pool;
+    struct eh_mem_pool *chunk;
+    if(pool_is_growable(pool)){
+        eh_minfoln(MEM_POOL, "growable pool=%0#p align_size=%d chunk_num=%d chunk_cnt=%d used=%d\n",
+            pool, pool->align_size, pool->num, pool->chunk_cnt, pool->used);
+        eh_list_for_each_entry(chunk, &pool->chunk_list_head, chunk_node)
+            pool_fixed_dump(chunk);
+        if(pool->spare_chunk)
+            pool_fixed_dump(pool->spare_chunk);
+        return ;
+    }
+    pool_fixed_dump(pool);
+}
+
 
 int eh_mem_pool_ptr_to_idx(eh_mem_pool_t _pool, void* ptr){
     struct eh_mem_pool *pool = (struct eh_mem_pool *)_pool;
     size_t offset;
+    if(pool_is_growable(pool))
+        return -1;
     if((char*)ptr < (char*)pool->base || (char*)ptr >= (char*)pool->base + pool->num*pool->align_size)
         return -1;
     offset = (size_t)((char*)ptr - (char*)pool->base);
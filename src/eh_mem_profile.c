@@ -0,0 +1,319 @@
+/**
+ * @file eh_mem_profile.c
+ * @brief 内存分配分析，EH_CONFIG_MEM_PROFILE为1时包装内存管理后端，
+ *        每次分配在用户内存前放一个记录头，记录所属调用点和大小，并挂入在用链表，
+ *        调用点以 eh_malloc 的返回地址区分，使用 addr2line 等工具即可还原到源码行
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <eh.h>
+#include <eh_debug.h>
+#include <eh_list.h>
+#include <eh_mem.h>
+#include <eh_module.h>
+#include <eh_platform.h>
+#include <eh_config.h>
+
+#if EH_CONFIG_MEM_PROFILE
+
+#define MEM_PROFILE_SITE_MASK       ((uintptr_t)EH_CONFIG_MEM_PROFILE_SITE_MAX - 1)
+#define MEM_PROFILE_EXIT_TOP_N      16
+#define MEM_PROFILE_EXIT_LIVE_N     32
+
+#if (defined(EH_CONFIG_USE_LIBC_MEM_MANAGE)) && (EH_CONFIG_USE_LIBC_MEM_MANAGE == 1)
+#define MEM_PROFILE_ALIGN           _Alignof(max_align_t)
+#else
+#define MEM_PROFILE_ALIGN           ((uintptr_t)EH_CONFIG_MEM_ALLOC_ALIGN)
+#endif
+
+eh_static_assert((EH_CONFIG_MEM_PROFILE_SITE_MAX & (EH_CONFIG_MEM_PROFILE_SITE_MAX - 1)) == 0,
+    "EH_CONFIG_MEM_PROFILE_SITE_MAX must be a power of 2");
+
+struct mem_profile_hdr{
+    struct eh_list_head         live_node;
+    struct eh_mem_profile_site  *site;                  /* 在eh_global_exit时被清空，此后释放不再统计 */
+    size_t                      size;
+    void                        *raw;                   /* 后端分配到的地址，对齐分配时位于记录头之前 */
+};
+
+#define MEM_PROFILE_HDR_SIZE        eh_align_up(sizeof(struct mem_profile_hdr), MEM_PROFILE_ALIGN)
+
+struct mem_profile_live{
+    void                        *ptr;
+    size_t                      size;
+    void                        *caller;
+};
+
+/* 最后一项为溢出项，调用点表满后新的调用点都记在这里 */
+static struct eh_mem_profile_site mem_profile_site_table[EH_CONFIG_MEM_PROFILE_SITE_MAX + 1];
+static EH_LIST_HEAD(mem_profile_live_list_head);
+
+static struct eh_mem_profile_site *mem_profile_site_get(void *caller){
+    uintptr_t idx = (((uintptr_t)caller >> 2) * 2654435761U) & MEM_PROFILE_SITE_MASK;
+    struct eh_mem_profile_site *site;
+    for(uintptr_t i = 0; i < EH_CONFIG_MEM_PROFILE_SITE_MAX; i++){
+        site = &mem_profile_site_table[(idx + i) & MEM_PROFILE_SITE_MASK];
+        if(site->caller == caller)
+            return site;
+        if(site->caller == NULL){
+            site->caller = caller;
+            return site;
+        }
+    }
+    return &mem_profile_site_table[EH_CONFIG_MEM_PROFILE_SITE_MAX];
+}
+
+/* heap_id < 0 时不指定堆 */
+static void *mem_profile_alloc(void *caller, int heap_id, size_t align, size_t size){
+    struct eh_mem_profile_site *site;
+    struct mem_profile_hdr *hdr;
+    eh_save_state_t state;
+    size_t pad = align > MEM_PROFILE_ALIGN ? eh_align_up(MEM_PROFILE_HDR_SIZE, align) : MEM_PROFILE_HDR_SIZE;
+    void *raw;
+
+    state = eh_enter_critical();
+    site = mem_profile_site_get(caller);
+    if(pad + size < size)
+        raw = NULL;
+    else if(heap_id >= 0)
+        raw = eh_mem_raw_malloc_from(heap_id, pad + size);
+    else if(align > MEM_PROFILE_ALIGN)
+        raw = eh_mem_raw_malloc_aligned(align, pad + size);
+    else
+        raw = eh_mem_raw_malloc(pad + size);
+    if(raw == NULL){
+        site->fail_cnt++;
+        eh_exit_critical(state);
+        return NULL;
+    }
+    hdr = (struct mem_profile_hdr *)((uint8_t*)raw + pad - MEM_PROFILE_HDR_SIZE);
+    hdr->site = site;
+    hdr->size = size;
+    hdr->raw = raw;
+    eh_list_add_tail(&hdr->live_node, &mem_profile_live_list_head);
+    site->alloc_cnt++;
+    site->live_cnt++;
+    site->live_size += size;
+    site->total_size += size;
+    if(site->live_size > site->peak_live_size)
+        site->peak_live_size = site->live_size;
+    eh_exit_critical(state);
+    return (uint8_t*)hdr + MEM_PROFILE_HDR_SIZE;
+}
+
+void* eh_malloc(size_t size){
+    return mem_profile_alloc(__builtin_return_address(0), -1, 0, size);
+}
+
+void* eh_malloc_from(int heap_id, size_t size){
+    if(heap_id < 0)
+        return NULL;
+    return mem_profile_alloc(__builtin_return_address(0), heap_id, 0, size);
+}
+
+void* eh_malloc_aligned(size_t align, size_t size){
+    if(align == 0 || (align & (align - 1)))
+        return NULL;
+    return mem_profile_alloc(__builtin_return_address(0), -1, align, size);
+}
+
+void* eh_calloc(size_t nmemb, size_t size){
+    void *ptr;
+    if(size && nmemb > SIZE_MAX / size)
+        return NULL;
+    ptr = mem_profile_alloc(__builtin_return_address(0), -1, 0, nmemb * size);
+    if(ptr)
+        memset(ptr, 0, nmemb * size);
+    return ptr;
+}
+
+void eh_free(void* ptr){
+    struct mem_profile_hdr *hdr;
+    eh_save_state_t state;
+
+    if(ptr == NULL)
+        return ;
+    hdr = (struct mem_profile_hdr *)((uint8_t*)ptr - MEM_PROFILE_HDR_SIZE);
+    state = eh_enter_critical();
+    eh_list_del(&hdr->live_node);
+    if(hdr->site){
+        hdr->site->live_cnt--;
+        hdr->site->live_size -= hdr->size;
+    }
+    eh_mem_raw_free(hdr->raw);
+    eh_exit_critical(state);
+}
+
+/* realloc记为旧调用点的一次释放加上realloc调用点的一次分配 */
+void* eh_realloc(void* ptr, size_t size){
+    void *caller = __builtin_return_address(0);
+    struct eh_mem_profile_site *site;
+    struct mem_profile_hdr *hdr, *new_hdr;
+    eh_save_state_t state;
+    void *new_ptr;
+
+    if(size == 0){
+        eh_free(ptr);
+        return NULL;
+    }
+    if(ptr == NULL)
+        return mem_profile_alloc(caller, -1, 0, size);
+    hdr = (struct mem_profile_hdr *)((uint8_t*)ptr - MEM_PROFILE_HDR_SIZE);
+    if(hdr->raw != hdr){
+        /* 对齐分配的记录头不在块首，不能交给后端realloc */
+        new_ptr = mem_profile_alloc(caller, -1, 0, size);
+        if(new_ptr == NULL)
+            return NULL;
+        memcpy(new_ptr, ptr, hdr->size < size ? hdr->size : size);
+        eh_free(ptr);
+        return new_ptr;
+    }
+    if(MEM_PROFILE_HDR_SIZE + size < size)
+        return NULL;
+    state = eh_enter_critical();
+    site = mem_profile_site_get(caller);
+    /* 块可能被搬走，先从在用链表摘下 */
+    eh_list_del(&hdr->live_node);
+    new_hdr = eh_mem_raw_realloc(hdr, MEM_PROFILE_HDR_SIZE + size);
+    if(new_hdr == NULL){
+        eh_list_add_tail(&hdr->live_node, &mem_profile_live_list_head);
+        site->fail_cnt++;
+        eh_exit_critical(state);
+        return NULL;
+    }
+    if(new_hdr->site){
+        new_hdr->site->live_cnt--;
+        new_hdr->site->live_size -= new_hdr->size;
+    }
+    new_hdr->site = site;
+    new_hdr->size = size;
+    new_hdr->raw = new_hdr;
+    eh_list_add_tail(&new_hdr->live_node, &mem_profile_live_list_head);
+    site->alloc_cnt++;
+    site->live_cnt++;
+    site->live_size += size;
+    site->total_size += size;
+    if(site->live_size > site->peak_live_size)
+        site->peak_live_size = site->live_size;
+    eh_exit_critical(state);
+    return (uint8_t*)new_hdr + MEM_PROFILE_HDR_SIZE;
+}
+
+void eh_mem_profile_for_each_site(void site_func(const struct eh_mem_profile_site *site)){
+    struct eh_mem_profile_site site;
+    eh_save_state_t state;
+    for(size_t i = 0; i <= EH_CONFIG_MEM_PROFILE_SITE_MAX; i++){
+        /* 拷贝出来再回调，回调中允许打印 */
+        state = eh_enter_critical();
+        site = mem_profile_site_table[i];
+        eh_exit_critical(state);
+        if(site.alloc_cnt == 0 && site.fail_cnt == 0)
+            continue;
+        site_func(&site);
+    }
+}
+
+void eh_mem_profile_dump(size_t top_n){
+    struct eh_mem_profile_site top[MEM_PROFILE_EXIT_TOP_N];
+    struct eh_mem_profile_site *site;
+    eh_save_state_t state;
+    size_t cnt = 0, i, j;
+
+    if(top_n > MEM_PROFILE_EXIT_TOP_N)
+        top_n = MEM_PROFILE_EXIT_TOP_N;
+    /* 在临界区内插入排序选出前top_n个，打印放在临界区外，打印本身也可能分配内存 */
+    state = eh_enter_critical();
+    for(i = 0; i <= EH_CONFIG_MEM_PROFILE_SITE_MAX; i++){
+        site = &mem_profile_site_table[i];
+        if(site->alloc_cnt == 0 && site->fail_cnt == 0)
+            continue;
+        for(j = cnt; j > 0 && top[j-1].live_size < site->live_size; j--){
+            if(j < top_n)
+                top[j] = top[j-1];
+        }
+        if(j < top_n){
+            top[j] = *site;
+            if(cnt < top_n)
+                cnt++;
+        }
+    }
+    eh_exit_critical(state);
+
+    eh_infoln("memory profile top %lu sites by live size:", (unsigned long)cnt);
+    eh_infoln("%10s\t%10s\t%10s\t%10s\t%10s\t%6s\tcaller", "live_size", "live_cnt", "peak_size", "alloc_cnt", "total_size", "fail");
+    for(i = 0; i < cnt; i++){
+        eh_infoln("%10lu\t%10lu\t%10lu\t%10lu\t%10lu\t%6lu\t%p",
+            (unsigned long)top[i].live_size, (unsigned long)top[i].live_cnt,
+            (unsigned long)top[i].peak_live_size, (unsigned long)top[i].alloc_cnt,
+            (unsigned long)top[i].total_size, (unsigned long)top[i].fail_cnt, top[i].caller);
+    }
+}
+
+void eh_mem_profile_dump_live(size_t max_cnt){
+    struct mem_profile_live live[MEM_PROFILE_EXIT_LIVE_N];
+    struct mem_profile_hdr *hdr;
+    eh_save_state_t state;
+    size_t cnt = 0, total = 0;
+
+    if(max_cnt > MEM_PROFILE_EXIT_LIVE_N)
+        max_cnt = MEM_PROFILE_EXIT_LIVE_N;
+    state = eh_enter_critical();
+    eh_list_for_each_entry(hdr, &mem_profile_live_list_head, live_node){
+        if(cnt < max_cnt){
+            live[cnt].ptr = (uint8_t*)hdr + MEM_PROFILE_HDR_SIZE;
+            live[cnt].size = hdr->size;
+            live[cnt].caller = hdr->site ? hdr->site->caller : NULL;
+            cnt++;
+        }
+        total++;
+    }
+    eh_exit_critical(state);
+
+    eh_infoln("memory profile live allocations: %lu", (unsigned long)total);
+    for(size_t i = 0; i < cnt; i++)
+        eh_infoln("    %p size %lu caller %p", live[i].ptr, (unsigned long)live[i].size, live[i].caller);
+    if(total > cnt)
+        eh_infoln("    ... %lu more", (unsigned long)(total - cnt));
+}
+
+static void __exit eh_mem_profile_exit(void){
+    struct mem_profile_hdr *hdr, *n;
+    eh_save_state_t state;
+
+    eh_mem_profile_dump(MEM_PROFILE_EXIT_TOP_N);
+    eh_mem_profile_dump_live(MEM_PROFILE_EXIT_LIVE_N);
+
+    /* 堆可能随下一次初始化被重置，断开所有未释放的分配，下一轮重新统计 */
+    state = eh_enter_critical();
+    eh_list_for_each_entry_safe(hdr, n, &mem_profile_live_list_head, live_node){
+        eh_list_del_init(&hdr->live_node);
+        hdr->site = NULL;
+    }
+    memset(mem_profile_site_table, 0, sizeof(mem_profile_site_table));
+    eh_exit_critical(state);
+}
+
+eh_mem_profile_module_export(NULL, eh_mem_profile_exit);
+
+#else
+
+void eh_mem_profile_for_each_site(void site_func(const struct eh_mem_profile_site *site)){
+    (void)site_func;
+}
+
+void eh_mem_profile_dump(size_t top_n){
+    (void)top_n;
+}
+
+void eh_mem_profile_dump_live(size_t max_cnt){
+    (void)max_cnt;
+}
+
+#endif
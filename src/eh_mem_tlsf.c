@@ -0,0 +1,689 @@
+/**
+ * @file eh_mem_tlsf.c
+ * @brief TLSF(Two-Level Segregated Fit)内存分配器，分配和释放均为O(1)，释放时立即与相邻空闲块合并，
+ *        空闲块按大小分入两级区间，一级为2的幂次区间，二级将每个一级区间线性等分，
+ *        两级位图配合 ffs/fls 可以在常数时间内找到满足大小的空闲链表
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <eh.h>
+#include <eh_debug.h>
+#include <eh_error.h>
+#include <eh_mem.h>
+#include <eh_types.h>
+#include <eh_config.h>
+#include <eh_platform.h>
+
+#if EH_CONFIG_MEM_PROFILE
+/* 分析模式下由 eh_mem_profile.c 提供 eh_malloc/eh_free 并调用这里的实现 */
+#define eh_malloc                   eh_mem_raw_malloc
+#define eh_free                     eh_mem_raw_free
+#define eh_calloc                   eh_mem_raw_calloc
+#define eh_realloc                  eh_mem_raw_realloc
+#define eh_malloc_aligned           eh_mem_raw_malloc_aligned
+#define eh_malloc_from              eh_mem_raw_malloc_from
+#endif
+
+#if ((!defined(EH_CONFIG_USE_LIBC_MEM_MANAGE)) || (EH_CONFIG_USE_LIBC_MEM_MANAGE == 0)) && \
+    (EH_CONFIG_MEM_USE_TLSF == 1)
+
+typedef unsigned long eh_size_t;
+
+#ifndef EH_DBG_MODULE_LEVEL_MEM_ALLOC
+#define EH_DBG_MODULE_LEVEL_MEM_ALLOC EH_DBG_INFO
+#endif
+
+/*
+ * 块头，prev_phys 始终指向物理上的前一个块，size的低两位用作标志，
+ * 空闲时 next_free/prev_free 占用负载区的前两个指针
+ */
+struct eh_mem_block {
+    struct eh_mem_block*    prev_phys;
+    eh_size_t               size;
+    struct eh_mem_block*    next_free;
+    struct eh_mem_block*    prev_free;
+};
+
+#define EH_MEM_ALIGN_SIZE           ((eh_size_t)(EH_CONFIG_MEM_ALLOC_ALIGN))
+#define EH_MEM_ALIGN_MASK           ((EH_MEM_ALIGN_SIZE) - 1)
+#define EH_MEM_ALIGN_DOWN(addr)     (((eh_size_t)(addr)) & (~EH_MEM_ALIGN_MASK))
+#define EH_MEM_ALIGN_UP(addr)       ((((eh_size_t)(addr)) + EH_MEM_ALIGN_MASK) & (~EH_MEM_ALIGN_MASK))
+#define EH_MEM_BLOCK_HEAD_SIZE      EH_MEM_ALIGN_UP(offsetof(struct eh_mem_block, next_free))
+#define EH_MEM_BLOCK_MIN_SIZE       EH_MEM_ALIGN_UP(sizeof(struct eh_mem_block) - offsetof(struct eh_mem_block, next_free))
+#define EH_MEM_HEAP_ARRAY_NUM       (8U)
+
+#define EH_MEM_BLOCK_FREE           ((eh_size_t)1)
+#define EH_MEM_BLOCK_PREV_FREE      ((eh_size_t)2)
+#define EH_MEM_BLOCK_FLAGS_MASK     (EH_MEM_BLOCK_FREE | EH_MEM_BLOCK_PREV_FREE)
+
+#define EH_MEM_ALIGN_LOG2           (   EH_MEM_ALIGN_SIZE == 4  ? 2 :   \
+                                        EH_MEM_ALIGN_SIZE == 8  ? 3 :   \
+                                        EH_MEM_ALIGN_SIZE == 16 ? 4 :   \
+                                        EH_MEM_ALIGN_SIZE == 32 ? 5 : 6 )
+#define TLSF_SL_INDEX_COUNT_LOG2    (EH_CONFIG_MEM_TLSF_SL_INDEX_COUNT_LOG2)
+#define TLSF_SL_INDEX_COUNT         (1 << TLSF_SL_INDEX_COUNT_LOG2)
+#define TLSF_FL_INDEX_MAX           (EH_CONFIG_MEM_TLSF_FL_INDEX_MAX)
+#define TLSF_FL_INDEX_SHIFT         (TLSF_SL_INDEX_COUNT_LOG2 + EH_MEM_ALIGN_LOG2)
+#define TLSF_FL_INDEX_COUNT         (TLSF_FL_INDEX_MAX - TLSF_FL_INDEX_SHIFT + 1)
+#define TLSF_SMALL_BLOCK_SIZE       ((eh_size_t)1 << TLSF_FL_INDEX_SHIFT)
+#define TLSF_BLOCK_SIZE_MAX         (((eh_size_t)1 << TLSF_FL_INDEX_MAX) - EH_MEM_ALIGN_SIZE)
+
+eh_static_assert((EH_MEM_ALIGN_SIZE & EH_MEM_ALIGN_MASK) == 0 && EH_MEM_ALIGN_SIZE >= 4 && EH_MEM_ALIGN_SIZE <= 64,
+    "EH_CONFIG_MEM_ALLOC_ALIGN must be a power of two in [4, 64]");
+eh_static_assert(TLSF_SL_INDEX_COUNT_LOG2 >= 1 && TLSF_SL_INDEX_COUNT_LOG2 <= 5,
+    "EH_CONFIG_MEM_TLSF_SL_INDEX_COUNT_LOG2 must be in [1, 5]");
+eh_static_assert(TLSF_FL_INDEX_COUNT > 0 && TLSF_FL_INDEX_COUNT <= 32 && TLSF_FL_INDEX_MAX < sizeof(eh_size_t) * 8,
+    "EH_CONFIG_MEM_TLSF_FL_INDEX_MAX out of range");
+
+#if defined(EH_CONFIG_MEM_HEAP_SIZE) && (EH_CONFIG_MEM_HEAP_SIZE > 0)
+static uint8_t eh_aligned(EH_MEM_ALIGN_SIZE) mem_heap[EH_MEM_ALIGN_DOWN(EH_CONFIG_MEM_HEAP_SIZE)];
+static struct eh_mem_heap mem_heap_array[EH_MEM_HEAP_ARRAY_NUM] = {
+    {
+        .heap_start = mem_heap,
+        .heap_size = sizeof(mem_heap),
+    },
+};
+static eh_size_t mem_heap_array_cnt = 1;
+#else
+static struct eh_mem_heap mem_heap_array[EH_MEM_HEAP_ARRAY_NUM];
+static eh_size_t mem_heap_array_cnt = 0;
+#endif
+
+/*
+ * 每个堆的控制块放在堆空间的开头，多个堆不会占用额外的静态内存
+ */
+struct eh_mem_heap_ctl {
+    uint32_t fl_bitmap;
+    uint32_t sl_bitmap[TLSF_FL_INDEX_COUNT];
+    struct eh_mem_block *blocks[TLSF_FL_INDEX_COUNT][TLSF_SL_INDEX_COUNT];
+    uint8_t   *start;
+    uint8_t   *end;
+    uint32_t  flags;
+    eh_size_t mem_total_size;
+    eh_size_t mem_free_size;
+    eh_size_t mem_use_block_cnt;
+    eh_size_t mem_min_ever_free_size_level;
+    eh_size_t mem_free_block_cnt;
+    eh_size_t mem_free_hist[EH_MEM_FREE_HIST_BIN_CNT];
+};
+
+#define EH_MEM_HEAP_CTL_SIZE        EH_MEM_ALIGN_UP(sizeof(struct eh_mem_heap_ctl))
+#define EH_MEM_HEAP_MIN_SIZE        (EH_MEM_HEAP_CTL_SIZE + EH_MEM_BLOCK_HEAD_SIZE * 2 + EH_MEM_BLOCK_MIN_SIZE + EH_MEM_ALIGN_SIZE)
+
+static struct eh_mem_heap_ctl *mem_heap_ctl[EH_MEM_HEAP_ARRAY_NUM];
+static bool mem_heap_ready;                     /* eh_mem_init之后注册的堆立即生效 */
+
+#if defined(EH_CONFIG_MEM_HEAP_SIZE) && (EH_CONFIG_MEM_HEAP_SIZE > 0)
+eh_static_assert(EH_CONFIG_MEM_HEAP_SIZE >= EH_MEM_HEAP_MIN_SIZE, "Please set EH_CONFIG_MEM_HEAP_SIZE to 0 or greater");
+#endif
+
+static inline int tlsf_fls(eh_size_t x){
+    return (int)(sizeof(unsigned long) * 8) - 1 - __builtin_clzl(x);
+}
+
+static inline int tlsf_ffs(uint32_t x){
+    return __builtin_ctz(x);
+}
+
+static inline eh_size_t block_size(const struct eh_mem_block *block){
+    return block->size & ~EH_MEM_BLOCK_FLAGS_MASK;
+}
+
+static inline void *block_to_ptr(const struct eh_mem_block *block){
+    return (void*)((uint8_t*)block + EH_MEM_BLOCK_HEAD_SIZE);
+}
+
+static inline struct eh_mem_block *block_from_ptr(const void *ptr){
+    return (struct eh_mem_block *)((uint8_t*)ptr - EH_MEM_BLOCK_HEAD_SIZE);
+}
+
+static inline struct eh_mem_block *block_next(const struct eh_mem_block *block){
+    return (struct eh_mem_block *)((uint8_t*)block + EH_MEM_BLOCK_HEAD_SIZE + block_size(block));
+}
+
+static inline void mapping_insert(eh_size_t size, int *fl, int *sl){
+    if(size < TLSF_SMALL_BLOCK_SIZE){
+        *fl = 0;
+        *sl = (int)(size >> EH_MEM_ALIGN_LOG2);
+    }else{
+        *fl = tlsf_fls(size);
+        *sl = (int)(size >> (*fl - TLSF_SL_INDEX_COUNT_LOG2)) ^ TLSF_SL_INDEX_COUNT;
+        *fl -= TLSF_FL_INDEX_SHIFT - 1;
+    }
+}
+
+/* 向上取整到下一个二级区间的起点，这样该区间内的任何块都能满足要求，无需遍历链表 */
+static inline void mapping_search(eh_size_t size, int *fl, int *sl){
+    if(size >= TLSF_SMALL_BLOCK_SIZE)
+        size += ((eh_size_t)1 << (tlsf_fls(size) - TLSF_SL_INDEX_COUNT_LOG2)) - 1;
+    mapping_insert(size, fl, sl);
+}
+
+static inline unsigned int mem_free_hist_bin(eh_size_t size){
+    unsigned int bin;
+    if((size >> (EH_MEM_FREE_HIST_SHIFT_MIN + 1)) == 0)
+        return 0;
+    bin = (unsigned int)tlsf_fls(size) - EH_MEM_FREE_HIST_SHIFT_MIN;
+    return bin < EH_MEM_FREE_HIST_BIN_CNT ? bin : EH_MEM_FREE_HIST_BIN_CNT - 1;
+}
+
+/* 所有空闲块都经过 block_insert_free/block_remove_free，碎片统计在这两处增量维护 */
+static void block_remove_free(struct eh_mem_heap_ctl *ctl, struct eh_mem_block *block, int fl, int sl){
+    struct eh_mem_block *prev = block->prev_free;
+    struct eh_mem_block *next = block->next_free;
+    ctl->mem_free_block_cnt--;
+    ctl->mem_free_hist[mem_free_hist_bin(block_size(block))]--;
+    if(next)
+        next->prev_free = prev;
+    if(prev){
+        prev->next_free = next;
+        return ;
+    }
+    ctl->blocks[fl][sl] = next;
+    if(next == NULL){
+        ctl->sl_bitmap[fl] &= ~(1U << sl);
+        if(ctl->sl_bitmap[fl] == 0)
+            ctl->fl_bitmap &= ~(1U << fl);
+    }
+}
+
+static void block_insert_free(struct eh_mem_heap_ctl *ctl, struct eh_mem_block *block){
+    int fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+    block->prev_free = NULL;
+    block->next_free = ctl->blocks[fl][sl];
+    if(block->next_free)
+        block->next_free->prev_free = block;
+    ctl->blocks[fl][sl] = block;
+    ctl->fl_bitmap |= 1U << fl;
+    ctl->sl_bitmap[fl] |= 1U << sl;
+    ctl->mem_free_block_cnt++;
+    ctl->mem_free_hist[mem_free_hist_bin(block_size(block))]++;
+}
+
+static inline void block_unlink(struct eh_mem_heap_ctl *ctl, struct eh_mem_block *block){
+    int fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+    block_remove_free(ctl, block, fl, sl);
+}
+
+static struct eh_mem_block *block_search_suitable(struct eh_mem_heap_ctl *ctl, int *fl, int *sl){
+    uint32_t sl_map = ctl->sl_bitmap[*fl] & (~0U << *sl);
+    uint32_t fl_map;
+    if(sl_map == 0){
+        fl_map = *fl + 1 < TLSF_FL_INDEX_COUNT ? ctl->fl_bitmap & (~0U << (*fl + 1)) : 0;
+        if(fl_map == 0)
+            return NULL;
+        *fl = tlsf_ffs(fl_map);
+        sl_map = ctl->sl_bitmap[*fl];
+    }
+    *sl = tlsf_ffs(sl_map);
+    return ctl->blocks[*fl][*sl];
+}
+
+/**
+ * @brief                   已用块尾部超出size的部分足够放下一个最小块时拆出来，并与后面的空闲块合并
+ */
+static void block_trim_used(struct eh_mem_heap_ctl *ctl, struct eh_mem_block *block, eh_size_t size){
+    struct eh_mem_block *remain, *next;
+    eh_size_t remain_size = block_size(block) - size;
+
+    if(remain_size < EH_MEM_BLOCK_HEAD_SIZE + EH_MEM_BLOCK_MIN_SIZE)
+        return ;
+    next = block_next(block);
+    remain = (struct eh_mem_block *)((uint8_t*)block + EH_MEM_BLOCK_HEAD_SIZE + size);
+    remain->size = (remain_size - EH_MEM_BLOCK_HEAD_SIZE) | EH_MEM_BLOCK_FREE;
+    remain->prev_phys = block;
+    block->size = size | (block->size & EH_MEM_BLOCK_PREV_FREE);
+    ctl->mem_free_size += block_size(remain);
+    if(next->size & EH_MEM_BLOCK_FREE){
+        block_unlink(ctl, next);
+        remain->size += EH_MEM_BLOCK_HEAD_SIZE + block_size(next);
+        ctl->mem_free_size += EH_MEM_BLOCK_HEAD_SIZE;
+        next = block_next(remain);
+    }
+    next->prev_phys = remain;
+    next->size |= EH_MEM_BLOCK_PREV_FREE;
+    block_insert_free(ctl, remain);
+}
+
+/**
+ * @brief                   取出一个不小于size的空闲块并标记为已用，不拆分
+ */
+static struct eh_mem_block *block_take_free(struct eh_mem_heap_ctl *ctl, eh_size_t size){
+    struct eh_mem_block *block;
+    int fl, sl;
+
+    mapping_search(size, &fl, &sl);
+    if(fl >= TLSF_FL_INDEX_COUNT)
+        return NULL;
+    block = block_search_suitable(ctl, &fl, &sl);
+    if(block == NULL)
+        return NULL;
+    block_remove_free(ctl, block, fl, sl);
+    ctl->mem_free_size -= block_size(block);
+    block->size &= ~EH_MEM_BLOCK_FREE;
+    block_next(block)->size &= ~EH_MEM_BLOCK_PREV_FREE;
+    return block;
+}
+
+static inline void block_use_done(struct eh_mem_heap_ctl *ctl){
+    if(ctl->mem_free_size < ctl->mem_min_ever_free_size_level)
+        ctl->mem_min_ever_free_size_level = ctl->mem_free_size;
+    ctl->mem_use_block_cnt++;
+}
+
+void eh_free_block_dump(void dump_func(void* start, size_t size)){
+    eh_save_state_t state;
+    struct eh_mem_heap_ctl *ctl;
+    struct eh_mem_block *pos_block;
+
+    state = eh_enter_critical();
+    for(eh_size_t i = 0; i < mem_heap_array_cnt; i++){
+        ctl = mem_heap_ctl[i];
+        if(ctl == NULL)
+            continue;
+        for(int fl = 0; fl < TLSF_FL_INDEX_COUNT; fl++){
+            for(int sl = 0; sl < TLSF_SL_INDEX_COUNT; sl++){
+                for(pos_block = ctl->blocks[fl][sl]; pos_block; pos_block = pos_block->next_free)
+                    dump_func(pos_block, block_size(pos_block) + EH_MEM_BLOCK_HEAD_SIZE);
+            }
+        }
+    }
+    eh_exit_critical(state);
+}
+
+static inline struct eh_mem_heap_ctl *eh_mem_heap_find(const void *ptr){
+    for(eh_size_t i = 0; i < mem_heap_array_cnt; i++){
+        if(mem_heap_ctl[i] && (const uint8_t*)ptr >= mem_heap_ctl[i]->start && (const uint8_t*)ptr < mem_heap_ctl[i]->end)
+            return mem_heap_ctl[i];
+    }
+    return NULL;
+}
+
+static inline int eh_mem_heap_id(const struct eh_mem_heap_ctl *ctl){
+    for(eh_size_t i = 0; i < mem_heap_array_cnt; i++){
+        if(mem_heap_ctl[i] == ctl)
+            return (int)i;
+    }
+    return -1;
+}
+
+static void *eh_mem_heap_malloc(struct eh_mem_heap_ctl *ctl, eh_size_t align_size){
+    struct eh_mem_block *block;
+
+    block = block_take_free(ctl, align_size);
+    if(block == NULL)
+        return NULL;
+    /* 剩余部分足够放下一个最小块时拆分 */
+    block_trim_used(ctl, block, align_size);
+    block_use_done(ctl);
+    return block_to_ptr(block);
+}
+
+static void *eh_mem_heap_malloc_aligned(struct eh_mem_heap_ctl *ctl, eh_size_t align, eh_size_t align_size){
+    eh_size_t search_size, gap;
+    struct eh_mem_block *block, *aligned_block;
+    uint8_t *ptr, *aligned_ptr;
+
+    /* 多申请一个对齐量和一个最小块，保证前面的空隙要么为0，要么能成为独立的空闲块 */
+    search_size = align_size + align + EH_MEM_BLOCK_HEAD_SIZE + EH_MEM_BLOCK_MIN_SIZE;
+    if(search_size < align_size || search_size > TLSF_BLOCK_SIZE_MAX)
+        return NULL;
+    block = block_take_free(ctl, search_size);
+    if(block == NULL)
+        return NULL;
+    ptr = block_to_ptr(block);
+    gap = 0;
+    if(((uintptr_t)ptr & (align - 1)) != 0){
+        aligned_ptr = (uint8_t*)eh_align_up((uintptr_t)ptr + EH_MEM_BLOCK_HEAD_SIZE + EH_MEM_BLOCK_MIN_SIZE, (uintptr_t)align);
+        gap = (eh_size_t)(aligned_ptr - ptr);
+    }
+    if(gap){
+        /* 前面的空隙还给空闲链表，它前面的物理块一定不是空闲块，无需合并 */
+        aligned_block = (struct eh_mem_block *)((uint8_t*)block + gap);
+        aligned_block->size = block_size(block) - gap;
+        aligned_block->prev_phys = block;
+        block_next(aligned_block)->prev_phys = aligned_block;
+        block->size = (gap - EH_MEM_BLOCK_HEAD_SIZE) | EH_MEM_BLOCK_FREE | (block->size & EH_MEM_BLOCK_PREV_FREE);
+        aligned_block->size |= EH_MEM_BLOCK_PREV_FREE;
+        block_insert_free(ctl, block);
+        ctl->mem_free_size += block_size(block);
+        block = aligned_block;
+    }
+    block_trim_used(ctl, block, align_size);
+    block_use_done(ctl);
+    return block_to_ptr(block);
+}
+
+void* eh_malloc(size_t _size){
+    eh_save_state_t state;
+    eh_size_t size = (eh_size_t)_size;
+    eh_size_t align_size = EH_MEM_ALIGN_UP(size);
+    void *new_mem = NULL;
+
+    /* 如果size == 0, 或者向上对齐过的align_size比以前小，那么说明溢出了，要分配的内存太大了 */
+    if(align_size == 0 || align_size < size || align_size > TLSF_BLOCK_SIZE_MAX)
+        return NULL;
+    if(align_size < EH_MEM_BLOCK_MIN_SIZE)
+        align_size = EH_MEM_BLOCK_MIN_SIZE;
+
+    state = eh_enter_critical();
+    /* 按注册顺序尝试所有非专用堆 */
+    for(eh_size_t i = 0; i < mem_heap_array_cnt && new_mem == NULL; i++){
+        if(mem_heap_ctl[i] == NULL || (mem_heap_ctl[i]->flags & EH_MEM_HEAP_FLAGS_EXCLUSIVE))
+            continue;
+        new_mem = eh_mem_heap_malloc(mem_heap_ctl[i], align_size);
+    }
+    eh_exit_critical(state);
+    eh_mdebugfl(MEM_ALLOC,"malloc @%#p size:%d", new_mem, align_size);
+    return new_mem;
+}
+
+void* eh_malloc_from(int heap_id, size_t _size){
+    eh_save_state_t state;
+    eh_size_t size = (eh_size_t)_size;
+    eh_size_t align_size = EH_MEM_ALIGN_UP(size);
+    struct eh_mem_heap_ctl *ctl;
+    void *new_mem;
+
+    if(heap_id < 0 || (eh_size_t)heap_id >= mem_heap_array_cnt || mem_heap_ctl[heap_id] == NULL)
+        return NULL;
+    if(align_size == 0 || align_size < size || align_size > TLSF_BLOCK_SIZE_MAX)
+        return NULL;
+    if(align_size < EH_MEM_BLOCK_MIN_SIZE)
+        align_size = EH_MEM_BLOCK_MIN_SIZE;
+    ctl = mem_heap_ctl[heap_id];
+    state = eh_enter_critical();
+    new_mem = eh_mem_heap_malloc(ctl, align_size);
+    eh_exit_critical(state);
+    eh_mdebugfl(MEM_ALLOC,"malloc from %d @%#p size:%d", heap_id, new_mem, align_size);
+    if(new_mem == NULL && !(ctl->flags & EH_MEM_HEAP_FLAGS_NO_FALLBACK))
+        return eh_malloc(_size);
+    return new_mem;
+}
+
+void* eh_malloc_aligned(size_t align, size_t _size){
+    eh_save_state_t state;
+    eh_size_t size = (eh_size_t)_size;
+    eh_size_t align_size = EH_MEM_ALIGN_UP(size);
+    void *new_mem = NULL;
+
+    if(align == 0 || (align & (align - 1)))
+        return NULL;
+    if(align <= EH_MEM_ALIGN_SIZE)
+        return eh_malloc(_size);
+    if(align_size == 0 || align_size < size || align_size > TLSF_BLOCK_SIZE_MAX)
+        return NULL;
+    if(align_size < EH_MEM_BLOCK_MIN_SIZE)
+        align_size = EH_MEM_BLOCK_MIN_SIZE;
+
+    state = eh_enter_critical();
+    for(eh_size_t i = 0; i < mem_heap_array_cnt && new_mem == NULL; i++){
+        if(mem_heap_ctl[i] == NULL || (mem_heap_ctl[i]->flags & EH_MEM_HEAP_FLAGS_EXCLUSIVE))
+            continue;
+        new_mem = eh_mem_heap_malloc_aligned(mem_heap_ctl[i], (eh_size_t)align, align_size);
+    }
+    eh_exit_critical(state);
+    eh_mdebugfl(MEM_ALLOC,"malloc aligned(%d) @%#p size:%d", align, new_mem, align_size);
+    return new_mem;
+}
+
+void* eh_calloc(size_t nmemb, size_t size){
+    void *new_mem;
+    if(size && nmemb > SIZE_MAX / size)
+        return NULL;
+    new_mem = eh_malloc(nmemb * size);
+    if(new_mem)
+        memset(new_mem, 0, nmemb * size);
+    return new_mem;
+}
+
+void* eh_realloc(void* ptr, size_t _size){
+    eh_save_state_t state;
+    eh_size_t size = (eh_size_t)_size;
+    eh_size_t align_size = EH_MEM_ALIGN_UP(size);
+    struct eh_mem_block *block, *next;
+    struct eh_mem_heap_ctl *ctl;
+    eh_size_t old_size;
+    void *new_mem;
+
+    if(size == 0){
+        eh_free(ptr);
+        return NULL;
+    }
+    if(ptr == NULL)
+        return eh_malloc(_size);
+    if(align_size < size || align_size > TLSF_BLOCK_SIZE_MAX)
+        return NULL;
+    if(align_size < EH_MEM_BLOCK_MIN_SIZE)
+        align_size = EH_MEM_BLOCK_MIN_SIZE;
+    block = block_from_ptr(ptr);
+    state = eh_enter_critical();
+    ctl = eh_mem_heap_find(ptr);
+    if(ctl == NULL){
+        eh_exit_critical(state);
+        return NULL;
+    }
+    old_size = block_size(block);
+    if(align_size > old_size){
+        next = block_next(block);
+        if(!(next->size & EH_MEM_BLOCK_FREE) || old_size + EH_MEM_BLOCK_HEAD_SIZE + block_size(next) < align_size){
+            eh_exit_critical(state);
+            goto copy;
+        }
+        /* 原地吞并物理相邻的下一个空闲块 */
+        block_unlink(ctl, next);
+        ctl->mem_free_size -= block_size(next);
+        block->size += EH_MEM_BLOCK_HEAD_SIZE + block_size(next);
+        next = block_next(block);
+        next->prev_phys = block;
+        next->size &= ~EH_MEM_BLOCK_PREV_FREE;
+    }
+    block_trim_used(ctl, block, align_size);
+    if(ctl->mem_free_size < ctl->mem_min_ever_free_size_level)
+        ctl->mem_min_ever_free_size_level = ctl->mem_free_size;
+    eh_exit_critical(state);
+    eh_mdebugfl(MEM_ALLOC,"realloc in place @%#p size:%d", ptr, align_size);
+    return ptr;
+copy:
+    /* 优先留在原来的堆里 */
+    new_mem = eh_malloc_from(eh_mem_heap_id(ctl), _size);
+    if(new_mem == NULL)
+        return NULL;
+    memcpy(new_mem, ptr, old_size);
+    eh_free(ptr);
+    return new_mem;
+}
+
+void  eh_free(void* ptr){
+    eh_save_state_t state;
+    struct eh_mem_block *block, *prev, *next;
+    struct eh_mem_heap_ctl *ctl;
+    if(ptr == NULL) return ;
+    block = block_from_ptr(ptr);
+    eh_mdebugfl(MEM_ALLOC,"free @%#p size:%d", ptr, block_size(block));
+
+    state = eh_enter_critical();
+    ctl = mem_heap_array_cnt == 1 ? mem_heap_ctl[0] : eh_mem_heap_find(ptr);
+    if(ctl == NULL)
+        goto out;
+    ctl->mem_free_size += block_size(block);
+    block->size |= EH_MEM_BLOCK_FREE;
+    /* 立即与物理相邻的空闲块合并 */
+    if(block->size & EH_MEM_BLOCK_PREV_FREE){
+        prev = block->prev_phys;
+        block_unlink(ctl, prev);
+        prev->size += EH_MEM_BLOCK_HEAD_SIZE + block_size(block);
+        ctl->mem_free_size += EH_MEM_BLOCK_HEAD_SIZE;
+        block = prev;
+    }
+    next = block_next(block);
+    if(next->size & EH_MEM_BLOCK_FREE){
+        block_unlink(ctl, next);
+        block->size += EH_MEM_BLOCK_HEAD_SIZE + block_size(next);
+        ctl->mem_free_size += EH_MEM_BLOCK_HEAD_SIZE;
+        next = block_next(block);
+    }
+    next->prev_phys = block;
+    next->size |= EH_MEM_BLOCK_PREV_FREE;
+    block_insert_free(ctl, block);
+    ctl->mem_use_block_cnt--;
+out:
+    eh_exit_critical(state);
+}
+
+/**
+ * @brief                   将一段内存初始化为一个堆，开头放置控制块，剩余部分作为一个空闲块，
+ *                          尾部放置一个大小为0的已用块作为哨兵，合并时不会越界
+ */
+static struct eh_mem_heap_ctl *eh_mem_heap_setup(const struct eh_mem_heap *heap){
+    struct eh_mem_heap_ctl *ctl;
+    struct eh_mem_block *block, *sentinel;
+    uint8_t *begin = (uint8_t*)EH_MEM_ALIGN_UP(heap->heap_start);
+    uint8_t *end = (uint8_t*)EH_MEM_ALIGN_DOWN((uint8_t*)heap->heap_start + heap->heap_size);
+    eh_size_t block_bytes;
+
+    if(end <= begin || (eh_size_t)(end - begin) < EH_MEM_HEAP_CTL_SIZE + EH_MEM_BLOCK_HEAD_SIZE * 2 + EH_MEM_BLOCK_MIN_SIZE)
+        return NULL;
+    ctl = (struct eh_mem_heap_ctl *)begin;
+    memset(ctl, 0, sizeof(struct eh_mem_heap_ctl));
+    begin += EH_MEM_HEAP_CTL_SIZE;
+    block_bytes = (eh_size_t)(end - begin) - EH_MEM_BLOCK_HEAD_SIZE * 2;
+    /* 超过单块上限的部分直接丢弃 */
+    if(block_bytes > TLSF_BLOCK_SIZE_MAX)
+        block_bytes = TLSF_BLOCK_SIZE_MAX;
+    block = (struct eh_mem_block *)begin;
+    block->prev_phys = NULL;
+    block->size = block_bytes | EH_MEM_BLOCK_FREE;
+    sentinel = block_next(block);
+    sentinel->prev_phys = block;
+    sentinel->size = 0 | EH_MEM_BLOCK_PREV_FREE;
+    block_insert_free(ctl, block);
+    ctl->start = begin;
+    ctl->end = (uint8_t*)sentinel;
+    ctl->flags = heap->flags;
+    ctl->mem_free_size = block_bytes;
+    ctl->mem_total_size = block_bytes;
+    ctl->mem_min_ever_free_size_level = block_bytes;
+    return ctl;
+}
+
+int eh_mem_heap_register(const struct eh_mem_heap *heap){
+    eh_save_state_t state;
+    int heap_id;
+    eh_param_assert(heap);
+    eh_param_assert(heap->heap_start);
+    eh_param_assert(heap->heap_size >= EH_MEM_HEAP_MIN_SIZE);
+    state = eh_enter_critical();
+    if(mem_heap_array_cnt >= EH_MEM_HEAP_ARRAY_NUM){
+        eh_exit_critical(state);
+        return EH_RET_BUSY;
+    }
+    heap_id = (int)mem_heap_array_cnt;
+    mem_heap_array[heap_id] = *heap;
+    if(mem_heap_ready)
+        mem_heap_ctl[heap_id] = eh_mem_heap_setup(heap);
+    mem_heap_array_cnt++;
+    eh_exit_critical(state);
+    return heap_id;
+}
+
+/* 最大的空闲块一定在位图最高位对应的链表里，只需遍历这一条链表 */
+static eh_size_t tlsf_largest_free(struct eh_mem_heap_ctl *ctl){
+    struct eh_mem_block *pos_block;
+    eh_size_t largest = 0;
+    int fl, sl;
+
+    if(ctl->fl_bitmap == 0)
+        return 0;
+    fl = tlsf_fls(ctl->fl_bitmap);
+    sl = tlsf_fls(ctl->sl_bitmap[fl]);
+    for(pos_block = ctl->blocks[fl][sl]; pos_block; pos_block = pos_block->next_free){
+        if(block_size(pos_block) > largest)
+            largest = block_size(pos_block);
+    }
+    return largest;
+}
+
+static void eh_mem_heap_info_fill(struct eh_mem_heap_ctl *ctl, struct eh_mem_heap_info *heap_info){
+    eh_size_t largest;
+    if(ctl == NULL)
+        return ;
+    largest = tlsf_largest_free(ctl);
+    heap_info->free_size += ctl->mem_free_size;
+    heap_info->total_size += ctl->mem_total_size;
+    heap_info->min_ever_free_size_level += ctl->mem_min_ever_free_size_level;
+    if(largest > heap_info->largest_free_block)
+        heap_info->largest_free_block = largest;
+    heap_info->free_block_cnt += ctl->mem_free_block_cnt;
+    for(unsigned int i = 0; i < EH_MEM_FREE_HIST_BIN_CNT; i++)
+        heap_info->free_hist[i] += ctl->mem_free_hist[i];
+}
+
+void eh_mem_get_heap_info(struct eh_mem_heap_info *heap_info){
+    eh_save_state_t state;
+    memset(heap_info, 0, sizeof(struct eh_mem_heap_info));
+    state = eh_enter_critical();
+    for(eh_size_t i = 0; i < mem_heap_array_cnt; i++)
+        eh_mem_heap_info_fill(mem_heap_ctl[i], heap_info);
+    eh_exit_critical(state);
+}
+
+int eh_mem_get_heap_info_by_id(int heap_id, struct eh_mem_heap_info *heap_info){
+    eh_save_state_t state;
+    eh_param_assert(heap_info);
+    eh_param_assert(heap_id >= 0 && (eh_size_t)heap_id < mem_heap_array_cnt);
+    memset(heap_info, 0, sizeof(struct eh_mem_heap_info));
+    state = eh_enter_critical();
+    eh_mem_heap_info_fill(mem_heap_ctl[heap_id], heap_info);
+    eh_exit_critical(state);
+    return EH_RET_OK;
+}
+
+static void eh_mem_heap_info_print(const char *title){
+    struct eh_mem_heap_info info;
+    eh_size_t use_block_cnt = 0;
+    eh_mem_get_heap_info(&info);
+    for(eh_size_t i = 0; i < mem_heap_array_cnt; i++){
+        if(mem_heap_ctl[i])
+            use_block_cnt += mem_heap_ctl[i]->mem_use_block_cnt;
+    }
+    eh_infoln("%s", title);
+    eh_infoln("%11s\t%11s\t%11s\t%11s","total", "used" ,"free" ,"mefsl");
+    eh_infoln("%11lu\t%11lu(%d)\t%11lu\t%11lu", info.total_size, info.total_size - info.free_size, 
+        (int)use_block_cnt, info.free_size, info.min_ever_free_size_level);
+    if(mem_heap_array_cnt > 1){
+        for(eh_size_t i = 0; i < mem_heap_array_cnt; i++){
+            if(mem_heap_ctl[i] == NULL)
+                continue;
+            eh_infoln("    heap %lu: total %lu free %lu flags %#x", i, mem_heap_ctl[i]->mem_total_size, 
+                mem_heap_ctl[i]->mem_free_size, mem_heap_ctl[i]->flags);
+        }
+    }
+}
+
+static int __init eh_mem_init(void){
+    eh_param_assert(mem_heap_array_cnt);
+    for(eh_size_t i=0;i < mem_heap_array_cnt;i++)
+        mem_heap_ctl[i] = eh_mem_heap_setup(&mem_heap_array[i]);
+    mem_heap_ready = true;
+    eh_mem_heap_info_print("Initializes the heap information(tlsf):");
+    return 0;
+}
+
+static void __exit eh_mem_exit(void){
+    eh_mem_heap_info_print("Exits the heap information(tlsf):");
+    mem_heap_ready = false;
+}
+
+eh_memory_module_export(eh_mem_init, eh_mem_exit);
+
+#endif
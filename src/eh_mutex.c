@@ -22,6 +22,7 @@
 #include <eh_platform.h>
 #include <eh_internal.h>
 #include <eh_mutex.h>
+#include <eh_slab.h>
 
 #define EH_MUTEX_LOCK_CNT_MAX   0xFFFFFFFF
 struct eh_mutex {
@@ -32,6 +33,8 @@ struct eh_mutex {
     eh_task_t                   *lock_task;
 };
 
+EH_DEFINE_STATIC_SLAB_CACHE(mutex_cache, struct eh_mutex);
+
 static bool condition_mutex(void *arg){
     struct eh_mutex *mutex = (struct eh_mutex *)arg;
     return mutex->lock_cnt == 0 || (mutex->type == EH_MUTEX_TYPE_RECURSIVE && mutex->lock_task == eh_task_self());
@@ -43,7 +46,7 @@ eh_mutex_t eh_mutex_create(enum eh_mutex_type type){
     if( type >= EH_MUTEX_TYPE_MAX)
         return eh_error_to_ptr(EH_RET_INVALID_PARAM);
 
-    new_mutex = eh_malloc(sizeof(struct eh_mutex));
+    new_mutex = eh_slab_alloc(&mutex_cache);
     if( new_mutex == NULL )
         return eh_error_to_ptr(EH_RET_MALLOC_ERROR);
     new_mutex->lock_cnt = 0;
@@ -55,7 +58,7 @@ eh_mutex_t eh_mutex_create(enum eh_mutex_type type){
 void eh_mutex_destroy(eh_mutex_t _mutex){
     struct eh_mutex *mutex = (struct eh_mutex *)_mutex;
     eh_event_clean(&mutex->wakeup_event);
-    eh_free(mutex);
+    eh_slab_free(&mutex_cache, mutex);
 }
 
 int __async eh_mutex_lock(eh_mutex_t _mutex, eh_sclock_t timeout){
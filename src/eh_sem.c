@@ -18,6 +18,7 @@
 #include <eh_platform.h>
 #include <eh_internal.h>
 #include <eh_sem.h>
+#include <eh_slab.h>
 #include <stdbool.h>
 
 struct eh_sem {
@@ -32,6 +33,8 @@ struct eh_sem {
     uint32_t                    sem_num_v; /* post */
 };
 
+EH_DEFINE_STATIC_SLAB_CACHE(sem_cache, struct eh_sem);
+
 static bool condition_sem(void *arg){
     struct eh_sem *sem = (struct eh_sem *)arg;
     return !(sem->sem_num_p == sem->sem_num_v) ;
@@ -39,7 +42,7 @@ static bool condition_sem(void *arg){
 
 eh_sem_t eh_sem_create(uint32_t value){
     struct eh_sem *new_sem;
-    new_sem = (struct eh_sem *)eh_malloc(sizeof(struct eh_sem));
+    new_sem = (struct eh_sem *)eh_slab_alloc(&sem_cache);
     if( new_sem == NULL )
         return eh_error_to_ptr(EH_RET_MALLOC_ERROR);
     new_sem->sem_num_v = value;
@@ -51,7 +54,7 @@ eh_sem_t eh_sem_create(uint32_t value){
 void eh_sem_destroy(eh_sem_t _sem){
     struct eh_sem *sem = (struct eh_sem *)_sem;
     eh_event_clean(&sem->wakeup_event);
-    eh_free(sem);
+    eh_slab_free(&sem_cache, sem);
 }
 
 
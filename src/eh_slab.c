@@ -0,0 +1,103 @@
+/**
+ * @file eh_slab.c
+ * @brief 固定大小对象缓存的实现，建立在可增长的 eh_mem_pool 之上
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <eh.h>
+#include <eh_error.h>
+#include <eh_list.h>
+#include <eh_mem_pool.h>
+#include <eh_platform.h>
+#include <eh_debug.h>
+#include <eh_module.h>
+#include <eh_slab.h>
+
+static EH_LIST_HEAD(slab_cache_list_head);
+
+void* eh_slab_alloc(struct eh_slab_cache *cache){
+    eh_save_state_t state;
+    void *ptr = NULL;
+
+    state = eh_enter_critical();
+    if(cache->pool == NULL){
+        cache->pool = eh_mem_pool_create_growable(cache->obj_align, cache->obj_size,
+            cache->chunk_obj_cnt, EH_MEM_POOL_FLAGS_RELEASE_EMPTY_CHUNK);
+        if(eh_ptr_to_error(cache->pool) < 0){
+            cache->pool = NULL;
+            goto quit;
+        }
+        eh_list_add_tail(&cache->cache_node, &slab_cache_list_head);
+    }
+    ptr = eh_mem_pool_alloc_no_lock(cache->pool);
+    if(ptr == NULL)
+        goto quit;
+    cache->alloc_cnt++;
+    if(eh_mem_pool_used(cache->pool) > cache->max_inuse_cnt)
+        cache->max_inuse_cnt = eh_mem_pool_used(cache->pool);
+quit:
+    if(ptr == NULL)
+        cache->fail_cnt++;
+    eh_exit_critical(state);
+    return ptr;
+}
+
+void eh_slab_free(struct eh_slab_cache *cache, void *ptr){
+    if(ptr == NULL)
+        return ;
+    if(cache->pool == NULL){
+        eh_warnfl("slab %s free unknown ptr %p", cache->name, ptr);
+        return ;
+    }
+    eh_mem_pool_free(cache->pool, ptr);
+}
+
+static void slab_cache_stat_fill(struct eh_slab_cache *cache, struct eh_slab_cache_stat *stat){
+    stat->name = cache->name;
+    stat->obj_size = cache->obj_size;
+    stat->chunk_cnt = cache->pool ? eh_mem_pool_chunk_cnt(cache->pool) : 0;
+    stat->inuse_cnt = cache->pool ? eh_mem_pool_used(cache->pool) : 0;
+    stat->max_inuse_cnt = cache->max_inuse_cnt;
+    stat->alloc_cnt = cache->alloc_cnt;
+    stat->fail_cnt = cache->fail_cnt;
+}
+
+void eh_slab_cache_get_stat(struct eh_slab_cache *cache, struct eh_slab_cache_stat *stat){
+    eh_save_state_t state;
+    state = eh_enter_critical();
+    slab_cache_stat_fill(cache, stat);
+    eh_exit_critical(state);
+}
+
+void eh_slab_stat_dump(void stat_func(const struct eh_slab_cache_stat *stat)){
+    struct eh_slab_cache *cache;
+    struct eh_slab_cache_stat stat;
+    eh_save_state_t state;
+    /* 缓存首次分配时会在临界区内挂入链表，遍历期间同样持有临界区 */
+    state = eh_enter_critical();
+    eh_list_for_each_entry(cache, &slab_cache_list_head, cache_node){
+        slab_cache_stat_fill(cache, &stat);
+        stat_func(&stat);
+    }
+    eh_exit_critical(state);
+}
+
+static void __exit eh_slab_exit(void){
+    struct eh_slab_cache *cache, *n;
+
+    eh_list_for_each_entry_safe(cache, n, &slab_cache_list_head, cache_node){
+        if(eh_mem_pool_used(cache->pool))
+            eh_warnfl("slab %s has %lu objects not freed", cache->name, (unsigned long)eh_mem_pool_used(cache->pool));
+        eh_mem_pool_destroy(cache->pool);
+        cache->pool = NULL;
+        eh_list_del_init(&cache->cache_node);
+    }
+}
+
+eh_slab_module_export(NULL, eh_slab_exit);
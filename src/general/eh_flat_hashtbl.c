@@ -0,0 +1,283 @@
+/**
+ * @file eh_flat_hashtbl.c
+ * @brief 开放寻址哈希表实现，槽位按16个一组，组的起点按16对齐，探测序列以组为单位三角跳跃，
+ *        控制字节为 EMPTY(0x80)/DELETED(0xfe)/哈希值高7位(0~0x7f)，组内比较用SSE2或8字节一次的SWAR，
+ *        一个组中只要还有EMPTY，就没有探测序列会越过这个组，删除时据此决定写EMPTY还是DELETED
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <eh.h>
+#include <eh_config.h>
+#include <eh_types.h>
+#include <eh_error.h>
+#include <eh_mem.h>
+#include <eh_hash.h>
+#include <eh_flat_hashtbl.h>
+
+#if EH_CONFIG_FLAT_HASHTBL_USE_SSE2 && defined(__SSE2__)
+#include <emmintrin.h>
+#define EH_FLAT_HASHTBL_SSE2            1
+#endif
+
+#define EH_FLAT_HASHTBL_GROUP           16U
+#define EH_FLAT_HASHTBL_CTRL_EMPTY      ((int8_t)-128)
+#define EH_FLAT_HASHTBL_CTRL_DELETED    ((int8_t)-2)
+
+struct eh_flat_hashtbl{
+    uint8_t                     *slots;
+    int8_t                      *ctrl;
+    size_t                      mask;                   /* 槽位数减1，槽位数为2的幂且不小于16 */
+    size_t                      count;
+    size_t                      growth_left;            /* 还能占用多少个EMPTY槽位，为0时扩容或清理DELETED */
+    size_t                      key_size;
+    size_t                      value_size;
+    size_t                      value_offset;
+    size_t                      slot_size;
+};
+
+#define slot_key(hashtbl, idx)      ((hashtbl)->slots + (idx) * (hashtbl)->slot_size)
+#define slot_value(hashtbl, idx)    (slot_key(hashtbl, idx) + (hashtbl)->value_offset)
+#define ctrl_h2(hash)               ((int8_t)((hash) >> 25))
+/* 负载因子上限 7/8 */
+#define max_load(capacity)          ((capacity) - (capacity) / 8)
+
+#define flat_hash(key, len)         eh_hash_wy(key, len, 0)
+
+#ifdef EH_FLAT_HASHTBL_SSE2
+
+static inline uint32_t group_match(const int8_t *group, int8_t h2){
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h2)));
+}
+
+/* EMPTY和DELETED的最高位都是1 */
+static inline uint32_t group_match_empty_or_deleted(const int8_t *group){
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)group));
+}
+
+#else
+
+/* 无SIMD时一次处理8个控制字节(SWAR) */
+#define EH_FLAT_HASHTBL_LSB             0x0101010101010101ULL
+#define EH_FLAT_HASHTBL_MSB             0x8080808080808080ULL
+
+static inline uint64_t group_word(const int8_t *group){
+    uint64_t word;
+    memcpy(&word, group, sizeof(word));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+}
+
+/* 把每个字节的最高位收集成8位掩码，第i位对应第i个字节 */
+static inline uint32_t word_mask(uint64_t msb){
+    return (uint32_t)(((msb >> 7) * 0x0102040810204080ULL) >> 56);
+}
+
+/* 字节相等时异或结果为0，零字节检测不跨字节进位，没有误报 */
+static inline uint32_t word_match(uint64_t word, int8_t h2){
+    uint64_t x = word ^ (EH_FLAT_HASHTBL_LSB * (uint8_t)h2);
+    return word_mask(~(((x & ~EH_FLAT_HASHTBL_MSB) + ~EH_FLAT_HASHTBL_MSB) | x) & EH_FLAT_HASHTBL_MSB);
+}
+
+static inline uint32_t group_match(const int8_t *group, int8_t h2){
+    return word_match(group_word(group), h2) | (word_match(group_word(group + 8), h2) << 8);
+}
+
+static inline uint32_t group_match_empty_or_deleted(const int8_t *group){
+    return word_mask(group_word(group) & EH_FLAT_HASHTBL_MSB) |
+        (word_mask(group_word(group + 8) & EH_FLAT_HASHTBL_MSB) << 8);
+}
+
+#endif
+
+#define group_match_empty(group)    group_match(group, EH_FLAT_HASHTBL_CTRL_EMPTY)
+
+static size_t flat_find(struct eh_flat_hashtbl *hashtbl, const void *key, uint32_t hash){
+    size_t pos = hash & hashtbl->mask & ~(size_t)(EH_FLAT_HASHTBL_GROUP - 1);
+    size_t step = 0;
+    uint32_t match;
+    int8_t h2 = ctrl_h2(hash);
+
+    for(;;){
+        for(match = group_match(hashtbl->ctrl + pos, h2); match; match &= match - 1){
+            size_t idx = pos + (size_t)__builtin_ctz(match);
+            if(memcmp(slot_key(hashtbl, idx), key, hashtbl->key_size) == 0)
+                return idx;
+        }
+        if(group_match_empty(hashtbl->ctrl + pos))
+            return SIZE_MAX;
+        step += EH_FLAT_HASHTBL_GROUP;
+        pos = (pos + step) & hashtbl->mask;
+    }
+}
+
+/* 探测序列上第一个EMPTY或DELETED槽位，负载因子保证一定能找到 */
+static size_t flat_find_free(struct eh_flat_hashtbl *hashtbl, uint32_t hash){
+    size_t pos = hash & hashtbl->mask & ~(size_t)(EH_FLAT_HASHTBL_GROUP - 1);
+    size_t step = 0;
+    uint32_t match;
+
+    while((match = group_match_empty_or_deleted(hashtbl->ctrl + pos)) == 0){
+        step += EH_FLAT_HASHTBL_GROUP;
+        pos = (pos + step) & hashtbl->mask;
+    }
+    return pos + (size_t)__builtin_ctz(match);
+}
+
+static int flat_alloc(struct eh_flat_hashtbl *hashtbl, size_t capacity){
+    size_t slots_size;
+    if(capacity > (SIZE_MAX - EH_FLAT_HASHTBL_GROUP) / (hashtbl->slot_size + 1))
+        return EH_RET_MALLOC_ERROR;
+    slots_size = eh_align_up(capacity * hashtbl->slot_size, (size_t)EH_FLAT_HASHTBL_GROUP);
+    hashtbl->slots = eh_malloc(slots_size + capacity);
+    if(hashtbl->slots == NULL)
+        return EH_RET_MALLOC_ERROR;
+    hashtbl->ctrl = (int8_t *)(hashtbl->slots + slots_size);
+    memset(hashtbl->ctrl, EH_FLAT_HASHTBL_CTRL_EMPTY, capacity);
+    hashtbl->mask = capacity - 1;
+    hashtbl->growth_left = max_load(capacity) - hashtbl->count;
+    return EH_RET_OK;
+}
+
+/* 扩容或在DELETED过多时原大小重建，所有元素重新放置 */
+static int flat_rehash(struct eh_flat_hashtbl *hashtbl){
+    struct eh_flat_hashtbl old = *hashtbl;
+    size_t capacity = old.mask + 1;
+    size_t idx;
+    int ret;
+
+    if(old.count * 2 >= max_load(capacity))
+        capacity <<= 1;
+    ret = flat_alloc(hashtbl, capacity);
+    if(ret < 0){
+        *hashtbl = old;
+        return ret;
+    }
+    for(size_t i = 0; i <= old.mask; i++){
+        if(old.ctrl[i] < 0)
+            continue;
+        idx = flat_find_free(hashtbl, flat_hash(slot_key(&old, i), old.key_size));
+        hashtbl->ctrl[idx] = old.ctrl[i];
+        memcpy(slot_key(hashtbl, idx), slot_key(&old, i), old.slot_size);
+    }
+    eh_free(old.slots);
+    return EH_RET_OK;
+}
+
+/* 能整除size的最大2的幂，不超过8 */
+static size_t natural_align(size_t size){
+    size_t align = 8;
+    while(align > 1 && (size & (align - 1)))
+        align >>= 1;
+    return align;
+}
+
+eh_flat_hashtbl_t eh_flat_hashtbl_create(size_t key_size, size_t value_size, size_t capacity_hint){
+    struct eh_flat_hashtbl *hashtbl;
+    size_t capacity = EH_FLAT_HASHTBL_GROUP;
+    size_t key_align = natural_align(key_size), value_align = natural_align(value_size);
+
+    if(key_size == 0 || key_size > 0xffff || value_size > 0xffff || capacity_hint > (SIZE_MAX >> 4))
+        return eh_error_to_ptr(EH_RET_INVALID_PARAM);
+    while(max_load(capacity) < capacity_hint)
+        capacity <<= 1;
+    hashtbl = eh_malloc(sizeof(struct eh_flat_hashtbl));
+    if(hashtbl == NULL)
+        return eh_error_to_ptr(EH_RET_MALLOC_ERROR);
+    hashtbl->key_size = key_size;
+    hashtbl->value_size = value_size;
+    hashtbl->value_offset = eh_align_up(key_size, value_align);
+    hashtbl->slot_size = eh_align_up(hashtbl->value_offset + value_size, key_align > value_align ? key_align : value_align);
+    hashtbl->count = 0;
+    if(flat_alloc(hashtbl, capacity) < 0){
+        eh_free(hashtbl);
+        return eh_error_to_ptr(EH_RET_MALLOC_ERROR);
+    }
+    return (eh_flat_hashtbl_t)hashtbl;
+}
+
+void eh_flat_hashtbl_destroy(eh_flat_hashtbl_t _hashtbl){
+    struct eh_flat_hashtbl *hashtbl = (struct eh_flat_hashtbl *)_hashtbl;
+    eh_free(hashtbl->slots);
+    eh_free(hashtbl);
+}
+
+int eh_flat_hashtbl_insert(eh_flat_hashtbl_t _hashtbl, const void *key, const void *value, void **out_value){
+    struct eh_flat_hashtbl *hashtbl = (struct eh_flat_hashtbl *)_hashtbl;
+    uint32_t hash = flat_hash(key, hashtbl->key_size);
+    size_t idx;
+    int ret;
+
+    idx = flat_find(hashtbl, key, hash);
+    if(idx != SIZE_MAX){
+        if(out_value)
+            *out_value = slot_value(hashtbl, idx);
+        return EH_RET_EXISTS;
+    }
+    idx = flat_find_free(hashtbl, hash);
+    if(hashtbl->growth_left == 0 && hashtbl->ctrl[idx] == EH_FLAT_HASHTBL_CTRL_EMPTY){
+        ret = flat_rehash(hashtbl);
+        if(ret < 0)
+            return ret;
+        idx = flat_find_free(hashtbl, hash);
+    }
+    if(hashtbl->ctrl[idx] == EH_FLAT_HASHTBL_CTRL_EMPTY)
+        hashtbl->growth_left--;
+    hashtbl->ctrl[idx] = ctrl_h2(hash);
+    memcpy(slot_key(hashtbl, idx), key, hashtbl->key_size);
+    if(value)
+        memcpy(slot_value(hashtbl, idx), value, hashtbl->value_size);
+    hashtbl->count++;
+    if(out_value)
+        *out_value = slot_value(hashtbl, idx);
+    return EH_RET_OK;
+}
+
+void* eh_flat_hashtbl_find(eh_flat_hashtbl_t _hashtbl, const void *key){
+    struct eh_flat_hashtbl *hashtbl = (struct eh_flat_hashtbl *)_hashtbl;
+    size_t idx = flat_find(hashtbl, key, flat_hash(key, hashtbl->key_size));
+    return idx == SIZE_MAX ? NULL : slot_value(hashtbl, idx);
+}
+
+int eh_flat_hashtbl_erase(eh_flat_hashtbl_t _hashtbl, const void *key){
+    struct eh_flat_hashtbl *hashtbl = (struct eh_flat_hashtbl *)_hashtbl;
+    size_t idx = flat_find(hashtbl, key, flat_hash(key, hashtbl->key_size));
+    if(idx == SIZE_MAX)
+        return EH_RET_NOT_EXISTS;
+    if(group_match_empty(hashtbl->ctrl + (idx & ~(size_t)(EH_FLAT_HASHTBL_GROUP - 1)))){
+        hashtbl->ctrl[idx] = EH_FLAT_HASHTBL_CTRL_EMPTY;
+        hashtbl->growth_left++;
+    }else{
+        hashtbl->ctrl[idx] = EH_FLAT_HASHTBL_CTRL_DELETED;
+    }
+    hashtbl->count--;
+    return EH_RET_OK;
+}
+
+size_t eh_flat_hashtbl_count(eh_flat_hashtbl_t _hashtbl){
+    struct eh_flat_hashtbl *hashtbl = (struct eh_flat_hashtbl *)_hashtbl;
+    return hashtbl->count;
+}
+
+void* eh_flat_hashtbl_next(eh_flat_hashtbl_t _hashtbl, size_t *iter, const void **out_key){
+    struct eh_flat_hashtbl *hashtbl = (struct eh_flat_hashtbl *)_hashtbl;
+    for(size_t i = *iter; i <= hashtbl->mask; i++){
+        if(hashtbl->ctrl[i] < 0)
+            continue;
+        *iter = i + 1;
+        if(out_key)
+            *out_key = slot_key(hashtbl, i);
+        return slot_value(hashtbl, i);
+    }
+    *iter = hashtbl->mask + 1;
+    return NULL;
+}
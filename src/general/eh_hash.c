@@ -0,0 +1,122 @@
+/**
+ * @file eh_hash.c
+ * @brief 哈希函数实现，eh_hash_wy 把输入看作小端的64位字序列，每16字节做一次64x64->128乘法并把高低两半异或，
+ *        状态同时参与乘法的两个操作数，不知道seed就无法构造让乘数为0的输入，
+ *        最后不足16字节的部分补0后再处理一次，长度在最后混入
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <eh_hash.h>
+
+#define EH_HASH_WY_P0                   0x2d358dccaa6c78a5ULL
+#define EH_HASH_WY_P1                   0x8bb84b93962eacc9ULL
+#define EH_HASH_WY_P2                   0x4b33a62ed433d4a3ULL
+#define EH_HASH_WY_P3                   0x4d5a2da51de1aa47ULL
+
+#define FNV_OFFSET_BASIS_32 2166136261U
+#define FNV_PRIME_32 16777619U
+
+static inline uint64_t wy_mum(uint64_t a, uint64_t b){
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)a * b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+#else
+    /* 没有128位整数的平台上分成4次32位乘法，结果与上面相同 */
+    uint64_t ll = (uint64_t)(uint32_t)a * (uint32_t)b;
+    uint64_t lh = (uint64_t)(uint32_t)a * (b >> 32);
+    uint64_t hl = (a >> 32) * (uint32_t)b;
+    uint64_t hh = (a >> 32) * (b >> 32);
+    uint64_t mid = (ll >> 32) + (uint32_t)lh + (uint32_t)hl;
+    uint64_t lo = (mid << 32) | (uint32_t)ll;
+    uint64_t hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+    return lo ^ hi;
+#endif
+}
+
+static inline uint64_t wy_le(uint64_t v){
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+static inline uint64_t wy_read8(const uint8_t *p){
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return wy_le(v);
+}
+
+/* 不足8字节时高位补0 */
+static inline uint64_t wy_read_tail(const uint8_t *p, size_t n){
+    uint64_t v = 0;
+    for(size_t i = 0; i < n; i++)
+        v |= (uint64_t)p[i] << (i * 8);
+    return v;
+}
+
+#define wy_round(h, a, b)           wy_mum((a) ^ (h) ^ EH_HASH_WY_P1, (b) ^ (h) ^ EH_HASH_WY_P2)
+
+static inline eh_hash_val_t wy_final(uint64_t h, uint64_t a, uint64_t b, size_t len){
+    h = wy_round(h, a, b);
+    h = wy_mum(h ^ (uint64_t)len ^ EH_HASH_WY_P3, h ^ EH_HASH_WY_P0);
+    return (eh_hash_val_t)(h ^ (h >> 32));
+}
+
+eh_hash_val_t eh_hash_wy(const void *key, size_t len, uint64_t seed){
+    const uint8_t *p = (const uint8_t *)key;
+    uint64_t h = seed ^ EH_HASH_WY_P0;
+    size_t left = len;
+    uint64_t a, b;
+
+    for(; left >= 16; left -= 16, p += 16)
+        h = wy_round(h, wy_read8(p), wy_read8(p + 8));
+    if(left > 8){
+        a = wy_read8(p);
+        b = wy_read_tail(p + 8, left - 8);
+    }else if(left == 8){
+        a = wy_read8(p);
+        b = 0;
+    }else{
+        a = wy_read_tail(p, left);
+        b = 0;
+    }
+    return wy_final(h, a, b, len);
+}
+
+eh_hash_val_t eh_hash_wy_str(const char *str, size_t *out_len, uint64_t seed){
+    /* 先用libc的strlen找结尾，它的字读取在库内部保证安全，自己越过结尾按字读取是越界访问 */
+    size_t len = strlen(str);
+    if(out_len)
+        *out_len = len;
+    return eh_hash_wy(str, len, seed);
+}
+
+eh_hash_val_t eh_hash_fnv1a(const void *key, size_t len, uint64_t seed){
+    const uint8_t *bp = (const uint8_t *)key;
+    const uint8_t *be = bp + len;
+    eh_hash_val_t hash = FNV_OFFSET_BASIS_32 ^ (eh_hash_val_t)seed;
+    while(bp < be){
+        hash ^= (eh_hash_val_t)*bp++;
+        hash *= FNV_PRIME_32;
+    }
+    return hash;
+}
+
+eh_hash_val_t eh_hash_fnv1a_str(const char *str, size_t *out_len, uint64_t seed){
+    const uint8_t *bp = (const uint8_t *)str;
+    eh_hash_val_t hash = FNV_OFFSET_BASIS_32 ^ (eh_hash_val_t)seed;
+    while(*bp){
+        hash ^= (eh_hash_val_t)*bp++;
+        hash *= FNV_PRIME_32;
+    }
+    if(out_len)
+        *out_len = (size_t)(bp - (const uint8_t *)str);
+    return hash;
+}
@@ -8,6 +8,7 @@
  * 
  */
 
+#include <limits.h>
 #include <string.h>
 #include <eh.h>
 #include <eh_types.h>
@@ -21,97 +22,137 @@ eh_static_assert(
 );
 
 
-#define eh_hash_val(key, key_len)           fnv1a(key, key_len)
-#define eh_hash_str_val(str, out_len_ptr)   fnv1a_str(str, out_len_ptr)
+#define eh_hash_val(hashtbl, key, key_len)          \
+    ((hashtbl)->hash_ops->hash(key, key_len, (hashtbl)->seed))
 
+static inline eh_hash_val_t eh_hash_str_val(struct eh_hashtbl *hashtbl, const char *str, eh_hashtbl_kv_len_t *out_len){
+    size_t len;
+    eh_hash_val_t hash_val = hashtbl->hash_ops->hash_str(str, &len, hashtbl->seed);
+    *out_len = (eh_hashtbl_kv_len_t)len;
+    return hash_val;
+}
+
+const struct eh_hashtbl_hash_ops eh_hashtbl_hash_wy = {
+    .hash = eh_hash_wy,
+    .hash_str = eh_hash_wy_str,
+};
 
+const struct eh_hashtbl_hash_ops eh_hashtbl_hash_fnv1a = {
+    .hash = eh_hash_fnv1a,
+    .hash_str = eh_hash_fnv1a_str,
+};
 
+/* 旧散列表中迁移完成的桶用next为NULL标记 */
+#define eh_hashtbl_bucket_is_migrated(table, idx)       ((table)[idx].next == NULL)
 
-#define FNV_OFFSET_BASIS_32 2166136261U 
-#define FNV_PRIME_32 16777619U 
- 
-static eh_hash_val_t fnv1a(const char *data, eh_hashtbl_kv_len_t len) {
-    const char *bp = (const char *)data;
-    const char *be = bp + len;
-    eh_hash_val_t hash = FNV_OFFSET_BASIS_32;
-    while(bp < be) {
-        hash ^= (eh_hash_val_t)*(unsigned char*)bp++;
-        hash *= FNV_PRIME_32; 
+/**
+ * 把旧散列表的一个桶迁移到新散列表，新散列表分配后不做初始化，桶在第一次成为迁移目标时才初始化:
+ * 扩容时新桶 j 只来自旧桶 j & old_mask，缩容时新桶 j 来自旧桶 j 和 j + 新大小，
+ * 所以只要一个键在旧散列表中的桶已经迁移，它在新散列表中的桶就一定已经初始化
+ */
+static void eh_hashtbl_migrate_bucket(struct eh_hashtbl *hashtbl, unsigned int old_idx){
+    struct eh_list_head *old_head = hashtbl->old_table + old_idx;
+    struct eh_list_head *pos, *n;
+    unsigned int new_idx;
+
+    if(hashtbl->mask > hashtbl->old_mask){
+        for(new_idx = old_idx; new_idx <= hashtbl->mask; new_idx += hashtbl->old_mask + 1)
+            eh_list_head_init(hashtbl->table + new_idx);
+    }else{
+        new_idx = old_idx & hashtbl->mask;
+        if(!eh_hashtbl_bucket_is_migrated(hashtbl->old_table, old_idx ^ (hashtbl->mask + 1)))
+            eh_list_head_init(hashtbl->table + new_idx);
     }
-    return hash;
+    eh_list_for_each_safe(pos, n, old_head){
+        struct eh_hashtbl_node *node = eh_list_entry(pos, struct eh_hashtbl_node, node);
+        eh_list_add_tail(pos, hashtbl->table + (node->hash_val & hashtbl->mask));
+    }
+    old_head->next = NULL;
 }
 
-static eh_hash_val_t fnv1a_str(const char *str, eh_hashtbl_kv_len_t *out_len) {
-    const char *bp = str;
-    eh_hash_val_t hash = FNV_OFFSET_BASIS_32;
-    while(*bp) {
-        hash ^= (eh_hash_val_t)*(unsigned char*)bp++;
-        hash *= FNV_PRIME_32; 
-    }
-    if(out_len)
-        *out_len = (eh_hashtbl_kv_len_t)(bp - str);
-    return hash;
+static void eh_hashtbl_migrate_done(struct eh_hashtbl *hashtbl){
+    eh_free(hashtbl->old_table);
+    hashtbl->old_table = NULL;
+    hashtbl->old_mask = 0;
+    hashtbl->migrate_idx = 0;
 }
 
-static int eh_hashtbl_resize(struct eh_hashtbl *hashtbl){
-    /* 扩容 */
-    unsigned int old_size = hashtbl->mask + 1;
-    unsigned int new_mask = (hashtbl->mask << 1) + 1;
-    unsigned int i;
-    struct eh_list_head *new_table = eh_malloc(sizeof(struct eh_list_head) * (new_mask + 1));
-    if(new_table == NULL)
-        return EH_RET_MALLOC_ERROR;
-    
-    /* 新的后一半表项应该设置为待重建，所以设置为0 */
-    memset(new_table + old_size, 0, sizeof(struct eh_list_head) * old_size);
-
-    /* 前一半应该继承以前的表项 */
-    for(i = 0; i < old_size; i++){
-        /* 以前重建的依旧拷贝为重建 */
-        if(eh_hash_table_node_is_need_remake(hashtbl, i)){
-            new_table[i].next = NULL;
-            continue;
-        }
-        eh_list_head_init(&new_table[i]);
-        eh_list_splice(&hashtbl->table[i], &new_table[i]);
+/* 从迁移游标处向后检查最多budget个旧桶，已经按需迁移过的桶也计入预算 */
+static void eh_hashtbl_migrate_step(struct eh_hashtbl *hashtbl, unsigned int budget){
+    while(budget-- && hashtbl->old_table){
+        if(!eh_hashtbl_bucket_is_migrated(hashtbl->old_table, hashtbl->migrate_idx))
+            eh_hashtbl_migrate_bucket(hashtbl, hashtbl->migrate_idx);
+        if(hashtbl->migrate_idx++ == hashtbl->old_mask)
+            eh_hashtbl_migrate_done(hashtbl);
     }
+}
 
+static void eh_hashtbl_migrate_finish(struct eh_hashtbl *hashtbl){
+    eh_hashtbl_migrate_step(hashtbl, UINT_MAX);
+}
 
-    eh_free(hashtbl->table);
+/* 开始迁移到new_mask+1大小的散列表，只分配内存，搬移由之后的操作分摊 */
+static int eh_hashtbl_resize(struct eh_hashtbl *hashtbl, unsigned int new_mask){
+    struct eh_list_head *new_table;
+
+    /* 上一轮迁移还没完成时先完成，每次操作迁移的桶数足够时不会发生 */
+    eh_hashtbl_migrate_finish(hashtbl);
+    new_table = eh_malloc(sizeof(struct eh_list_head) * ((size_t)new_mask + 1));
+    if(new_table == NULL)
+        return EH_RET_MALLOC_ERROR;
+    if(new_mask > hashtbl->mask)
+        hashtbl->threshold <<= 1;
+    else
+        hashtbl->threshold >>= 1;
+    hashtbl->old_table = hashtbl->table;
+    hashtbl->old_mask = hashtbl->mask;
+    hashtbl->migrate_idx = 0;
     hashtbl->table = new_table;
     hashtbl->mask = new_mask;
-    hashtbl->threshold = hashtbl->threshold << 1;
     return EH_RET_OK;
 }
 
-static void eh_hashtbl_try_remake(struct eh_hashtbl *hashtbl, unsigned int idx){
-    /* 哈希渐进式重建 */
+/* 元素个数降到扩容阈值的1/4以下时缩小一半，缩小后负载仍低于阈值的一半，避免在边界上反复扩缩 */
+static void eh_hashtbl_try_shrink(struct eh_hashtbl *hashtbl){
+    if( hashtbl->mask + 1 > EH_CONFIG_HASHTBL_MIN_SIZE && hashtbl->count < hashtbl->threshold / 4 )
+        eh_hashtbl_resize(hashtbl, hashtbl->mask >> 1);
+}
+
+/**
+ * 插入和查找访问hash_val所在的桶之前调用，保证它在当前散列表中的桶已经就绪，并推进迁移，
+ * 删除节点时不在这里缩容，遍历中删除节点不会换掉正在遍历的散列表
+ */
+static void eh_hashtbl_prepare_bucket(struct eh_hashtbl *hashtbl, eh_hash_val_t hash_val){
     unsigned int old_idx;
-    struct eh_list_head *pos, *n;
-    if(eh_hash_table_node_is_need_remake(hashtbl, idx)){
-        unsigned int mask_tmp = hashtbl->mask >> 1;
-        for( mask_tmp = hashtbl->mask >> 1; 
-             mask_tmp && eh_hash_table_node_is_need_remake(hashtbl, (idx & mask_tmp));
-             mask_tmp = mask_tmp >> 1){
-            /* find ... */
-        }
-        old_idx = idx & mask_tmp;
-        /* 用旧的 table node 进行重建 */
-        eh_list_for_each_safe(pos, n, &hashtbl->table[old_idx]){
-            struct eh_hashtbl_node *node = eh_list_entry(pos, struct eh_hashtbl_node, node);
-            unsigned int new_idx = node->hash_val & hashtbl->mask;
-            if(new_idx != old_idx){
-                eh_list_del(pos);
-                if(eh_hash_table_node_is_need_remake(hashtbl, new_idx))
-                    eh_list_head_init(hashtbl->table+new_idx);
-                eh_list_add(pos, hashtbl->table+new_idx);
-            }
-        }
-        if(eh_hash_table_node_is_need_remake(hashtbl, idx))
-            eh_list_head_init(hashtbl->table+idx);
+    if(hashtbl->old_table == NULL){
+        eh_hashtbl_try_shrink(hashtbl);
+        if(hashtbl->old_table == NULL)
+            return ;
     }
+    old_idx = hash_val & hashtbl->old_mask;
+    if(!eh_hashtbl_bucket_is_migrated(hashtbl->old_table, old_idx))
+        eh_hashtbl_migrate_bucket(hashtbl, old_idx);
+    eh_hashtbl_migrate_step(hashtbl, EH_CONFIG_HASHTBL_REHASH_STEP);
 }
 
+int eh_hashtbl_rehash_step(eh_hashtbl_t _hashtbl, unsigned int budget){
+    struct eh_hashtbl *hashtbl = (struct eh_hashtbl *)_hashtbl;
+    eh_hashtbl_migrate_step(hashtbl, budget);
+    return hashtbl->old_table != NULL;
+}
+
+int eh_hashtbl_shrink(eh_hashtbl_t _hashtbl){
+    struct eh_hashtbl *hashtbl = (struct eh_hashtbl *)_hashtbl;
+    int ret;
+    eh_hashtbl_migrate_finish(hashtbl);
+    while(hashtbl->mask + 1 > EH_CONFIG_HASHTBL_MIN_SIZE && hashtbl->count + 1 < hashtbl->threshold / 2){
+        ret = eh_hashtbl_resize(hashtbl, hashtbl->mask >> 1);
+        if(ret < 0)
+            return ret;
+        eh_hashtbl_migrate_finish(hashtbl);
+    }
+    return EH_RET_OK;
+}
 
 struct eh_hashtbl_node* eh_hashtbl_node_new(eh_hashtbl_kv_len_t key_len, eh_hashtbl_kv_len_t value_len){
     struct eh_hashtbl_node *node = eh_malloc(sizeof(struct eh_hashtbl_node) + 
@@ -124,9 +165,9 @@ struct eh_hashtbl_node* eh_hashtbl_node_new(eh_hashtbl_kv_len_t key_len, eh_hash
     return node;
 }
 
-struct eh_hashtbl_node* eh_hashtbl_node_new_refresh(eh_hashtbl_t hashtbl, 
+struct eh_hashtbl_node* eh_hashtbl_node_new_refresh(eh_hashtbl_t _hashtbl, 
         const void *key, eh_hashtbl_kv_len_t key_len, eh_hashtbl_kv_len_t value_len){
-    (void)hashtbl;
+    struct eh_hashtbl *hashtbl = (struct eh_hashtbl *)_hashtbl;
     struct eh_hashtbl_node *node = eh_malloc(sizeof(struct eh_hashtbl_node) + 
         eh_align_up(key_len, EH_HASHTBL_KV_ALIGN) +  eh_align_up(value_len, EH_HASHTBL_KV_ALIGN));
     if(node == NULL)
@@ -134,17 +175,17 @@ struct eh_hashtbl_node* eh_hashtbl_node_new_refresh(eh_hashtbl_t hashtbl,
     memcpy(node->kv, key, key_len);
     node->value_len = value_len;
     node->key_len = key_len;
-    node->hash_val = eh_hash_val(key, key_len);
+    node->hash_val = eh_hash_val(hashtbl, key, key_len);
     eh_list_head_init(&node->node);
     return node;
 }
 
 
-struct eh_hashtbl_node* eh_hashtbl_node_new_with_string_refresh(eh_hashtbl_t hashtbl, 
+struct eh_hashtbl_node* eh_hashtbl_node_new_with_string_refresh(eh_hashtbl_t _hashtbl, 
     const char *key, eh_hashtbl_kv_len_t value_len){
-    (void)hashtbl;
+    struct eh_hashtbl *hashtbl = (struct eh_hashtbl *)_hashtbl;
     eh_hashtbl_kv_len_t key_len;
-    eh_hash_val_t hash_val = eh_hash_str_val(key, &key_len);
+    eh_hash_val_t hash_val = eh_hash_str_val(hashtbl, key, &key_len);
     struct eh_hashtbl_node *node = eh_malloc(sizeof(struct eh_hashtbl_node) + 
         eh_align_up(key_len, EH_HASHTBL_KV_ALIGN) +  eh_align_up(value_len, EH_HASHTBL_KV_ALIGN));
     if(node == NULL)
@@ -162,32 +203,35 @@ struct eh_hashtbl_node* eh_hashtbl_node_renew(eh_hashtbl_t hashtbl,
     struct eh_hashtbl_node* old_node, eh_hashtbl_kv_len_t value_len){
     (void)hashtbl;
     struct eh_hashtbl_node *node;
+    struct eh_list_head *prev = NULL;
     if(old_node->value_len == value_len)
         return old_node;
-    node = eh_malloc(sizeof(struct eh_hashtbl_node) + 
+    /* 节点可能被搬走，先从哈希表上摘下，记住插入位置 */
+    if(!eh_list_empty(&old_node->node)){
+        prev = old_node->node.prev;
+        eh_list_del(&old_node->node);
+    }
+    node = eh_realloc(old_node, sizeof(struct eh_hashtbl_node) + 
         eh_align_up(old_node->key_len, EH_HASHTBL_KV_ALIGN) + eh_align_up(value_len, EH_HASHTBL_KV_ALIGN));
-    if(node == NULL)
+    if(node == NULL){
+        if(prev)
+            eh_list_add(&old_node->node, prev);
         return NULL;
+    }
     node->value_len = value_len;
-    node->key_len = old_node->key_len;
-    node->hash_val = old_node->hash_val;
-    memcpy(node->kv, old_node->kv, old_node->key_len);
-    /* 检查旧节点是否挂在哈希表上 */
-    if(!eh_list_empty(&old_node->node)){
-        eh_list_add(&node->node, &old_node->node);
-        eh_list_del(&old_node->node);
-    }else{
+    if(prev)
+        eh_list_add(&node->node, prev);
+    else
         eh_list_head_init(&node->node);
-    }
-    eh_free(old_node);
     return node;
 }
 
 void eh_hashtbl_node_key_refresh(eh_hashtbl_t _hashtbl, struct eh_hashtbl_node* node){
     struct eh_hashtbl *hashtbl = (struct eh_hashtbl *)_hashtbl;
     unsigned int idx;
-    node->hash_val = eh_hash_val((const char *)node->kv, node->key_len);
+    node->hash_val = eh_hash_val(hashtbl, node->kv, node->key_len);
     if(eh_hashtbl_node_is_insert(node)){
+        eh_hashtbl_prepare_bucket(hashtbl, node->hash_val);
         idx = node->hash_val & hashtbl->mask;
         eh_list_del(&node->node);
         eh_list_add(&node->node, hashtbl->table + idx);
@@ -210,16 +254,13 @@ int eh_hashtbl_insert(eh_hashtbl_t _hashtbl, struct eh_hashtbl_node *node){
     unsigned int idx;
     if(eh_hashtbl_node_is_insert(node))
         return EH_RET_EXISTS;
-    if(hashtbl->count + 1 >= hashtbl->threshold && hashtbl->mask != UINT32_MAX){
-        ret = eh_hashtbl_resize(hashtbl);
+    if(hashtbl->count + 1 >= hashtbl->threshold && hashtbl->mask < (UINT_MAX >> 1)){
+        ret = eh_hashtbl_resize(hashtbl, (hashtbl->mask << 1) + 1);
         if(ret != EH_RET_OK)
             return ret;
     }
+    eh_hashtbl_prepare_bucket(hashtbl, node->hash_val);
     idx = node->hash_val & hashtbl->mask;
-
-    /* 尝试进行重建 */
-    eh_hashtbl_try_remake(hashtbl, idx);
-
     eh_list_add(&node->node, hashtbl->table + idx);
     hashtbl->count++;
     return EH_RET_OK;
@@ -236,31 +277,27 @@ void eh_hashtbl_remove(eh_hashtbl_t _hashtbl, struct eh_hashtbl_node *node){
 
 struct eh_list_head *_eh_hashtbl_find_list_head(eh_hashtbl_t _hashtbl, const void *key, eh_hashtbl_kv_len_t key_len){
     struct eh_hashtbl *hashtbl = (struct eh_hashtbl *)_hashtbl;
-    unsigned int idx = eh_hash_val(key, key_len) & hashtbl->mask;
-    /* 尝试进行重建 */
-    eh_hashtbl_try_remake(hashtbl, idx);
-    return &hashtbl->table[idx];
+    eh_hash_val_t hash_val = eh_hash_val(hashtbl, key, key_len);
+    eh_hashtbl_prepare_bucket(hashtbl, hash_val);
+    return &hashtbl->table[hash_val & hashtbl->mask];
 
 }
 
 struct eh_list_head *_eh_hashtbl_find_list_head_with_string(eh_hashtbl_t _hashtbl, const char *key_str){
     struct eh_hashtbl *hashtbl = (struct eh_hashtbl *)_hashtbl;
     eh_hashtbl_kv_len_t key_len;
-    unsigned int idx = eh_hash_str_val(key_str, &key_len) & hashtbl->mask;
-    /* 尝试进行重建 */
-    eh_hashtbl_try_remake(hashtbl, idx);
-    return &hashtbl->table[idx];
+    eh_hash_val_t hash_val = eh_hash_str_val(hashtbl, key_str, &key_len);
+    eh_hashtbl_prepare_bucket(hashtbl, hash_val);
+    return &hashtbl->table[hash_val & hashtbl->mask];
 }
 
 int eh_hashtbl_find(eh_hashtbl_t _hashtbl, const void *key, eh_hashtbl_kv_len_t key_len, struct eh_hashtbl_node **out_node){
     struct eh_hashtbl *hashtbl = (struct eh_hashtbl *)_hashtbl;
-    unsigned int idx = eh_hash_val(key, key_len) & hashtbl->mask;
+    eh_hash_val_t hash_val = eh_hash_val(hashtbl, key, key_len);
     struct eh_list_head *pos;
 
-    /* 尝试进行重建 */
-    eh_hashtbl_try_remake(hashtbl, idx);
-
-    eh_list_for_each(pos, &hashtbl->table[idx]){
+    eh_hashtbl_prepare_bucket(hashtbl, hash_val);
+    eh_list_for_each(pos, &hashtbl->table[hash_val & hashtbl->mask]){
         struct eh_hashtbl_node *node = eh_list_entry(pos, struct eh_hashtbl_node, node);
         if(node->key_len == key_len && memcmp(node->kv, key, key_len) == 0){
             if(out_node)
@@ -275,13 +312,11 @@ int eh_hashtbl_find(eh_hashtbl_t _hashtbl, const void *key, eh_hashtbl_kv_len_t
 int eh_hashtbl_find_with_string(eh_hashtbl_t _hashtbl, const char *key_str, struct eh_hashtbl_node **out_node){
     struct eh_hashtbl *hashtbl = (struct eh_hashtbl *)_hashtbl;
     eh_hashtbl_kv_len_t key_len;
-    unsigned int idx = eh_hash_str_val(key_str, &key_len) & hashtbl->mask;
+    eh_hash_val_t hash_val = eh_hash_str_val(hashtbl, key_str, &key_len);
     struct eh_list_head *pos;
 
-    /* 尝试进行重建 */
-    eh_hashtbl_try_remake(hashtbl, idx);
-
-    eh_list_for_each(pos, &hashtbl->table[idx]){
+    eh_hashtbl_prepare_bucket(hashtbl, hash_val);
+    eh_list_for_each(pos, &hashtbl->table[hash_val & hashtbl->mask]){
         struct eh_hashtbl_node *node = eh_list_entry(pos, struct eh_hashtbl_node, node);
         if(node->key_len == key_len && memcmp(node->kv, key_str, key_len) == 0){
             *out_node = node;
@@ -293,6 +328,10 @@ int eh_hashtbl_find_with_string(eh_hashtbl_t _hashtbl, const char *key_str, stru
 
 
 eh_hashtbl_t eh_hashtbl_create(float load_factor){
+    return eh_hashtbl_create_with_hash(load_factor, NULL, 0);
+}
+
+eh_hashtbl_t eh_hashtbl_create_with_hash(float load_factor, const struct eh_hashtbl_hash_ops *hash_ops, uint64_t seed){
     struct eh_hashtbl *hashtbl;
     eh_hashtbl_t ret;
     if(load_factor <= 0.0f)
@@ -305,6 +344,11 @@ eh_hashtbl_t eh_hashtbl_create(float load_factor){
     hashtbl->mask = EH_CONFIG_HASHTBL_MIN_SIZE - 1;
     hashtbl->threshold = (unsigned int)(EH_CONFIG_HASHTBL_MIN_SIZE * load_factor);
     hashtbl->count = 0;
+    hashtbl->old_table = NULL;
+    hashtbl->old_mask = 0;
+    hashtbl->migrate_idx = 0;
+    hashtbl->hash_ops = hash_ops ? hash_ops : &eh_hashtbl_hash_wy;
+    hashtbl->seed = seed;
     hashtbl->table = eh_malloc(sizeof(struct eh_list_head) * EH_CONFIG_HASHTBL_MIN_SIZE);
     if(hashtbl->table == NULL){
         ret = eh_error_to_ptr(EH_RET_MALLOC_ERROR);
@@ -321,10 +365,9 @@ table_malloc_error:
 
 extern void eh_hashtbl_destroy(eh_hashtbl_t _hashtbl){
     struct eh_hashtbl *hashtbl = (struct eh_hashtbl *)_hashtbl;
+    eh_hashtbl_migrate_finish(hashtbl);
     for(unsigned int i = 0; i <= hashtbl->mask; i++){
         struct eh_list_head *pos, *n;
-        if(eh_hash_table_node_is_need_remake(hashtbl, i))
-            continue;
         eh_list_for_each_safe(pos, n, &hashtbl->table[i]){
             struct eh_hashtbl_node *node = eh_list_entry(pos, struct eh_hashtbl_node, node);
             eh_list_del(pos);
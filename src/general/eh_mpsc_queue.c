@@ -0,0 +1,177 @@
+/**
+ * @file eh_mpsc_queue.c
+ * @brief 多生产者单消费者无锁队列
+ *        有界队列每个槽位的序号seq: 等于pos时可供第pos次入队使用，等于pos+1时数据已写完可供出队，
+ *        出队后设为pos+容量留给下一圈，生产者只在抢占enqueue_pos时竞争
+ *        无界队列为带哨兵节点的侵入式链表，生产者交换tail后再把旧tail的next指向自己，
+ *        消费者从head沿next前进，哨兵被取走时重新入队一次哨兵
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <eh_atomic.h>
+#include <eh_types.h>
+#include <eh_error.h>
+#include <eh_mem.h>
+#include "eh_mpsc_queue.h"
+
+struct eh_mpsc_queue{
+    uint32_t                    enqueue_pos eh_aligned(EH_MPSC_QUEUE_CACHE_LINE);
+    uint32_t                    dequeue_pos eh_aligned(EH_MPSC_QUEUE_CACHE_LINE);
+    uint32_t                    mask;
+    uint32_t                    elem_size;
+    uint32_t                    cell_size;
+    uint8_t                     *cells;
+};
+
+struct eh_mpsc_queue_cell{
+    uint32_t                    seq;
+    uint8_t                     data[];
+};
+
+#define eh_mpsc_queue_cell(queue, pos)      \
+    ((struct eh_mpsc_queue_cell *)((queue)->cells + (size_t)((pos) & (queue)->mask) * (queue)->cell_size))
+
+eh_mpsc_queue_t* eh_mpsc_queue_create(size_t elem_size, uint32_t capacity){
+    eh_mpsc_queue_t *queue;
+    size_t cell_size, head_size;
+    uint32_t cap = 2;
+
+    if(elem_size == 0 || elem_size > UINT16_MAX || capacity == 0 || capacity > 0x40000000U)
+        return eh_error_to_ptr(EH_RET_INVALID_PARAM);
+    while(cap < capacity)
+        cap <<= 1;
+    cell_size = eh_align_up(sizeof(struct eh_mpsc_queue_cell) + elem_size, sizeof(uint32_t));
+    head_size = eh_align_up(sizeof(eh_mpsc_queue_t), (size_t)EH_MPSC_QUEUE_CACHE_LINE);
+    queue = eh_malloc_aligned(EH_MPSC_QUEUE_CACHE_LINE, head_size + cell_size * cap);
+    if(queue == NULL)
+        return eh_error_to_ptr(EH_RET_MALLOC_ERROR);
+    queue->enqueue_pos = 0;
+    queue->dequeue_pos = 0;
+    queue->mask = cap - 1;
+    queue->elem_size = (uint32_t)elem_size;
+    queue->cell_size = (uint32_t)cell_size;
+    queue->cells = (uint8_t *)queue + head_size;
+    for(uint32_t i = 0; i < cap; i++)
+        eh_mpsc_queue_cell(queue, i)->seq = i;
+    return queue;
+}
+
+void eh_mpsc_queue_destroy(eh_mpsc_queue_t *queue){
+    eh_free(queue);
+}
+
+int eh_mpsc_queue_push(eh_mpsc_queue_t *queue, const void *elem){
+    struct eh_mpsc_queue_cell *cell;
+    uint32_t pos, seq;
+    int32_t diff;
+
+    pos = eh_atomic_load_explicit(&queue->enqueue_pos, eh_memory_order_relaxed);
+    for(;;){
+        cell = eh_mpsc_queue_cell(queue, pos);
+        seq = eh_atomic_load_explicit(&cell->seq, eh_memory_order_acquire);
+        diff = (int32_t)(seq - pos);
+        if(diff == 0){
+            if(eh_atomic_compare_exchange_weak_explicit(&queue->enqueue_pos, &pos, pos + 1,
+                eh_memory_order_relaxed, eh_memory_order_relaxed))
+                break;
+            /* 失败时pos已被更新为最新值 */
+        }else if(diff < 0){
+            /* 槽位还是上一圈的，消费者没跟上 */
+            return EH_RET_BUSY;
+        }else{
+            pos = eh_atomic_load_explicit(&queue->enqueue_pos, eh_memory_order_relaxed);
+        }
+    }
+    memcpy(cell->data, elem, queue->elem_size);
+    eh_atomic_store_explicit(&cell->seq, pos + 1, eh_memory_order_release);
+    return 0;
+}
+
+uint32_t eh_mpsc_queue_pop_batch(eh_mpsc_queue_t *queue, void *elems, uint32_t max){
+    struct eh_mpsc_queue_cell *cell;
+    uint8_t *out = (uint8_t *)elems;
+    uint32_t pos = queue->dequeue_pos;
+    uint32_t n;
+
+    for(n = 0; n < max; n++, pos++){
+        cell = eh_mpsc_queue_cell(queue, pos);
+        if(eh_atomic_load_explicit(&cell->seq, eh_memory_order_acquire) != pos + 1)
+            break;
+        memcpy(out, cell->data, queue->elem_size);
+        out += queue->elem_size;
+        eh_atomic_store_explicit(&cell->seq, pos + queue->mask + 1, eh_memory_order_release);
+    }
+    queue->dequeue_pos = pos;
+    return n;
+}
+
+bool eh_mpsc_queue_empty(eh_mpsc_queue_t *queue){
+    uint32_t pos = queue->dequeue_pos;
+    return eh_atomic_load_explicit(&eh_mpsc_queue_cell(queue, pos)->seq, eh_memory_order_acquire) != pos + 1;
+}
+
+uint32_t eh_mpsc_queue_capacity(eh_mpsc_queue_t *queue){
+    return queue->mask + 1;
+}
+
+void eh_mpsc_list_init(struct eh_mpsc_list *list){
+    list->stub.next = NULL;
+    list->head = &list->stub;
+    list->tail = &list->stub;
+}
+
+void eh_mpsc_list_push(struct eh_mpsc_list *list, struct eh_llist_node *node){
+    struct eh_llist_node *prev;
+    eh_atomic_store_explicit(&node->next, NULL, eh_memory_order_relaxed);
+    prev = eh_atomic_exchange_explicit(&list->tail, node, eh_memory_order_acq_rel);
+    /* 从交换到这里之间node对消费者不可见 */
+    eh_atomic_store_explicit(&prev->next, node, eh_memory_order_release);
+}
+
+struct eh_llist_node* eh_mpsc_list_pop(struct eh_mpsc_list *list){
+    struct eh_llist_node *head = list->head;
+    struct eh_llist_node *next = eh_atomic_load_explicit(&head->next, eh_memory_order_acquire);
+
+    if(head == &list->stub){
+        if(next == NULL)
+            return NULL;
+        /* 跳过哨兵 */
+        list->head = next;
+        head = next;
+        next = eh_atomic_load_explicit(&head->next, eh_memory_order_acquire);
+    }
+    if(next){
+        list->head = next;
+        return head;
+    }
+    if(head != eh_atomic_load_explicit(&list->tail, eh_memory_order_acquire))
+        return NULL;
+    /* head是最后一个节点，放回哨兵后才能把它取走 */
+    eh_mpsc_list_push(list, &list->stub);
+    next = eh_atomic_load_explicit(&head->next, eh_memory_order_acquire);
+    if(next){
+        list->head = next;
+        return head;
+    }
+    return NULL;
+}
+
+uint32_t eh_mpsc_list_pop_batch(struct eh_mpsc_list *list, struct eh_llist_head *out, uint32_t max){
+    struct eh_llist_node *node;
+    uint32_t n;
+    for(n = 0; n < max && (node = eh_mpsc_list_pop(list)) != NULL; n++)
+        eh_llist_enqueue(node, out);
+    return n;
+}
+
+bool eh_mpsc_list_empty(struct eh_mpsc_list *list){
+    struct eh_llist_node *head = list->head;
+    return head == &list->stub && eh_atomic_load_explicit(&head->next, eh_memory_order_acquire) == NULL;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file eh_msgring.c
+ * @brief 变长记录环形缓冲区，读写指针都是自由增长的字节偏移，缓冲区大小为2的幂，下标用掩码计算，
+ *        记录头部的len最高位为1时表示填充记录，读者直接跳过，头部和数据的可见性顺序与 eh_ringbuf 相同，
+ *        写者写完数据后经release屏障再推进w，读者读到w后经acquire屏障再访问数据
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <eh_atomic.h>
+#include <eh_types.h>
+#include <eh_error.h>
+#include <eh_mem.h>
+#include "eh_msgring.h"
+
+#define EH_MSGRING_ALIGN                8U
+#define EH_MSGRING_PAD_FLAG             0x80000000U
+
+struct eh_msgring_hdr{
+    uint32_t len;
+    uint32_t resv;
+};
+
+eh_static_assert(sizeof(struct eh_msgring_hdr) == EH_MSGRING_HDR_SIZE, "eh_msgring_hdr size mismatch");
+
+#define eh_msgring_hdr(msgring, pos)        \
+    ((struct eh_msgring_hdr *)((msgring)->buf + ((pos) & ((msgring)->size - 1))))
+#define eh_msgring_record_size(len)         eh_align_up((len) + EH_MSGRING_HDR_SIZE, EH_MSGRING_ALIGN)
+
+eh_msgring_t* eh_msgring_create(uint32_t size, uint8_t *static_buf_or_null){
+    eh_msgring_t* msgring;
+    if(size < 64 || (size & (size - 1)) || size > 0x40000000U)
+        return eh_error_to_ptr(EH_RET_INVALID_PARAM);
+    if(static_buf_or_null && ((uintptr_t)static_buf_or_null & (EH_MSGRING_ALIGN - 1)))
+        return eh_error_to_ptr(EH_RET_INVALID_PARAM);
+    if(static_buf_or_null == NULL){
+        msgring = eh_malloc(eh_align_up(sizeof(eh_msgring_t), (size_t)EH_MSGRING_ALIGN) + size);
+        static_buf_or_null = (uint8_t*)msgring + eh_align_up(sizeof(eh_msgring_t), (size_t)EH_MSGRING_ALIGN);
+    }else{
+        msgring = eh_malloc(sizeof(eh_msgring_t));
+    }
+    if(msgring == NULL)
+        return eh_error_to_ptr(EH_RET_MALLOC_ERROR);
+    msgring->buf = static_buf_or_null;
+    msgring->r = msgring->w = 0;
+    msgring->size = size;
+    msgring->reserved_pad = 0;
+    msgring->reserved_len = UINT32_MAX;
+    return msgring;
+}
+
+void eh_msgring_destroy(eh_msgring_t *msgring){
+    eh_free(msgring);
+}
+
+void* eh_msgring_reserve(eh_msgring_t *msgring, uint32_t len){
+    uint32_t w = msgring->w;
+    uint32_t free_size, need, tail, pad = 0;
+
+    if(len > eh_msgring_max_len(msgring))
+        return NULL;
+    free_size = msgring->size - (w - eh_atomic_load_explicit(&msgring->r, eh_memory_order_relaxed));
+    need = eh_msgring_record_size(len);
+    tail = msgring->size - (w & (msgring->size - 1));
+    if(need > tail)
+        pad = tail;
+    if(pad + need > free_size)
+        return NULL;
+    /* 读者释放空间之前对数据的访问必须先于之后的写入 */
+    eh_memory_order_acquire_barrier();
+    msgring->reserved_pad = pad;
+    msgring->reserved_len = len;
+    return eh_msgring_hdr(msgring, w + pad) + 1;
+}
+
+int eh_msgring_commit(eh_msgring_t *msgring, uint32_t len){
+    uint32_t w = msgring->w;
+    uint32_t pad = msgring->reserved_pad;
+    /* 超过预留长度会越过 reserve 没有检查过的空间，覆盖未读的记录 */
+    eh_param_assert(msgring->reserved_len != UINT32_MAX && len <= msgring->reserved_len);
+    msgring->reserved_len = UINT32_MAX;
+    if(pad)
+        eh_msgring_hdr(msgring, w)->len = EH_MSGRING_PAD_FLAG | pad;
+    eh_msgring_hdr(msgring, w + pad)->len = len;
+    eh_memory_order_release_barrier();
+    msgring->w = w + pad + eh_msgring_record_size(len);
+    return EH_RET_OK;
+}
+
+int eh_msgring_write(eh_msgring_t *msgring, const void *data, uint32_t len){
+    void *record;
+    if(len > eh_msgring_max_len(msgring))
+        return EH_RET_INVALID_PARAM;
+    record = eh_msgring_reserve(msgring, len);
+    if(record == NULL)
+        return EH_RET_BUSY;
+    memcpy(record, data, len);
+    return eh_msgring_commit(msgring, len);
+}
+
+const void* eh_msgring_peek(eh_msgring_t *msgring, uint32_t *len){
+    struct eh_msgring_hdr *hdr;
+    uint32_t r = msgring->r;
+
+    for(;;){
+        if(r == eh_atomic_load_explicit(&msgring->w, eh_memory_order_relaxed))
+            return NULL;
+        /* 与写者提交时的release屏障配对，保证看到完整的记录 */
+        eh_memory_order_acquire_barrier();
+        hdr = eh_msgring_hdr(msgring, r);
+        if(!(hdr->len & EH_MSGRING_PAD_FLAG))
+            break;
+        r += hdr->len & ~EH_MSGRING_PAD_FLAG;
+        eh_memory_order_release_barrier();
+        msgring->r = r;
+    }
+    *len = hdr->len;
+    return hdr + 1;
+}
+
+void eh_msgring_release(eh_msgring_t *msgring){
+    uint32_t r = msgring->r;
+    uint32_t len = eh_msgring_hdr(msgring, r)->len;
+    eh_memory_order_release_barrier();
+    msgring->r = r + eh_msgring_record_size(len);
+}
+
+bool eh_msgring_empty(eh_msgring_t *msgring){
+    uint32_t len;
+    return eh_msgring_peek(msgring, &len) == NULL;
+}
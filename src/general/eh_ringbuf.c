@@ -18,7 +18,16 @@
 #include "eh_ringbuf.h"
 
 
-#define eh_ringbuf_fix(ringbuf, pos)            ((pos)%((uint32_t)(ringbuf->size << 1)))
+/* 2的幂大小时读写指针自由增长，依靠uint32_t自然回绕，不需要取模 */
+#define eh_ringbuf_is_pow2(ringbuf)             ((ringbuf)->flags & EH_RINGBUF_FLAGS_POW2)
+#define eh_ringbuf_fix(ringbuf, pos)            \
+    (eh_ringbuf_is_pow2(ringbuf) ? (pos) : (pos)%((uint32_t)((ringbuf)->size << 1)))
+/* 读写指针转换为缓冲区下标 */
+#define eh_ringbuf_index(ringbuf, pos)          \
+    (eh_ringbuf_is_pow2(ringbuf) ? (pos) & ((uint32_t)(ringbuf)->size - 1) : (pos)%(uint32_t)(ringbuf)->size)
+/* 从缓冲区下标pos开始不绕回最多能访问的长度，镜像映射时总能访问整个缓冲区 */
+#define eh_ringbuf_first_max(ringbuf, pos)      \
+    (((ringbuf)->flags & EH_RINGBUF_FLAGS_MIRRORED) ? (ringbuf)->size : (ringbuf)->size - (int32_t)(pos))
 
 eh_ringbuf_t* eh_ringbuf_create(int32_t size, uint8_t *static_buf_or_null){
     eh_ringbuf_t* ringbuf;
@@ -35,6 +44,7 @@ eh_ringbuf_t* eh_ringbuf_create(int32_t size, uint8_t *static_buf_or_null){
     ringbuf->buf = static_buf_or_null;
     ringbuf->r = ringbuf->w = 0;
     ringbuf->size = size;
+    ringbuf->flags = (size & (size - 1)) == 0 ? EH_RINGBUF_FLAGS_POW2 : 0;
     return ringbuf;
 }
 
@@ -46,6 +56,8 @@ int32_t eh_ringbuf_size(eh_ringbuf_t *ringbuf){
     uint32_t w = ringbuf->w;
     uint32_t r = ringbuf->r;
     int32_t diff = (int)(w - r);
+    if(eh_ringbuf_is_pow2(ringbuf))
+        return diff;
     return diff >=0 ? diff : (ringbuf->size << 1) + diff;
 }
 
@@ -53,6 +65,8 @@ int32_t eh_ringbuf_free_size(eh_ringbuf_t *ringbuf){
     uint32_t w = ringbuf->w;
     uint32_t r = ringbuf->r;
     int32_t diff = (int)(w - r);
+    if(eh_ringbuf_is_pow2(ringbuf))
+        return ringbuf->size - diff;
     return diff >=0 ? ringbuf->size - diff : (- (ringbuf->size + diff));
 }
 
@@ -63,8 +77,8 @@ int32_t eh_ringbuf_write(eh_ringbuf_t *ringbuf, const uint8_t *buf, int32_t len)
     int32_t write_size_first_max,wl;
     wl = len > free_size ? free_size : len;
     if(wl <= 0) return 0;
-    w = ringbuf->w % (uint32_t)ringbuf->size;
-    write_size_first_max = ringbuf->size - (int32_t)w;
+    w = eh_ringbuf_index(ringbuf, ringbuf->w);
+    write_size_first_max = eh_ringbuf_first_max(ringbuf, w);
     if(wl <= write_size_first_max){
         memcpy(ringbuf->buf + w, buf, (size_t)wl);
     }else{
@@ -83,8 +97,8 @@ int32_t eh_ringbuf_draft_write(eh_ringbuf_t *ringbuf, int32_t offset, const uint
     int32_t write_size_first_max,wl;
     wl = len > free_size ? free_size : len;
     if(wl <= 0) return 0;
-    w = (ringbuf->w + (uint32_t)offset) % (uint32_t)ringbuf->size;
-    write_size_first_max = ringbuf->size - (int32_t)w;
+    w = eh_ringbuf_index(ringbuf, ringbuf->w + (uint32_t)offset);
+    write_size_first_max = eh_ringbuf_first_max(ringbuf, w);
     
     if(wl <= write_size_first_max){
         memcpy(ringbuf->buf + w, buf, (size_t)wl);
@@ -112,8 +126,8 @@ int32_t eh_ringbuf_read(eh_ringbuf_t *ringbuf, uint8_t *buf, int32_t len){
     int32_t read_size_first_max, rl;
     rl = len > size ? size : len;
     if(rl <= 0) return 0;
-    r = ringbuf->r % (uint32_t)ringbuf->size;
-    read_size_first_max = ringbuf->size - (int32_t)r;
+    r = eh_ringbuf_index(ringbuf, ringbuf->r);
+    read_size_first_max = eh_ringbuf_first_max(ringbuf, r);
     if(rl <= read_size_first_max){
         memcpy(buf, ringbuf->buf + r, (size_t)rl);
     }else{
@@ -148,8 +162,8 @@ const uint8_t* eh_ringbuf_peek(eh_ringbuf_t *ringbuf, int32_t offset, uint8_t *b
     size = eh_ringbuf_size(ringbuf) - offset;
     rl = *len;
     if(size < rl ) return NULL; /* 数量不足，禁止偷看 */
-    r = (ringbuf->r + (uint32_t)offset)%(uint32_t)ringbuf->size;
-    read_size_first_max = ringbuf->size - (int32_t)r;
+    r = eh_ringbuf_index(ringbuf, ringbuf->r + (uint32_t)offset);
+    read_size_first_max = eh_ringbuf_first_max(ringbuf, r);
 
     if(rl <= read_size_first_max){
         /* 0拷贝情况，皆大欢喜 */
@@ -174,8 +188,8 @@ int32_t eh_ringbuf_peek_copy(eh_ringbuf_t *ringbuf, int32_t offset, uint8_t *buf
     size = eh_ringbuf_size(ringbuf) - offset;
     rl = len;
     if(size < rl ) return 0; /* 数量不足，禁止偷看 */
-    r = (ringbuf->r + (uint32_t)offset)%(uint32_t)ringbuf->size;
-    read_size_first_max = ringbuf->size - (int32_t)r;
+    r = eh_ringbuf_index(ringbuf, ringbuf->r + (uint32_t)offset);
+    read_size_first_max = eh_ringbuf_first_max(ringbuf, r);
 
     if(rl <= read_size_first_max){
         memcpy(buf, ringbuf->buf + r, (size_t)rl);
@@ -186,6 +200,99 @@ int32_t eh_ringbuf_peek_copy(eh_ringbuf_t *ringbuf, int32_t offset, uint8_t *buf
     return rl;
 }
 
+/* 将从pos开始的len字节拆成绕回前后两段 */
+static inline void eh_ringbuf_span(eh_ringbuf_t *ringbuf, uint32_t pos, int32_t len, struct eh_ringbuf_iovec vec[2]){
+    int32_t first_max;
+    pos = eh_ringbuf_index(ringbuf, pos);
+    first_max = eh_ringbuf_first_max(ringbuf, pos);
+    vec[0].base = ringbuf->buf + pos;
+    vec[0].len = len > first_max ? first_max : len;
+    vec[1].base = ringbuf->buf;
+    vec[1].len = len - vec[0].len;
+}
+
+int32_t eh_ringbuf_write_reserve(eh_ringbuf_t *ringbuf, struct eh_ringbuf_iovec vec[2], int32_t len){
+    int32_t free_size = eh_ringbuf_free_size(ringbuf);
+    int32_t wl;
+    wl = len > free_size ? free_size : len;
+    if(wl < 0) wl = 0;
+    /* 读者释放空间之前对数据的访问必须先于之后的写入 */
+    eh_memory_order_acquire_barrier();
+    eh_ringbuf_span(ringbuf, ringbuf->w, wl, vec);
+    return wl;
+}
+
+int32_t eh_ringbuf_write_commit(eh_ringbuf_t *ringbuf, int32_t len){
+    return eh_ringbuf_write_skip(ringbuf, len);
+}
+
+int32_t eh_ringbuf_read_acquire(eh_ringbuf_t *ringbuf, struct eh_ringbuf_iovec vec[2], int32_t len){
+    int32_t size = eh_ringbuf_size(ringbuf);
+    int32_t rl;
+    rl = len > size ? size : len;
+    if(rl < 0) rl = 0;
+    /* 与写者提交时的release屏障配对，保证看到完整的数据 */
+    eh_memory_order_acquire_barrier();
+    eh_ringbuf_span(ringbuf, ringbuf->r, rl, vec);
+    return rl;
+}
+
+int32_t eh_ringbuf_read_release(eh_ringbuf_t *ringbuf, int32_t len){
+    return eh_ringbuf_read_skip(ringbuf, len);
+}
+
+int32_t eh_ringbuf_writev(eh_ringbuf_t *ringbuf, const struct eh_ringbuf_iovec *iov, int iovcnt){
+    uint32_t w;
+    int32_t free_size = eh_ringbuf_free_size(ringbuf);
+    int32_t write_size_first_max, wl, n;
+    /* 读者释放空间之前对数据的访问必须先于之后的写入 */
+    eh_memory_order_acquire_barrier();
+    w = ringbuf->w;
+    for(wl = 0; iovcnt > 0 && wl < free_size; iov++, iovcnt--){
+        if(iov->len <= 0) continue;
+        n = iov->len > free_size - wl ? free_size - wl : iov->len;
+        write_size_first_max = eh_ringbuf_first_max(ringbuf, eh_ringbuf_index(ringbuf, w));
+        if(n <= write_size_first_max){
+            memcpy(ringbuf->buf + eh_ringbuf_index(ringbuf, w), iov->base, (size_t)n);
+        }else{
+            memcpy(ringbuf->buf + eh_ringbuf_index(ringbuf, w), iov->base, (size_t)write_size_first_max);
+            memcpy(ringbuf->buf, iov->base + write_size_first_max, (size_t)(n - write_size_first_max));
+        }
+        w += (uint32_t)n;
+        wl += n;
+    }
+    if(wl == 0) return 0;
+    eh_memory_order_release_barrier();
+    ringbuf->w = eh_ringbuf_fix(ringbuf, w);
+    return wl;
+}
+
+int32_t eh_ringbuf_readv(eh_ringbuf_t *ringbuf, const struct eh_ringbuf_iovec *iov, int iovcnt){
+    uint32_t r;
+    int32_t size = eh_ringbuf_size(ringbuf);
+    int32_t read_size_first_max, rl, n;
+    /* 与写者提交时的release屏障配对，保证看到完整的数据 */
+    eh_memory_order_acquire_barrier();
+    r = ringbuf->r;
+    for(rl = 0; iovcnt > 0 && rl < size; iov++, iovcnt--){
+        if(iov->len <= 0) continue;
+        n = iov->len > size - rl ? size - rl : iov->len;
+        read_size_first_max = eh_ringbuf_first_max(ringbuf, eh_ringbuf_index(ringbuf, r));
+        if(n <= read_size_first_max){
+            memcpy(iov->base, ringbuf->buf + eh_ringbuf_index(ringbuf, r), (size_t)n);
+        }else{
+            memcpy(iov->base, ringbuf->buf + eh_ringbuf_index(ringbuf, r), (size_t)read_size_first_max);
+            memcpy(iov->base + read_size_first_max, ringbuf->buf, (size_t)(n - read_size_first_max));
+        }
+        r += (uint32_t)n;
+        rl += n;
+    }
+    if(rl == 0) return 0;
+    eh_memory_order_release_barrier();
+    ringbuf->r = eh_ringbuf_fix(ringbuf, r);
+    return rl;
+}
+
 void eh_ringbuf_clear(eh_ringbuf_t *ringbuf){
     eh_memory_order_release_barrier();
     ringbuf->r = ringbuf->w;
@@ -0,0 +1,92 @@
+/**
+ * @file eh_flat_hashtbl.h
+ * @brief 开放寻址哈希表(Swiss table)，键和值定长且直接存放在槽位数组中，另有一个控制字节数组记录每个槽位的状态
+ *        和哈希值的高7位，查找时一次比较16个控制字节(SSE2或逐字节)，只有控制字节匹配的槽位才比较键，
+ *        相比 eh_hashtbl 插入不需要单独分配节点，查找不需要追链表指针
+ *        使用限制: 插入可能触发扩容搬移槽位，之前返回的值指针随之失效；变长的键可以在键中存放指针，由调用者比较
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+#ifndef _EH_FLAT_HASHTBL_H_
+#define _EH_FLAT_HASHTBL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int* eh_flat_hashtbl_t;
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C"{
+#endif
+#endif /* __cplusplus */
+
+/**
+ * @brief                   创建开放寻址哈希表
+ * @param  key_size         键长度，按字节比较
+ * @param  value_size       值长度，可以为0(集合)
+ * @param  capacity_hint    预计的元素个数，预先分配足够的槽位避免扩容，可以为0
+ * @return eh_flat_hashtbl_t    成功返回哈希表句柄，失败需使用eh_ptr_to_error转换为错误码
+ */
+extern eh_flat_hashtbl_t eh_flat_hashtbl_create(size_t key_size, size_t value_size, size_t capacity_hint);
+
+/**
+ * @brief                   销毁开放寻址哈希表
+ * @param  hashtbl          哈希表句柄
+ */
+extern void eh_flat_hashtbl_destroy(eh_flat_hashtbl_t hashtbl);
+
+/**
+ * @brief                   插入键值
+ * @param  hashtbl          哈希表句柄
+ * @param  key              键
+ * @param  value            值，为NULL时不初始化值，由调用者通过out_value填写
+ * @param  out_value        输出值所在的槽位，可以为NULL
+ * @return int              成功返回0，键已存在返回 EH_RET_EXISTS(不修改值，out_value指向已有的值)，
+ *                          扩容失败返回 EH_RET_MALLOC_ERROR
+ */
+extern int eh_flat_hashtbl_insert(eh_flat_hashtbl_t hashtbl, const void *key, const void *value, void **out_value);
+
+/**
+ * @brief                   查找键
+ * @param  hashtbl          哈希表句柄
+ * @param  key              键
+ * @return void*            值所在的槽位，不存在返回NULL
+ */
+extern void* eh_flat_hashtbl_find(eh_flat_hashtbl_t hashtbl, const void *key);
+
+/**
+ * @brief                   删除键
+ * @param  hashtbl          哈希表句柄
+ * @param  key              键
+ * @return int              成功返回0，不存在返回 EH_RET_NOT_EXISTS
+ */
+extern int eh_flat_hashtbl_erase(eh_flat_hashtbl_t hashtbl, const void *key);
+
+/**
+ * @brief                   获取元素个数
+ * @param  hashtbl          哈希表句柄
+ * @return size_t
+ */
+extern size_t eh_flat_hashtbl_count(eh_flat_hashtbl_t hashtbl);
+
+/**
+ * @brief                   遍历哈希表，iter初始化为0，遍历过程中不能插入，可以删除当前元素
+ * @param  hashtbl          哈希表句柄
+ * @param  iter             遍历位置
+ * @param  out_key          输出键，可以为NULL
+ * @return void*            值所在的槽位，遍历结束返回NULL
+ */
+extern void* eh_flat_hashtbl_next(eh_flat_hashtbl_t hashtbl, size_t *iter, const void **out_key);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
+
+
+#endif // _EH_FLAT_HASHTBL_H_
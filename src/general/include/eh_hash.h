@@ -0,0 +1,62 @@
+/**
+ * @file eh_hash.h
+ * @brief 哈希函数，供 eh_hashtbl 和 eh_flat_hashtbl 使用，
+ *        eh_hash_wy 参考wyhash/xxh3的思路一次处理16字节，尾部不足8字节时按字节读取，不要求键对齐，
+ *        eh_hash_wy_str 先用strlen求长度再计算，结果与 eh_hash_wy(str, strlen(str)) 相同，
+ *        seed不为0时哈希值依赖seed，用随机seed可以防止外部构造大量冲突的键
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+#ifndef _EH_HASH_H_
+#define _EH_HASH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t eh_hash_val_t;
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C"{
+#endif
+#endif /* __cplusplus */
+
+/**
+ * @brief                   计算二进制键的哈希值
+ * @param  key              键，不要求对齐
+ * @param  len              键长度
+ * @param  seed             种子
+ * @return eh_hash_val_t
+ */
+extern eh_hash_val_t eh_hash_wy(const void *key, size_t len, uint64_t seed);
+
+/**
+ * @brief                   计算字符串的哈希值，同时得到字符串长度，结果与 eh_hash_wy(str, strlen(str), seed) 相同
+ * @param  str              字符串
+ * @param  out_len          输出字符串长度，可以为NULL
+ * @param  seed             种子
+ * @return eh_hash_val_t
+ */
+extern eh_hash_val_t eh_hash_wy_str(const char *str, size_t *out_len, uint64_t seed);
+
+/**
+ * @brief                   FNV-1a，逐字节计算，seed与初始值异或
+ */
+extern eh_hash_val_t eh_hash_fnv1a(const void *key, size_t len, uint64_t seed);
+
+/**
+ * @brief                   FNV-1a字符串版本，结果与 eh_hash_fnv1a(str, strlen(str), seed) 相同
+ */
+extern eh_hash_val_t eh_hash_fnv1a_str(const char *str, size_t *out_len, uint64_t seed);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
+
+
+#endif // _EH_HASH_H_
@@ -16,10 +16,10 @@
 #include <eh_error.h>
 #include <eh_types.h>
 #include <eh_list.h>
+#include <eh_hash.h>
 
 typedef uint16_t eh_hashtbl_kv_len_t;
 typedef int*    eh_hashtbl_t;
-typedef uint32_t eh_hash_val_t;
 #define EH_HASHTBL_DEFAULT_LOADFACTOR   0.75
 
 #ifdef __cplusplus
@@ -37,21 +37,34 @@ struct eh_hashtbl_node{
     uint8_t   eh_aligned(EH_HASHTBL_KV_ALIGN)   kv[0];
 };
 
+/* 哈希函数，hash_str的结果必须与 hash(str, strlen(str), seed) 相同 */
+struct eh_hashtbl_hash_ops{
+    eh_hash_val_t (*hash)(const void *key, size_t len, uint64_t seed);
+    eh_hash_val_t (*hash_str)(const char *str, size_t *out_len, uint64_t seed);
+};
+
 struct eh_hashtbl{
     struct eh_list_head                         *table;                 /* 散列表 */
+    struct eh_list_head                         *old_table;             /* 扩缩容时正在迁出的旧散列表，没有迁移时为NULL */
     unsigned int                                mask;                   /* 散列表大小减1,散列表大小永远为2的次幂 */
-    unsigned int                                threshold;              /* 阈值,达到该值时自动扩容 */
+    unsigned int                                old_mask;               /* 旧散列表大小减1 */
+    unsigned int                                migrate_idx;            /* 旧散列表中下一个待迁移的桶 */
+    unsigned int                                threshold;              /* 阈值,达到该值时自动扩容,低于其1/4时自动缩容 */
     unsigned int                                count;                  /* 元素个数 */
+    const struct eh_hashtbl_hash_ops            *hash_ops;
+    uint64_t                                    seed;
 };
 
+/* 默认哈希函数 eh_hash_wy，一次处理8字节 */
+extern const struct eh_hashtbl_hash_ops eh_hashtbl_hash_wy;
+/* 逐字节的FNV-1a */
+extern const struct eh_hashtbl_hash_ops eh_hashtbl_hash_fnv1a;
+
 
 
 extern struct eh_list_head *_eh_hashtbl_find_list_head(eh_hashtbl_t hashtbl, const void *key, eh_hashtbl_kv_len_t key_len);
 extern struct eh_list_head *_eh_hashtbl_find_list_head_with_string(eh_hashtbl_t hashtbl, const char *key_str);
 
-/* 判断哈希表节点是否需要重建*/
-#define eh_hash_table_node_is_need_remake(hashtbl, idx)  ((hashtbl)->table[idx].next == NULL)
-
 /**
  * @brief                   创建哈希表
  * @param  load_factor       负载因子
@@ -59,12 +72,38 @@ extern struct eh_list_head *_eh_hashtbl_find_list_head_with_string(eh_hashtbl_t
  */
 extern eh_hashtbl_t eh_hashtbl_create(float load_factor);
 
+/**
+ * @brief                   创建哈希表并指定哈希函数和种子，键可能来自外部时应使用随机种子，防止构造大量冲突的键
+ * @param  load_factor      负载因子
+ * @param  hash_ops         哈希函数，为NULL时使用 eh_hashtbl_hash_wy
+ * @param  seed             种子
+ * @return eh_hashtbl_t     成功返回哈希表句柄，失败需使用eh_ptr_to_error转换为错误码
+ */
+extern eh_hashtbl_t eh_hashtbl_create_with_hash(float load_factor, const struct eh_hashtbl_hash_ops *hash_ops, uint64_t seed);
+
 /**
  * @brief                   销毁哈希表
  * @param  hashtbl          哈希表句柄
  */
 extern void eh_hashtbl_destroy(eh_hashtbl_t hashtbl);
 
+/**
+ * @brief                   推进扩缩容的迁移，扩缩容时只分配新散列表，旧散列表中的桶由之后每次插入/查找
+ *                          迁移 EH_CONFIG_HASHTBL_REHASH_STEP 个，空闲时可以调用本函数提前完成迁移
+ * @param  hashtbl          哈希表句柄
+ * @param  budget           最多检查的旧桶个数
+ * @return int              仍在迁移返回1，没有迁移返回0
+ */
+extern int eh_hashtbl_rehash_step(eh_hashtbl_t hashtbl, unsigned int budget);
+
+/**
+ * @brief                   立即把散列表缩小到能容纳当前元素的最小大小，并完成迁移，
+ *                          元素个数低于阈值的1/4时插入/查找也会自动开始渐进的缩小一半
+ * @param  hashtbl          哈希表句柄
+ * @return int              成功返回0，失败返回错误码
+ */
+extern int eh_hashtbl_shrink(eh_hashtbl_t hashtbl);
+
 /**
  * @brief                   创建哈希表节点, 调用该函数后需要手动赋值key，
  *                          然后调用 eh_hashtbl_node_key_refresh 进行刷新，最后在插入哈希表
@@ -193,7 +232,7 @@ extern int eh_hashtbl_find(eh_hashtbl_t hashtbl, const void *key, eh_hashtbl_kv_
 extern int eh_hashtbl_find_with_string(eh_hashtbl_t hashtbl, const char *key_str, struct eh_hashtbl_node **out_node);
 
 /**
- * @brief                   遍历哈希表
+ * @brief                   遍历哈希表，开始时先完成未完成的迁移，遍历过程中可以删除节点，不能插入或查找
  * @param  hashtbl          哈希表句柄
  * @param  node_pos         节点位置
  * @param  node_tmp_n       临时变量
@@ -206,13 +245,13 @@ extern int eh_hashtbl_find_with_string(eh_hashtbl_t hashtbl, const char *key_str
                 eh_same_type(hashtbl, eh_hashtbl_t),                                                            \
                 "hashtbl must be eh_hashtbl_t"                                                                  \
             );                                                                                                  \
+            eh_hashtbl_rehash_step(hashtbl, ~0U);                                                               \
             tmp_uint_i = 0;                                                                                     \
         });                                                                                                     \
         tmp_uint_i <= ((struct eh_hashtbl*)(hashtbl))->mask;                                                    \
         tmp_uint_i++)                                                                                           \
-        if(!eh_hash_table_node_is_need_remake(((struct eh_hashtbl*)(hashtbl)), tmp_uint_i))                     \
-            eh_list_for_each_entry_safe(node_pos, node_tmp_n,                                                   \
-                ((struct eh_hashtbl*)(hashtbl))->table + tmp_uint_i, node)
+        eh_list_for_each_entry_safe(node_pos, node_tmp_n,                                                       \
+            ((struct eh_hashtbl*)(hashtbl))->table + tmp_uint_i, node)
 
 /**
  * @brief                   遍历哈希表,键为字符串
@@ -0,0 +1,142 @@
+/**
+ * @file eh_mpsc_queue.h
+ * @brief 多生产者单消费者无锁队列，多个线程或中断向同一个事件循环投递数据时不需要进入临界区
+ *        eh_mpsc_queue: 有界队列，定长元素按值拷贝进预先分配的环形数组，每个槽位带序号，
+ *                       生产者用CAS抢占槽位(无锁)，消费者按序号判断槽位是否写完，可以一次取出一批
+ *        eh_mpsc_list:  无界侵入式队列，节点为 eh_llist_node，生产者只需一次原子交换(无等待)，
+ *                       不分配内存，消费者逐个或成批取出到普通的 eh_llist_head
+ *        使用限制: 出队接口同一时刻只能由一个消费者调用
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#ifndef _EH_MPSC_QUEUE_H_
+#define _EH_MPSC_QUEUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <eh_types.h>
+#include <eh_llist.h>
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C"{
+#endif
+#endif /* __cplusplus */
+
+/* 生产者与消费者各自频繁修改的字段分开放在不同的缓存行，避免伪共享 */
+#define EH_MPSC_QUEUE_CACHE_LINE            64
+
+typedef struct eh_mpsc_queue eh_mpsc_queue_t;
+
+struct eh_mpsc_list{
+    struct eh_llist_node        *tail eh_aligned(EH_MPSC_QUEUE_CACHE_LINE);    /* 生产者交换的位置 */
+    struct eh_llist_node        *head eh_aligned(EH_MPSC_QUEUE_CACHE_LINE);    /* 消费者读取的位置 */
+    struct eh_llist_node        stub;
+};
+
+/**
+ * @brief                           创建有界多生产者单消费者队列
+ * @param  elem_size                元素大小
+ * @param  capacity                 容量，向上取整到2的幂
+ * @return eh_mpsc_queue_t*         返回值请使用eh_ptr_to_error来判断是否创建成功
+ */
+extern eh_mpsc_queue_t* eh_mpsc_queue_create(size_t elem_size, uint32_t capacity);
+
+/**
+ * @brief                           销毁队列，调用时不能再有生产者和消费者在使用
+ * @param  queue                    队列
+ */
+extern void eh_mpsc_queue_destroy(eh_mpsc_queue_t *queue);
+
+/**
+ * @brief                           入队一个元素，可在多个线程和中断中同时调用
+ * @param  queue                    队列
+ * @param  elem                     元素，按elem_size拷贝
+ * @return int                      成功返回0，队列满返回 EH_RET_BUSY
+ */
+extern __safety int eh_mpsc_queue_push(eh_mpsc_queue_t *queue, const void *elem);
+
+/**
+ * @brief                           出队最多max个元素，遇到尚未写完的槽位即停止，保持每个生产者的入队顺序
+ * @param  queue                    队列
+ * @param  elems                    输出缓冲区，至少能放下max个元素
+ * @param  max                      最多取出的个数
+ * @return uint32_t                 实际取出的个数，队列空时返回0
+ */
+extern uint32_t eh_mpsc_queue_pop_batch(eh_mpsc_queue_t *queue, void *elems, uint32_t max);
+
+/**
+ * @brief                           出队一个元素
+ * @param  queue                    队列
+ * @param  elem                     输出
+ * @return bool                     队列空时返回false
+ */
+static inline bool eh_mpsc_queue_pop(eh_mpsc_queue_t *queue, void *elem){
+    return eh_mpsc_queue_pop_batch(queue, elem, 1) == 1;
+}
+
+/**
+ * @brief                           队列是否为空，只能由消费者调用，结果只反映调用瞬间的状态
+ * @param  queue                    队列
+ * @return bool
+ */
+extern bool eh_mpsc_queue_empty(eh_mpsc_queue_t *queue);
+
+/**
+ * @brief                           获取队列容量
+ * @param  queue                    队列
+ * @return uint32_t
+ */
+extern uint32_t eh_mpsc_queue_capacity(eh_mpsc_queue_t *queue);
+
+/**
+ * @brief                           初始化无界侵入式队列，可以放在静态区或其他结构体中
+ * @param  list                     队列
+ */
+extern void eh_mpsc_list_init(struct eh_mpsc_list *list);
+
+/**
+ * @brief                           入队一个节点，一次原子交换完成，可在多个线程和中断中同时调用
+ * @param  list                     队列
+ * @param  node                     节点，入队到被取出之前不能修改
+ */
+extern __safety void eh_mpsc_list_push(struct eh_mpsc_list *list, struct eh_llist_node *node);
+
+/**
+ * @brief                           出队一个节点
+ *                                  生产者交换完尾指针但还没来得及链接节点时，后面的节点暂时不可见，
+ *                                  此时返回NULL，稍后(通常在生产者的通知到达后)重试即可
+ * @param  list                     队列
+ * @return struct eh_llist_node*    队列空或暂时不可见时返回NULL
+ */
+extern struct eh_llist_node* eh_mpsc_list_pop(struct eh_mpsc_list *list);
+
+/**
+ * @brief                           出队最多max个节点，按入队顺序追加到out尾部
+ * @param  list                     队列
+ * @param  out                      普通单链表，只由消费者使用
+ * @param  max                      最多取出的个数
+ * @return uint32_t                 实际取出的个数
+ */
+extern uint32_t eh_mpsc_list_pop_batch(struct eh_mpsc_list *list, struct eh_llist_head *out, uint32_t max);
+
+/**
+ * @brief                           队列是否为空，只能由消费者调用
+ * @param  list                     队列
+ * @return bool
+ */
+extern bool eh_mpsc_list_empty(struct eh_mpsc_list *list);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
+
+
+#endif // _EH_MPSC_QUEUE_H_
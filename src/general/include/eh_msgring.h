@@ -0,0 +1,114 @@
+/**
+ * @file eh_msgring.h
+ * @brief 变长记录环形缓冲区，单读单写无锁，每条记录带8字节头部且按8字节对齐，
+ *        写者 eh_msgring_reserve 得到一段连续的记录空间，尾部放不下时用填充记录跳到开头而不是拆成两段，
+ *        读者 eh_msgring_peek 直接拿到整条记录的指针，记录的编码和解析都不需要额外拷贝
+ *        使用限制: 与 eh_ringbuf 相同，reserve/commit 只能由一个写者调用，peek/release 只能由一个读者调用
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+#ifndef _EH_MSGRING_H_
+#define _EH_MSGRING_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C"{
+#endif
+#endif /* __cplusplus */
+
+#define EH_MSGRING_HDR_SIZE             8U
+
+typedef struct eh_msgring{
+    uint32_t w;                         /* 写者维护，自由增长 */
+    uint32_t r;                         /* 读者维护，自由增长 */
+    uint32_t size;
+    uint32_t reserved_pad;              /* 写者私有: 最近一次预留前需要的尾部填充长度 */
+    uint32_t reserved_len;              /* 写者私有: 最近一次预留的记录长度，没有未提交的预留时为UINT32_MAX */
+    uint8_t *buf;
+}eh_msgring_t;
+
+/**
+ * @brief                           创建变长记录环形缓冲区
+ * @param  size                     缓冲区大小，必须是2的幂且不小于64
+ * @param  static_buf_or_null       静态缓冲区指针，需按8字节对齐，如果为NULL则动态分配内存
+ * @return eh_msgring_t*            返回值请使用eh_ptr_to_error来判断是否创建成功
+ */
+extern eh_msgring_t* eh_msgring_create(uint32_t size, uint8_t *static_buf_or_null);
+
+/**
+ * @brief                           销毁变长记录环形缓冲区
+ * @param  msgring                  缓冲区指针
+ */
+extern void eh_msgring_destroy(eh_msgring_t *msgring);
+
+/**
+ * @brief                           单条记录长度的上限，不超过这个长度的记录在缓冲区读空后一定能够预留成功
+ * @param  msgring                  缓冲区指针
+ * @return uint32_t
+ */
+static inline uint32_t eh_msgring_max_len(eh_msgring_t *msgring){
+    return msgring->size / 2 - EH_MSGRING_HDR_SIZE;
+}
+
+/**
+ * @brief                           预留一条长度为len的记录，返回的空间总是连续的，
+ *                                  写完后调用 eh_msgring_commit 提交，提交之前读者看不到这条记录，
+ *                                  再次调用会覆盖之前未提交的预留
+ * @param  msgring                  缓冲区指针
+ * @param  len                      记录长度，不超过 eh_msgring_max_len
+ * @return void*                    按8字节对齐的记录空间，空间不足时返回NULL
+ */
+extern void* eh_msgring_reserve(eh_msgring_t *msgring, uint32_t len);
+
+/**
+ * @brief                           提交最近一次预留的记录
+ * @param  msgring                  缓冲区指针
+ * @param  len                      记录的实际长度，可以小于预留的长度，多出的部分还给缓冲区
+ * @return int                      成功返回0，没有未提交的预留或len超过预留的长度时返回EH_RET_INVALID_PARAM
+ */
+extern int eh_msgring_commit(eh_msgring_t *msgring, uint32_t len);
+
+/**
+ * @brief                           拷贝写入一条记录，等价于 reserve + memcpy + commit
+ * @param  msgring                  缓冲区指针
+ * @param  data                     记录内容
+ * @param  len                      记录长度
+ * @return int                      成功返回0，空间不足返回 EH_RET_BUSY，超过上限返回 EH_RET_INVALID_PARAM
+ */
+extern int eh_msgring_write(eh_msgring_t *msgring, const void *data, uint32_t len);
+
+/**
+ * @brief                           获取最早的一条记录(0拷贝)，处理完后调用 eh_msgring_release 释放
+ * @param  msgring                  缓冲区指针
+ * @param  len                      输出记录长度
+ * @return const void*              记录内容，没有记录时返回NULL
+ */
+extern const void* eh_msgring_peek(eh_msgring_t *msgring, uint32_t *len);
+
+/**
+ * @brief                           释放 eh_msgring_peek 返回的记录
+ * @param  msgring                  缓冲区指针
+ */
+extern void eh_msgring_release(eh_msgring_t *msgring);
+
+/**
+ * @brief                           是否没有可读的记录
+ * @param  msgring                  缓冲区指针
+ * @return bool
+ */
+extern bool eh_msgring_empty(eh_msgring_t *msgring);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
+
+
+#endif // _EH_MSGRING_H_
@@ -18,24 +18,37 @@ extern "C"{
 #endif
 #endif /* __cplusplus */
 
+/* buf之后紧跟着同一块物理内存的第二份映射，任意位置开始的size字节都是连续的 */
+#define EH_RINGBUF_FLAGS_MIRRORED       0x00000001U
+/* size为2的幂，读写指针自由增长，下标用掩码计算，创建时自动识别 */
+#define EH_RINGBUF_FLAGS_POW2           0x00000002U
+
 typedef struct eh_ringbuf{
     uint32_t w;
     uint32_t r;
     int32_t  size;
+    uint32_t flags;
     uint8_t *buf;
 }eh_ringbuf_t;
 
+/* 环形缓冲区中的一段连续内存，数据绕回时一次访问最多分成两段 */
+struct eh_ringbuf_iovec{
+    uint8_t *base;
+    int32_t  len;
+};
+
 /**
  * @brief                           创建环形缓冲区
  * @param  size                     环形缓冲区大小,要求在正数范围内，因为使用镜像法缓冲区
-                                    模块中所有的int32_t都是提醒使用者注意范围
+                                    模块中所有的int32_t都是提醒使用者注意范围，
+                                    为2的幂时读写路径只用掩码不做除法，对性能敏感的场景推荐使用
  * @param  static_buf_or_null       静态缓冲区指针，如果为NULL则动态分配内存
  * @return eh_ringbuf_t*            返回值请使用eh_ptr_to_error来判断是否创建成功
  */
 extern eh_ringbuf_t* eh_ringbuf_create(int32_t size, uint8_t *static_buf_or_null);
 
 /**
- * @brief                           销毁环形缓冲区
+ * @brief                           销毁环形缓冲区，镜像环形缓冲区请使用平台提供的 eh_ringbuf_destroy_mirrored
  * @param  ringbuf                  环形缓冲区指针
  */
 extern void eh_ringbuf_destroy(eh_ringbuf_t *ringbuf);
@@ -132,6 +145,61 @@ extern const uint8_t* eh_ringbuf_peek(eh_ringbuf_t *ringbuf, int32_t offset, uin
  */
 extern int32_t eh_ringbuf_peek_copy(eh_ringbuf_t *ringbuf, int32_t offset, uint8_t *buf, int32_t len);
 
+/**
+ * @brief                           预留可直接写入的空间(0拷贝)，返回最多两段连续内存，
+ *                                  写入者直接往里填数据(如DMA、read系统调用)，然后调用 eh_ringbuf_write_commit 提交，
+ *                                  提交之前读者看不到这些数据，预留不改变读写指针，可以重复预留
+ * @param  ringbuf                  环形缓冲区指针
+ * @param  vec                      输出两段内存，未使用的段len为0
+ * @param  len                      希望预留的最大长度
+ * @return int32_t                  返回实际预留的长度(两段之和)，缓冲区满时返回0
+ */
+extern int32_t eh_ringbuf_write_reserve(eh_ringbuf_t *ringbuf, struct eh_ringbuf_iovec vec[2], int32_t len);
+
+/**
+ * @brief                           提交已经写入预留空间的数据，len不应超过最近一次预留的长度
+ * @param  ringbuf                  环形缓冲区指针
+ * @param  len                      提交的长度
+ * @return int32_t                  返回提交成功的数量
+ */
+extern int32_t eh_ringbuf_write_commit(eh_ringbuf_t *ringbuf, int32_t len);
+
+/**
+ * @brief                           获取可直接读取的数据(0拷贝)，返回最多两段连续内存，
+ *                                  读者处理完后调用 eh_ringbuf_read_release 释放空间，释放之前写者不会覆盖这些数据
+ * @param  ringbuf                  环形缓冲区指针
+ * @param  vec                      输出两段内存，未使用的段len为0
+ * @param  len                      希望获取的最大长度
+ * @return int32_t                  返回实际获取的长度(两段之和)，缓冲区空时返回0
+ */
+extern int32_t eh_ringbuf_read_acquire(eh_ringbuf_t *ringbuf, struct eh_ringbuf_iovec vec[2], int32_t len);
+
+/**
+ * @brief                           释放已经读完的数据，len不应超过最近一次获取的长度
+ * @param  ringbuf                  环形缓冲区指针
+ * @param  len                      释放的长度
+ * @return int32_t                  返回释放成功的数量
+ */
+extern int32_t eh_ringbuf_read_release(eh_ringbuf_t *ringbuf, int32_t len);
+
+/**
+ * @brief                           把多段内存按顺序写入环形缓冲区(聚集)，只更新一次写指针，空间不足时只写入前面放得下的部分
+ * @param  ringbuf                  环形缓冲区指针
+ * @param  iov                      要写入的内存段
+ * @param  iovcnt                   内存段个数
+ * @return int32_t                  返回写入成功的数量
+ */
+extern int32_t eh_ringbuf_writev(eh_ringbuf_t *ringbuf, const struct eh_ringbuf_iovec *iov, int iovcnt);
+
+/**
+ * @brief                           从环形缓冲区读出数据依次填入多段内存(分散)，只更新一次读指针
+ * @param  ringbuf                  环形缓冲区指针
+ * @param  iov                      要读到的内存段
+ * @param  iovcnt                   内存段个数
+ * @return int32_t                  返回读到的数量
+ */
+extern int32_t eh_ringbuf_readv(eh_ringbuf_t *ringbuf, const struct eh_ringbuf_iovec *iov, int iovcnt);
+
 /**
  * @brief                           清空环形缓冲区(单读写安全)
  * @param  ringbuf                  环形缓冲区指针
@@ -0,0 +1,87 @@
+/**
+ * @file eh_arena.h
+ * @brief 区域(arena)分配器，适用于一次请求内大量生命周期相同的小块临时内存，
+ *        从 eh_malloc 申请的大块(chunk)中顺序切分，不支持单独释放，
+ *        通过 eh_arena_reset 一次性回收(O(1))，块保留下来供下一轮复用，
+ *        可以绑定到任务上，任务销毁时自动释放
+ *        使用限制: 同一个arena只能在一个协程上下文中使用，不可在中断或其他线程中调用
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#ifndef _EH_ARENA_H_
+#define _EH_ARENA_H_
+
+#include <stddef.h>
+#include <eh.h>
+
+typedef int* eh_arena_t;
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C"{
+#endif
+#endif /* __cplusplus */
+
+struct eh_arena_stat{
+    size_t                      chunk_cnt;              /* 当前持有的块数 */
+    size_t                      capacity;               /* 所有块的可用字节数之和 */
+    size_t                      used;                   /* 自上次reset以来已分配的字节数(含对齐填充) */
+    size_t                      high_water;             /* used的历史最大值 */
+    size_t                      alloc_cnt;              /* 自上次reset以来的分配次数 */
+};
+
+/**
+ * @brief                   创建arena，创建时不申请块
+ * @param  chunk_size       每次向堆申请的块大小，超过该大小的分配单独申请一个块
+ * @return eh_arena_t       成功返回arena句柄，失败返回可由 eh_ptr_to_error 判断的错误指针
+ */
+extern eh_arena_t eh_arena_create(size_t chunk_size);
+
+/**
+ * @brief                   销毁arena，释放所有块，若已绑定任务则同时解除绑定
+ * @param  arena            arena句柄
+ */
+extern void eh_arena_destroy(eh_arena_t arena);
+
+/**
+ * @brief                   从arena中分配内存，按两倍指针大小对齐
+ * @param  arena            arena句柄
+ * @param  size             大小
+ * @return void*            失败返回NULL
+ */
+extern void* eh_arena_alloc(eh_arena_t arena, size_t size);
+
+/**
+ * @brief                   回收arena中所有已分配的内存，之前分配的指针全部失效，块保留复用，O(1)
+ * @param  arena            arena句柄
+ */
+extern void eh_arena_reset(eh_arena_t arena);
+
+/**
+ * @brief                   将arena绑定到任务，任务销毁时(eh_task_join/eh_task_destroy/自动销毁)自动释放arena，
+ *                          一个arena只能绑定一个任务，重复绑定会解除之前的绑定
+ * @param  arena            arena句柄
+ * @param  task             任务句柄，为NULL时解除绑定
+ * @return int              成功返回0
+ */
+extern int eh_arena_bind_task(eh_arena_t arena, eh_task_t *task);
+
+/**
+ * @brief                   获取arena的统计信息
+ * @param  arena            arena句柄
+ * @param  stat             统计信息
+ */
+extern void eh_arena_get_stat(eh_arena_t arena, struct eh_arena_stat *stat);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
+
+
+#endif // _EH_ARENA_H_
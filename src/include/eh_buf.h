@@ -0,0 +1,207 @@
+/**
+ * @file eh_buf.h
+ * @brief 引用计数的零拷贝缓冲区，数据存放在共享的存储块中(来自 eh_buf_pool 或 eh_malloc)，
+ *        eh_buf_t 只是存储块上的一个视图(数据指针+长度)，切片和复制视图只增加引用计数不拷贝数据，
+ *        最后一个视图释放时存储块归还到内存池或堆，多个视图可以通过 eh_buf_chain 串起来做分散/聚集，
+ *        任务之间传递大块数据时只需要交出视图指针
+ *        使用限制: 存储块的引用计数是原子的，可以跨线程释放，单个视图和链同一时刻只能由一个持有者使用
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#ifndef _EH_BUF_H_
+#define _EH_BUF_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <eh_types.h>
+
+typedef int* eh_buf_pool_t;
+typedef struct eh_buf eh_buf_t;
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C"{
+#endif
+#endif /* __cplusplus */
+
+struct eh_buf_storage;
+
+struct eh_buf{
+    struct eh_buf_storage       *storage;
+    uint8_t                     *data;
+    size_t                      len;
+    struct eh_buf               *next;                  /* 所在链中的下一个视图 */
+};
+
+struct eh_buf_chain{
+    struct eh_buf               *head;
+    struct eh_buf               **tail;
+    size_t                      len;                    /* 链中所有视图的长度之和 */
+    size_t                      cnt;                    /* 链中的视图个数 */
+};
+
+struct eh_buf_pool_stat{
+    size_t                      buf_size;               /* 每个存储块的容量 */
+    size_t                      inuse_cnt;              /* 当前仍被引用的存储块数 */
+    size_t                      max_inuse_cnt;          /* inuse_cnt的历史最大值 */
+    size_t                      alloc_cnt;              /* 累计分配次数 */
+};
+
+/**
+ * @brief                   创建缓冲区内存池，存储块按需成批向堆申请，全部归还的批次会被释放
+ * @param  buf_size         每个存储块的容量
+ * @param  chunk_num        每批申请的存储块数量
+ * @return eh_buf_pool_t    成功返回内存池句柄，失败返回可由 eh_ptr_to_error 判断的错误指针
+ */
+extern eh_buf_pool_t eh_buf_pool_create(size_t buf_size, size_t chunk_num);
+
+/**
+ * @brief                   销毁缓冲区内存池，调用前所有来自该池的视图必须已经释放
+ * @param  pool             内存池句柄
+ */
+extern void eh_buf_pool_destroy(eh_buf_pool_t pool);
+
+/**
+ * @brief                   获取缓冲区内存池的统计信息
+ * @param  pool             内存池句柄
+ * @param  stat             统计信息
+ */
+extern void eh_buf_pool_get_stat(eh_buf_pool_t pool, struct eh_buf_pool_stat *stat);
+
+/**
+ * @brief                   从内存池申请一个存储块并返回覆盖整个存储块的视图
+ * @param  pool             内存池句柄
+ * @return eh_buf_t*        失败返回NULL
+ */
+extern __safety eh_buf_t* eh_buf_pool_alloc(eh_buf_pool_t pool);
+
+/**
+ * @brief                   用 eh_malloc 申请一个size大小的存储块并返回覆盖整个存储块的视图
+ * @param  size             大小
+ * @return eh_buf_t*        失败返回NULL
+ */
+extern __safety eh_buf_t* eh_buf_alloc(size_t size);
+
+/**
+ * @brief                   创建一个与buf共享存储块的切片，不拷贝数据
+ * @param  buf              视图
+ * @param  offset           相对buf数据起点的偏移
+ * @param  len              长度，offset+len不得超过buf的长度
+ * @return eh_buf_t*        失败返回NULL
+ */
+extern __safety eh_buf_t* eh_buf_slice(eh_buf_t *buf, size_t offset, size_t len);
+
+/**
+ * @brief                   复制视图，等价于 eh_buf_slice(buf, 0, buf->len)
+ * @param  buf              视图
+ * @return eh_buf_t*        失败返回NULL
+ */
+extern __safety eh_buf_t* eh_buf_ref(eh_buf_t *buf);
+
+/**
+ * @brief                   释放视图，存储块的最后一个视图释放时存储块归还到内存池或堆，buf为NULL时不做任何事情
+ * @param  buf              视图，不能仍在链中
+ */
+extern __safety void eh_buf_unref(eh_buf_t *buf);
+
+/**
+ * @brief                   存储块是否被多个视图共享，共享时修改数据会影响其他视图
+ * @param  buf              视图
+ * @return bool
+ */
+extern bool eh_buf_is_shared(const eh_buf_t *buf);
+
+/**
+ * @brief                   从视图头部去掉len字节，len超过视图长度时视图变为空
+ */
+static inline void eh_buf_pull(eh_buf_t *buf, size_t len){
+    len = len < buf->len ? len : buf->len;
+    buf->data += len;
+    buf->len -= len;
+}
+
+/**
+ * @brief                   将视图截短到len字节，len不小于视图长度时不变
+ */
+static inline void eh_buf_trim(eh_buf_t *buf, size_t len){
+    if(len < buf->len)
+        buf->len = len;
+}
+
+static inline uint8_t* eh_buf_data(const eh_buf_t *buf){
+    return buf->data;
+}
+
+static inline size_t eh_buf_len(const eh_buf_t *buf){
+    return buf->len;
+}
+
+/**
+ * @brief                   初始化一个空链，链可以放在调用者的栈上
+ * @param  chain            链
+ */
+static inline void eh_buf_chain_init(struct eh_buf_chain *chain){
+    chain->head = NULL;
+    chain->tail = &chain->head;
+    chain->len = 0;
+    chain->cnt = 0;
+}
+
+/**
+ * @brief                   把视图追加到链尾，视图的所有权转移给链
+ * @param  chain            链
+ * @param  buf              视图，不能已经在其他链中
+ */
+extern void eh_buf_chain_append(struct eh_buf_chain *chain, eh_buf_t *buf);
+
+/**
+ * @brief                   把src中的所有视图移到dst尾部，src变为空链
+ * @param  dst              目标链
+ * @param  src              源链
+ */
+extern void eh_buf_chain_splice(struct eh_buf_chain *dst, struct eh_buf_chain *src);
+
+/**
+ * @brief                   取下链头的视图，所有权交给调用者
+ * @param  chain            链
+ * @return eh_buf_t*        空链返回NULL
+ */
+extern eh_buf_t* eh_buf_chain_pop(struct eh_buf_chain *chain);
+
+/**
+ * @brief                   从链头消费len字节，完全消费掉的视图被释放，部分消费的视图原地调整
+ * @param  chain            链
+ * @param  len              长度，超过链长度时清空整个链
+ */
+extern __safety void eh_buf_chain_pull(struct eh_buf_chain *chain, size_t len);
+
+/**
+ * @brief                   从链中offset处开始拷贝数据(聚集)，用于需要连续内存的场景
+ * @param  chain            链
+ * @param  offset           偏移
+ * @param  dst              目标缓冲区
+ * @param  len              要拷贝的长度
+ * @return size_t           实际拷贝的长度
+ */
+extern size_t eh_buf_chain_copy_out(const struct eh_buf_chain *chain, size_t offset, void *dst, size_t len);
+
+/**
+ * @brief                   释放链中的所有视图，链变为空链
+ * @param  chain            链
+ */
+extern __safety void eh_buf_chain_clear(struct eh_buf_chain *chain);
+
+#define eh_buf_chain_for_each(pos, chain)     for(pos = (chain)->head; pos; pos = pos->next)
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
+
+
+#endif // _EH_BUF_H_
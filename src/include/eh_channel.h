@@ -0,0 +1,106 @@
+/**
+ * @file eh_channel.h
+ * @brief 任务间的定长元素通道，有界或无界，发送和接收在条件不满足时挂起当前任务并支持超时，
+ *        send_many/recv_many 每次唤醒可以搬运多个元素，
+ *        接收事件只在通道由空变为非空时通知，发送事件只在由满变为不满时通知，
+ *        流水线在高负载时每一批数据只产生一次通知和一次任务切换，而不是每个元素一次
+ *        此模块中带__async的函数只能在协程上下文中使用，eh_channel_try_send 可在中断和其他线程中调用
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#ifndef _EH_CHANNEL_H_
+#define _EH_CHANNEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <eh_types.h>
+
+typedef int* eh_channel_t;
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C"{
+#endif
+#endif /* __cplusplus */
+
+/**
+ * @brief                   创建通道
+ * @param  elem_size        元素大小
+ * @param  capacity         最多缓存的元素个数，为0时表示无界，缓冲区按需倍增
+ * @return eh_channel_t     成功返回通道句柄，失败返回可由 eh_ptr_to_error 判断的错误指针
+ */
+extern eh_channel_t eh_channel_create(size_t elem_size, uint32_t capacity);
+
+/**
+ * @brief                   销毁通道，调用前应保证没有任务还在等待该通道
+ * @param  channel          通道句柄
+ */
+extern void eh_channel_destroy(eh_channel_t channel);
+
+/**
+ * @brief                   关闭通道，之后的发送都失败，接收方取完剩余元素后再接收会失败，所有等待者都被唤醒
+ * @param  channel          通道句柄
+ */
+extern __safety void eh_channel_close(eh_channel_t channel);
+
+/**
+ * @brief                   发送多个元素，通道满时挂起等待，有空间后尽可能多地放入，不保证全部放入
+ * @param  channel          通道句柄
+ * @param  elems            元素数组
+ * @param  n                元素个数
+ * @param  timeout          最多等待时间，EH_TIME_FOREVER永不超时
+ * @return int              成功返回放入的元素个数(>0)，超时返回 EH_RET_TIMEOUT，
+ *                          通道已关闭返回 EH_RET_INVALID_STATE，无界通道扩容失败返回 EH_RET_MALLOC_ERROR
+ */
+extern int __async eh_channel_send_many(eh_channel_t channel, const void *elems, uint32_t n, eh_sclock_t timeout);
+
+/**
+ * @brief                   接收多个元素，通道空时挂起等待，有数据后尽可能多地取出
+ * @param  channel          通道句柄
+ * @param  elems            输出数组，至少能放下max个元素
+ * @param  max              最多取出的元素个数
+ * @param  timeout          最多等待时间，EH_TIME_FOREVER永不超时
+ * @return int              成功返回取出的元素个数(>0)，超时返回 EH_RET_TIMEOUT，
+ *                          通道已关闭且为空返回 EH_RET_INVALID_STATE
+ */
+extern int __async eh_channel_recv_many(eh_channel_t channel, void *elems, uint32_t max, eh_sclock_t timeout);
+
+/**
+ * @brief                   发送一个元素
+ * @return int              成功返回0，其他同 eh_channel_send_many
+ */
+extern int __async eh_channel_send(eh_channel_t channel, const void *elem, eh_sclock_t timeout);
+
+/**
+ * @brief                   接收一个元素
+ * @return int              成功返回0，其他同 eh_channel_recv_many
+ */
+extern int __async eh_channel_recv(eh_channel_t channel, void *elem, eh_sclock_t timeout);
+
+/**
+ * @brief                   不等待地发送一个元素
+ * @param  channel          通道句柄
+ * @param  elem             元素
+ * @return int              成功返回0，通道满返回 EH_RET_BUSY，其他同 eh_channel_send_many
+ */
+extern __safety int eh_channel_try_send(eh_channel_t channel, const void *elem);
+
+/**
+ * @brief                   获取通道中当前缓存的元素个数
+ * @param  channel          通道句柄
+ * @return uint32_t
+ */
+extern __safety uint32_t eh_channel_len(eh_channel_t channel);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
+
+
+#endif // _EH_CHANNEL_H_
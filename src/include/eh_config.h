@@ -68,6 +68,37 @@ extern unsigned long platform_get_clock_freq(void);
 #  ifndef EH_CONFIG_MEM_HEAP_SIZE
 #   define EH_CONFIG_MEM_HEAP_SIZE                               (8*1024U)
 #  endif /* EH_CONFIG_MEM_HEAP_SIZE */
+
+/**
+ *  EH_CONFIG_MEM_USE_TLSF为1时使用TLSF(两级分离适配)分配器，分配和释放均为O(1)，
+ *  为0时使用按地址排序的首次适配链表
+ *  EH_CONFIG_MEM_TLSF_SL_INDEX_COUNT_LOG2为每个一级区间内二级区间个数的log2，越大碎片越少，控制块越大
+ *  EH_CONFIG_MEM_TLSF_FL_INDEX_MAX为单个块最大大小的log2
+ */
+#  ifndef EH_CONFIG_MEM_USE_TLSF
+#   define EH_CONFIG_MEM_USE_TLSF                                0
+#  endif /* EH_CONFIG_MEM_USE_TLSF */
+
+#  ifdef CONFIG_EH_CONFIG_MEM_USE_TLSF
+#   undef EH_CONFIG_MEM_USE_TLSF
+#   define EH_CONFIG_MEM_USE_TLSF                                CONFIG_EH_CONFIG_MEM_USE_TLSF
+#  endif
+
+#  ifndef EH_CONFIG_MEM_TLSF_SL_INDEX_COUNT_LOG2
+#   if defined(EH_SYSTEM_IS_POPULAR)
+#    define EH_CONFIG_MEM_TLSF_SL_INDEX_COUNT_LOG2               5
+#   else
+#    define EH_CONFIG_MEM_TLSF_SL_INDEX_COUNT_LOG2               3
+#   endif
+#  endif /* EH_CONFIG_MEM_TLSF_SL_INDEX_COUNT_LOG2 */
+
+#  ifndef EH_CONFIG_MEM_TLSF_FL_INDEX_MAX
+#   if defined(EH_SYSTEM_IS_POPULAR)
+#    define EH_CONFIG_MEM_TLSF_FL_INDEX_MAX                      30
+#   else
+#    define EH_CONFIG_MEM_TLSF_FL_INDEX_MAX                      20
+#   endif
+#  endif /* EH_CONFIG_MEM_TLSF_FL_INDEX_MAX */
 #endif
 
 #  ifdef CONFIG_EH_CONFIG_MEM_HEAP_SIZE
@@ -158,6 +189,59 @@ extern unsigned long platform_get_clock_freq(void);
 #define EH_CONFIG_HASHTBL_MIN_SIZE                              16
 #endif /* EH_CONFIG_HASHTBL_MIN_SIZE */
 
+/*
+ *  哈希表扩缩容后每次插入/查找从旧散列表迁移的桶数，不小于2时能保证下一次扩容前迁移已经完成
+ */
+#ifndef EH_CONFIG_HASHTBL_REHASH_STEP
+#define EH_CONFIG_HASHTBL_REHASH_STEP                           4
+#endif /* EH_CONFIG_HASHTBL_REHASH_STEP */
+
+/*
+ *  EH_CONFIG_FLAT_HASHTBL_USE_SSE2为1且编译器开启了SSE2时，eh_flat_hashtbl 用SSE2一次比较16个控制字节，
+ *  否则逐字节比较
+ */
+#ifndef EH_CONFIG_FLAT_HASHTBL_USE_SSE2
+#define EH_CONFIG_FLAT_HASHTBL_USE_SSE2                         1
+#endif /* EH_CONFIG_FLAT_HASHTBL_USE_SSE2 */
+
+/*
+ *  EH_CONFIG_MEM_PROFILE为1时开启内存分配分析，eh_malloc按调用点(返回地址)统计分配次数、在用数量与字节数，
+ *  每次分配额外占用一个记录头，eh_global_exit时打印占用最多的调用点以及仍未释放的分配
+ *  EH_CONFIG_MEM_PROFILE_SITE_MAX为调用点表的大小，必须为2的幂，超出后的调用点统一记在一个溢出项中
+ */
+#ifndef EH_CONFIG_MEM_PROFILE
+#define EH_CONFIG_MEM_PROFILE                                   0
+#endif /* EH_CONFIG_MEM_PROFILE */
+
+#ifdef CONFIG_EH_CONFIG_MEM_PROFILE
+#undef EH_CONFIG_MEM_PROFILE
+#define EH_CONFIG_MEM_PROFILE                                   CONFIG_EH_CONFIG_MEM_PROFILE
+#endif
+
+#ifndef EH_CONFIG_MEM_PROFILE_SITE_MAX
+#if defined(EH_SYSTEM_IS_POPULAR)
+#define EH_CONFIG_MEM_PROFILE_SITE_MAX                          256
+#else
+#define EH_CONFIG_MEM_PROFILE_SITE_MAX                          32
+#endif
+#endif /* EH_CONFIG_MEM_PROFILE_SITE_MAX */
+
+/*
+ *  eh_slab 每次向堆申请的块(chunk)中包含的对象个数，对象用完后再申请新的块
+ */
+#ifndef EH_CONFIG_SLAB_CHUNK_OBJ_CNT
+#if defined(EH_SYSTEM_IS_POPULAR)
+#define EH_CONFIG_SLAB_CHUNK_OBJ_CNT                            32
+#else
+#define EH_CONFIG_SLAB_CHUNK_OBJ_CNT                            4
+#endif
+#endif /* EH_CONFIG_SLAB_CHUNK_OBJ_CNT */
+
+#ifdef CONFIG_EH_CONFIG_SLAB_CHUNK_OBJ_CNT
+#undef EH_CONFIG_SLAB_CHUNK_OBJ_CNT
+#define EH_CONFIG_SLAB_CHUNK_OBJ_CNT                            CONFIG_EH_CONFIG_SLAB_CHUNK_OBJ_CNT
+#endif
+
 #ifndef EH_CONFIG_EVENT_CB_DISPATCH_CNT_PER_YIELD
 #define EH_CONFIG_EVENT_CB_DISPATCH_CNT_PER_YIELD               4
 #endif
@@ -166,4 +250,53 @@ extern unsigned long platform_get_clock_freq(void);
 #define EH_CONFIG_EVENT_CB_DISPATCH_CNT_PER_CHECKTIMER          4
 #endif
 
+/*
+ *  阻塞调用卸载线程池(eh_offload)最大工作线程数，线程按需启动
+ */
+#ifndef EH_CONFIG_OFFLOAD_WORKER_MAX
+#define EH_CONFIG_OFFLOAD_WORKER_MAX                            4
+#endif /* EH_CONFIG_OFFLOAD_WORKER_MAX */
+
+/*
+ *  Linux平台eh_file是否尝试使用io_uring，关闭或内核不支持时使用eh_offload线程池
+ */
+#ifndef EH_CONFIG_FILE_USE_IO_URING
+#define EH_CONFIG_FILE_USE_IO_URING                             1
+#endif /* EH_CONFIG_FILE_USE_IO_URING */
+
+/*
+ *  eh_file io_uring提交队列深度
+ */
+#ifndef EH_CONFIG_FILE_URING_ENTRIES
+#define EH_CONFIG_FILE_URING_ENTRIES                            64
+#endif /* EH_CONFIG_FILE_URING_ENTRIES */
+
+/*
+ *  Linux平台eh_posix_signal单次从signalfd读取的最大信号数
+ */
+#ifndef EH_CONFIG_POSIX_SIGNAL_READ_BATCH
+#define EH_CONFIG_POSIX_SIGNAL_READ_BATCH                       16
+#endif /* EH_CONFIG_POSIX_SIGNAL_READ_BATCH */
+
+/*
+ *  Linux平台eh_prefork最大工作进程数
+ */
+#ifndef EH_CONFIG_PREFORK_WORKER_MAX
+#define EH_CONFIG_PREFORK_WORKER_MAX                            64
+#endif /* EH_CONFIG_PREFORK_WORKER_MAX */
+
+/*
+ *  Linux平台eh_hugeheap最多映射的区域数，每个区域占用一个堆id
+ */
+#ifndef EH_CONFIG_HUGEHEAP_REGION_MAX
+#define EH_CONFIG_HUGEHEAP_REGION_MAX                           4
+#endif /* EH_CONFIG_HUGEHEAP_REGION_MAX */
+
+/*
+ *  eh_hugeheap的2MiB块连续多少次eh_hugeheap_trim都完全空闲时归还内核
+ */
+#ifndef EH_CONFIG_HUGEHEAP_IDLE_TRIM_CNT
+#define EH_CONFIG_HUGEHEAP_IDLE_TRIM_CNT                        2
+#endif /* EH_CONFIG_HUGEHEAP_IDLE_TRIM_CNT */
+
 #endif // _EVENT_CONFIG_H_
\ No newline at end of file
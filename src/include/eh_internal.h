@@ -75,6 +75,7 @@ struct eh_task{
     eh_event_t                          event;                                      /* 任务相关事件，任务退出 */
     void                                *system_data;                               /* 系统数据 */
     void                                (*system_data_destruct_function)(eh_task_t*);    /* 系统数据销毁函数 */
+    struct eh_list_head                 arena_list_head;                            /* 绑定到本任务的arena，任务销毁时释放 */
     union{
 #define EH_TASK_FLAGS_INTERIOR_REQUEST_QUIT          0x80000000U
         uint32_t                        flags;
@@ -201,6 +202,12 @@ extern void __async eh_task_next(void);
  */
 extern void eh_task_wake_up(eh_task_t *wakeup_task);
 
+/**
+ * @brief                释放绑定到任务上的所有arena
+ * @param  task          任务
+ */
+extern void eh_arena_task_release(eh_task_t *task);
+
 
 #ifdef __cplusplus
 #if __cplusplus
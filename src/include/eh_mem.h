@@ -11,7 +11,9 @@
 #define _EH_MEM_H_
 
 #include <stddef.h>
+#include <stdint.h>
 #include <eh_types.h>
+#include <eh_config.h>
 
 #ifdef __cplusplus
 #if __cplusplus
@@ -19,33 +21,109 @@ extern "C"{
 #endif
 #endif /* __cplusplus */
 
+enum eh_mem_heap_flags{
+    EH_MEM_HEAP_FLAGS_EXCLUSIVE     = 0x00000001,       /* 专用堆，eh_malloc等不会从该堆分配，只能通过 eh_malloc_from 指定 */
+    EH_MEM_HEAP_FLAGS_NO_FALLBACK   = 0x00000002,       /* eh_malloc_from 从该堆分配失败时直接返回NULL，不回退到公共堆 */
+};
+
 struct eh_mem_heap {
     void  *heap_start;
     size_t heap_size;
+    uint32_t flags;                                     /* enum eh_mem_heap_flags */
 };
 
+/* 空闲块大小直方图，第i格统计大小在[2^(i+4), 2^(i+5))的空闲块，第0格包含更小的块，最后一格包含更大的块 */
+#define EH_MEM_FREE_HIST_SHIFT_MIN  4
+#define EH_MEM_FREE_HIST_BIN_CNT    20
+
 struct eh_mem_heap_info{
     size_t total_size;
     size_t free_size;
-    size_t min_ever_free_size_level;
+    size_t min_ever_free_size_level;                    /* 空闲大小的历史最低值，eh_mem_get_heap_info 中为各个堆各自最低值之和，
+                                                           多个堆的最低值出现在不同时刻，总和可能低于实际出现过的任何总空闲大小 */
+    size_t largest_free_block;                          /* 最大空闲块的可用大小，TLSF按区间向上取整查找，略小于它的请求也可能失败 */
+    size_t free_block_cnt;                              /* 空闲块数量 */
+    size_t free_hist[EH_MEM_FREE_HIST_BIN_CNT];         /* 按可用大小统计的空闲块直方图 */
 };
 
 extern __safety void* eh_malloc(size_t size);
 extern __safety void  eh_free(void* ptr);
 
 /**
- * @brief 
- * @param  heap            注册堆空间用于内存分配
- * @return int             成功返回0，失败返回负数错误码
+ * @brief                   分配nmemb*size字节并清零，乘法溢出时返回NULL
+ */
+extern __safety void* eh_calloc(size_t nmemb, size_t size);
+
+/**
+ * @brief                   调整已分配内存的大小，语义同libc realloc，
+ *                          内置堆在物理相邻的下一块空闲时原地扩展，缩小时原地拆分，均不拷贝
+ * @param  ptr              为NULL时等同于eh_malloc
+ * @param  size             为0时释放ptr并返回NULL
+ * @return void*            失败返回NULL，此时ptr保持不变
+ */
+extern __safety void* eh_realloc(void* ptr, size_t size);
+
+/**
+ * @brief                   按align对齐分配内存，用 eh_free 释放，对齐不会在 eh_realloc 后保留
+ * @param  align            对齐字节数，必须为2的幂
+ * @param  size             大小
+ * @return void*            失败返回NULL
+ */
+extern __safety void* eh_malloc_aligned(size_t align, size_t size);
+
+/**
+ * @brief                   从指定的堆分配内存，失败时除非该堆带有 EH_MEM_HEAP_FLAGS_NO_FALLBACK，
+ *                          否则回退到公共堆(非EH_MEM_HEAP_FLAGS_EXCLUSIVE的堆)，libc内存管理下heap_id被忽略
+ * @param  heap_id          eh_mem_heap_register 返回的堆id
+ * @param  size             大小
+ * @return void*            失败返回NULL
+ */
+extern __safety void* eh_malloc_from(int heap_id, size_t size);
+
+#if EH_CONFIG_MEM_PROFILE
+/* 分析模式下内存管理后端实现为 eh_mem_raw_*，eh_malloc/eh_free 等为 eh_mem_profile.c 中的包装 */
+extern __safety void* eh_mem_raw_malloc(size_t size);
+extern __safety void  eh_mem_raw_free(void* ptr);
+extern __safety void* eh_mem_raw_calloc(size_t nmemb, size_t size);
+extern __safety void* eh_mem_raw_realloc(void* ptr, size_t size);
+extern __safety void* eh_mem_raw_malloc_aligned(size_t align, size_t size);
+extern __safety void* eh_mem_raw_malloc_from(int heap_id, size_t size);
+#endif
+
+struct eh_mem_profile_site{
+    void                        *caller;                /* 调用eh_malloc处的返回地址，溢出项为NULL */
+    size_t                      alloc_cnt;              /* 累计分配次数 */
+    size_t                      fail_cnt;               /* 累计分配失败次数 */
+    size_t                      live_cnt;               /* 当前未释放的数量 */
+    size_t                      live_size;              /* 当前未释放的字节数 */
+    size_t                      peak_live_size;         /* 未释放字节数的历史最大值 */
+    size_t                      total_size;             /* 累计分配字节数 */
+};
+
+/**
+ * @brief                   注册堆空间用于内存分配，eh_global_init之前注册的堆在初始化时建立，之后注册的堆立即可用，
+ *                          EH_CONFIG_MEM_HEAP_SIZE不为0时内置堆的id为0
+ * @param  heap             堆空间
+ * @return int              成功返回堆id(>=0)，失败返回负数错误码
  */
 extern int eh_mem_heap_register(const struct eh_mem_heap *heap);
 
 /**
- * @brief                   获取堆信息
+ * @brief                   获取堆信息，碎片程度可以用 1 - largest_free_block/free_size 衡量，
+ *                          除largest_free_block外的统计都是增量维护的，首次适应分配器在最大空闲块被分配走后，
+ *                          下一次查询会在临界区内遍历一次空闲链表(O(空闲块数))，TLSF每次查询遍历最高一档的空闲链表
  * @param  heap_info        
  */
 extern void eh_mem_get_heap_info(struct eh_mem_heap_info *heap_info);
 
+/**
+ * @brief                   获取单个堆的信息，开销与 eh_mem_get_heap_info 相同
+ * @param  heap_id          eh_mem_heap_register 返回的堆id
+ * @param  heap_info
+ * @return int              成功返回0，id无效返回EH_RET_INVALID_PARAM
+ */
+extern int eh_mem_get_heap_info_by_id(int heap_id, struct eh_mem_heap_info *heap_info);
+
 
 /**
  * @brief                   遍历可用内存块
@@ -53,6 +131,24 @@ extern void eh_mem_get_heap_info(struct eh_mem_heap_info *heap_info);
  */
 void eh_free_block_dump(void dump_func(void* start, size_t size));
 
+/**
+ * @brief                   遍历所有调用点的统计，EH_CONFIG_MEM_PROFILE为0时不做任何事情
+ * @param  site_func        site_func内禁止任何形式的await，也不要分配内存
+ */
+extern void eh_mem_profile_for_each_site(void site_func(const struct eh_mem_profile_site *site));
+
+/**
+ * @brief                   打印按未释放字节数排序的前top_n个调用点，EH_CONFIG_MEM_PROFILE为0时不做任何事情
+ * @param  top_n            打印的调用点个数
+ */
+extern void eh_mem_profile_dump(size_t top_n);
+
+/**
+ * @brief                   打印仍未释放的分配(地址、大小、调用点)，EH_CONFIG_MEM_PROFILE为0时不做任何事情
+ * @param  max_cnt          最多打印的个数
+ */
+extern void eh_mem_profile_dump_live(size_t max_cnt);
+
 #ifdef __cplusplus
 #if __cplusplus
 }
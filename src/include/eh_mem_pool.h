@@ -12,8 +12,10 @@
 #define _EH_MEM_POOL_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <eh_types.h>
+#include <eh_list.h>
 
 
 typedef int* eh_mem_pool_t;
@@ -29,10 +31,23 @@ struct eh_mem_pool_list{
     struct eh_mem_pool_list     *next;
 };
 
+enum eh_mem_pool_flags{
+    EH_MEM_POOL_FLAGS_GROWABLE              = 0x01,     /* 内存块用完时自动增加一个块(chunk)，由 eh_mem_pool_create_growable 设置 */
+    EH_MEM_POOL_FLAGS_RELEASE_EMPTY_CHUNK   = 0x02,     /* 块中的内存块全部归还后释放该块，但保留一个空块备用，避免在块边界上反复申请释放 */
+};
+
 struct eh_mem_pool{
     void                        *base;
     size_t                      align_size;
-    size_t                      num;
+    size_t                      num;                    /* 内存块数量，可增长内存池中为每个块的内存块数量 */
+    size_t                      used;                   /* 已分配的内存块数量，可增长内存池中为所有块的总和 */
+    uint32_t                    flags;
+    /* 以下仅在可增长内存池中使用，有空闲内存块的块在前，用满的块在后 */
+    size_t                      align;
+    size_t                      chunk_cnt;              /* 持有的块数量，包括备用的空块 */
+    struct eh_mem_pool          *spare_chunk;           /* EH_MEM_POOL_FLAGS_RELEASE_EMPTY_CHUNK 时保留的空块，不在chunk_list_head中 */
+    struct eh_list_head         chunk_list_head;
+    struct eh_list_head         chunk_node;
     struct eh_mem_pool_list     free_list_head;
     struct eh_mem_pool_list     free_list[0];
 };
@@ -47,6 +62,19 @@ struct eh_mem_pool{
  */
 extern  eh_mem_pool_t eh_mem_pool_create(size_t align, size_t size, size_t num);
 
+/**
+ * @brief                   可增长内存池创建，创建时不申请内存块，内存块用完时每次向堆申请一个包含chunk_num项的块，
+ *                          每项内存块前有一个指向所属块的头部，释放时直接找到所属块，
+ *                          eh_mem_pool_for_each/eh_mem_pool_idx_is_used/eh_mem_pool_idx_to_ptr/eh_mem_pool_ptr_to_idx
+ *                          只能用于固定大小的内存池
+ * @param  align            内存对齐字节数
+ * @param  size             每一项内存块的大小
+ * @param  chunk_num        每个块包含的内存块数量
+ * @param  flags            EH_MEM_POOL_FLAGS_RELEASE_EMPTY_CHUNK 或 0
+ * @return eh_mem_pool_t    成功返回内存池句柄，失败返回可由 eh_ptr_to_error 判断的错误指针
+ */
+extern  eh_mem_pool_t eh_mem_pool_create_growable(size_t align, size_t size, size_t chunk_num, uint32_t flags);
+
 /**
  * @brief                   销毁内存池
  * @param  pool             内存池句柄
@@ -67,6 +95,49 @@ extern __safety void* eh_mem_pool_alloc(eh_mem_pool_t pool);
  */
 extern __safety void  eh_mem_pool_free(eh_mem_pool_t pool, void* ptr);
 
+/**
+ * @brief                   批量分配，整批只进入一次临界区
+ * @param  pool             内存池句柄
+ * @param  ptrs             输出的内存块指针数组
+ * @param  n                需要分配的数量
+ * @return size_t           实际分配的数量，内存不足时小于n
+ */
+extern __safety size_t eh_mem_pool_alloc_bulk(eh_mem_pool_t pool, void **ptrs, size_t n);
+
+/**
+ * @brief                   批量回收，整批只进入一次临界区
+ * @param  pool             内存池句柄
+ * @param  ptrs             内存块指针数组
+ * @param  n                数量
+ */
+extern __safety void  eh_mem_pool_free_bulk(eh_mem_pool_t pool, void * const *ptrs, size_t n);
+
+/**
+ * @brief                   从内存池分配一项内存块，调用者需自行保证互斥(如已处于临界区中)
+ * @param  pool             内存池句柄
+ * @return void*            无空闲内存块时返回NULL
+ */
+extern void* eh_mem_pool_alloc_no_lock(eh_mem_pool_t pool);
+
+/**
+ * @brief                   回收一块内存块，调用者需自行保证互斥(如已处于临界区中)
+ * @param  pool             内存池句柄
+ * @param  ptr              内存块指针
+ */
+extern void  eh_mem_pool_free_no_lock(eh_mem_pool_t pool, void* ptr);
+
+/**
+ * @brief                   获取已分配的内存块数量
+ * @param  pool             内存池句柄
+ */
+#define eh_mem_pool_used(pool)          (((struct eh_mem_pool*)(pool))->used)
+
+/**
+ * @brief                   获取可增长内存池当前持有的块数量，固定内存池恒为1
+ * @param  pool             内存池句柄
+ */
+#define eh_mem_pool_chunk_cnt(pool)     (((struct eh_mem_pool*)(pool))->chunk_cnt)
+
 /**
  * @brief                   返回该指针在内存池索引
  * @param  pool             内存池句柄
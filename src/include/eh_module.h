@@ -70,6 +70,8 @@ extern void eh_module_section_exit(void);
 #endif
 
 #define eh_memory_module_export(_init__func_, _exit__func_)     _eh_define_module_export(_init__func_, _exit__func_, "1.0.0")
+#define eh_mem_profile_module_export(_init__func_, _exit__func_) _eh_define_module_export(_init__func_, _exit__func_, "1.0.0.0")
+#define eh_slab_module_export(_init__func_, _exit__func_)       _eh_define_module_export(_init__func_, _exit__func_, "1.0.0.1")
 #define eh_main_task_module_export(_init__func_, _exit__func_)  _eh_define_module_export(_init__func_, _exit__func_, "1.0.1")
 #define eh_core_module_export(_init__func_, _exit__func_)       _eh_define_module_export(_init__func_, _exit__func_, "1.0.2")
 #define eh_interior_module_export(_init__func_, _exit__func_)   _eh_define_module_export(_init__func_, _exit__func_, "1.1.0")
@@ -0,0 +1,105 @@
+/**
+ * @file eh_slab.h
+ * @brief 固定大小对象的缓存(slab)，每种对象一个缓存，底层为一个可增长的 eh_mem_pool，
+ *        块用完时向堆申请新的块，运行时内部频繁创建销毁的小对象(epoll接收器、回调触发器等)从这里分配，
+ *        避免每次都走通用堆，同时可按对象类型统计使用情况
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#ifndef _EH_SLAB_H_
+#define _EH_SLAB_H_
+
+#include <stddef.h>
+#include <eh_types.h>
+#include <eh_list.h>
+#include <eh_config.h>
+#include <eh_mem_pool.h>
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C"{
+#endif
+#endif /* __cplusplus */
+
+struct eh_slab_cache{
+    const char                  *name;
+    size_t                      obj_size;
+    size_t                      obj_align;
+    size_t                      chunk_obj_cnt;
+    /* 可增长内存池，首次分配时创建，空块会被释放 */
+    eh_mem_pool_t               pool;
+    /* 首次分配时挂入全局缓存链表，用于统计和退出时回收 */
+    struct eh_list_head         cache_node;
+    size_t                      max_inuse_cnt;
+    size_t                      alloc_cnt;
+    size_t                      fail_cnt;
+};
+
+struct eh_slab_cache_stat{
+    const char                  *name;
+    size_t                      obj_size;
+    size_t                      chunk_cnt;                  /* 当前持有的块数 */
+    size_t                      inuse_cnt;                  /* 当前在用对象数 */
+    size_t                      max_inuse_cnt;              /* 在用对象数的历史最大值 */
+    size_t                      alloc_cnt;                  /* 累计分配次数 */
+    size_t                      fail_cnt;                   /* 累计分配失败次数 */
+};
+
+#define EH_SLAB_CACHE_INIT(cache, _name, obj_type) {                                    \
+        .name = _name,                                                                  \
+        .obj_size = sizeof(obj_type),                                                   \
+        .obj_align = _Alignof(obj_type),                                                \
+        .chunk_obj_cnt = EH_CONFIG_SLAB_CHUNK_OBJ_CNT,                                  \
+        .cache_node = EH_LIST_HEAD_INIT(cache.cache_node),                              \
+    }
+
+/**
+ * @brief                   定义一个对象缓存，无需初始化，第一次分配时才向堆申请内存
+ * @param  cache_name       缓存变量名，同时作为统计时显示的名字
+ * @param  obj_type         对象类型
+ */
+#define EH_DEFINE_SLAB_CACHE(cache_name, obj_type)                                      \
+    struct eh_slab_cache cache_name = EH_SLAB_CACHE_INIT(cache_name, #cache_name, obj_type)
+
+#define EH_DEFINE_STATIC_SLAB_CACHE(cache_name, obj_type)                               \
+    static struct eh_slab_cache cache_name = EH_SLAB_CACHE_INIT(cache_name, #cache_name, obj_type)
+
+/**
+ * @brief                   从缓存中分配一个对象
+ * @param  cache            缓存
+ * @return void*            失败返回NULL
+ */
+extern __safety void* eh_slab_alloc(struct eh_slab_cache *cache);
+
+/**
+ * @brief                   归还一个对象，ptr为NULL时不做任何事情
+ * @param  cache            缓存，必须和分配时的一致
+ * @param  ptr              对象指针
+ */
+extern __safety void eh_slab_free(struct eh_slab_cache *cache, void *ptr);
+
+/**
+ * @brief                   获取缓存的统计信息
+ * @param  cache            缓存
+ * @param  stat             统计信息
+ */
+extern void eh_slab_cache_get_stat(struct eh_slab_cache *cache, struct eh_slab_cache_stat *stat);
+
+/**
+ * @brief                   遍历所有已经使用过的缓存的统计信息，回调在临界区内调用
+ * @param  stat_func        统计信息回调，回调内禁止任何形式的await，也不能等待需要进入临界区的其他线程
+ */
+extern void eh_slab_stat_dump(void stat_func(const struct eh_slab_cache_stat *stat));
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
+
+
+#endif // _EH_SLAB_H_
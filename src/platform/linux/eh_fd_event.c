@@ -0,0 +1,96 @@
+/**
+ * @file eh_fd_event.c
+ * @brief 将文件描述符的可读/可写状态包装为 eh_event_t
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <stdbool.h>
+#include <sys/epoll.h>
+#include <eh.h>
+#include <eh_debug.h>
+#include <eh_event.h>
+#include <eh_platform.h>
+#include <eh_fd_event.h>
+
+#define EH_FD_EVENT_READABLE_MASK       (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)
+#define EH_FD_EVENT_WRITABLE_MASK       (EPOLLOUT | EPOLLHUP | EPOLLERR)
+/* 只有IN/OUT会被等待者消费，挂断和错误是持续状态，一直保持锁存 */
+#define EH_FD_EVENT_CONSUMABLE_MASK     (EPOLLIN | EPOLLOUT)
+
+struct fd_event_wait_param{
+    eh_fd_event_t   *fd_event;
+    uint32_t        mask;
+};
+
+static void fd_event_callback(uint32_t events, void *arg){
+    eh_fd_event_t *fd_event = (eh_fd_event_t *)arg;
+    eh_save_state_t state;
+
+    state = eh_enter_critical();
+    fd_event->revents |= events;
+    eh_exit_critical(state);
+
+    if(events & EH_FD_EVENT_READABLE_MASK)
+        eh_event_notify(&fd_event->readable);
+    if(events & EH_FD_EVENT_WRITABLE_MASK)
+        eh_event_notify(&fd_event->writable);
+}
+
+static bool fd_event_condition(void *arg){
+    struct fd_event_wait_param *param = (struct fd_event_wait_param *)arg;
+    return !!(eh_read_once(param->fd_event->revents) & param->mask);
+}
+
+int eh_fd_event_init(eh_fd_event_t *fd_event, int fd){
+    int ret;
+    eh_param_assert(fd_event);
+    eh_param_assert(fd >= 0);
+
+    eh_event_init(&fd_event->readable);
+    eh_event_init(&fd_event->writable);
+    fd_event->fd = fd;
+    fd_event->revents = 0;
+    fd_event->action.callback = fd_event_callback;
+    fd_event->action.arg = fd_event;
+
+    ret = epoll_hub_add_fd(fd, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, &fd_event->action);
+    if(ret < 0)
+        return EH_RET_FAULT;
+    return EH_RET_OK;
+}
+
+void eh_fd_event_clean(eh_fd_event_t *fd_event){
+    if(fd_event == NULL)
+        return ;
+    epoll_hub_del_fd(fd_event->fd);
+    eh_event_clean(&fd_event->readable);
+    eh_event_clean(&fd_event->writable);
+}
+
+int __async eh_fd_event_wait(eh_fd_event_t *fd_event, uint32_t events, eh_sclock_t timeout){
+    struct fd_event_wait_param param;
+    eh_save_state_t state;
+    uint32_t revents;
+    int ret;
+
+    eh_param_assert(fd_event);
+    eh_param_assert(events == EPOLLIN || events == EPOLLOUT);
+
+    param.fd_event = fd_event;
+    param.mask = events == EPOLLIN ? EH_FD_EVENT_READABLE_MASK : EH_FD_EVENT_WRITABLE_MASK;
+    ret = __await eh_event_wait_condition_timeout(
+        events == EPOLLIN ? &fd_event->readable : &fd_event->writable, 
+        &param, fd_event_condition, timeout);
+    if(ret < 0)
+        return ret;
+
+    state = eh_enter_critical();
+    revents = fd_event->revents & param.mask;
+    fd_event->revents &= ~(revents & EH_FD_EVENT_CONSUMABLE_MASK);
+    eh_exit_critical(state);
+    return (int)revents;
+}
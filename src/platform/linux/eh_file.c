@@ -0,0 +1,528 @@
+/**
+ * @file eh_file.c
+ * @brief 异步文件IO，请求先挂到待提交链表，由循环轮询任务在每轮循环中一次性提交，
+ *        io_uring后端通过注册在epoll_hub中的eventfd收割完成事件，offload后端由工作线程执行
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <sys/mman.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <eh.h>
+#include <eh_debug.h>
+#include <eh_event.h>
+#include <eh_module.h>
+#include <eh_offload.h>
+#include <epoll_hub.h>
+#include <eh_file.h>
+
+#if EH_CONFIG_FILE_USE_IO_URING && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define EH_FILE_HAVE_IO_URING       1
+#endif
+#endif
+
+#ifndef EH_FILE_HAVE_IO_URING
+#define EH_FILE_HAVE_IO_URING       0
+#endif
+
+enum eh_file_opcode{
+    EH_FILE_OP_READ,
+    EH_FILE_OP_WRITE,
+    EH_FILE_OP_READ_FIXED,
+    EH_FILE_OP_WRITE_FIXED,
+    EH_FILE_OP_FSYNC,
+};
+
+struct eh_file_req{
+    struct eh_list_head         list_node;
+    eh_event_t                  done_event;             /* io_uring后端使用 */
+    eh_offload_job_t            job;                    /* offload后端使用 */
+    enum eh_file_opcode         opcode;
+    int                         fd;
+    void                        *buf;
+    size_t                      len;
+    off_t                       offset;
+    unsigned int                buf_index;
+    bool                        datasync;
+    ssize_t                     res;                    /* 成功为字节数，失败为 -errno */
+    int                         done;
+};
+
+#if EH_FILE_HAVE_IO_URING
+struct eh_file_uring{
+    int                         ring_fd;
+    int                         event_fd;
+    void                        *sq_ring;
+    size_t                      sq_ring_size;
+    void                        *cq_ring;
+    size_t                      cq_ring_size;
+    struct io_uring_sqe         *sqes;
+    size_t                      sqes_size;
+    uint32_t                    *sq_head;
+    uint32_t                    *sq_tail;
+    uint32_t                    *sq_array;
+    uint32_t                    sq_mask;
+    uint32_t                    sq_entries;
+    uint32_t                    *cq_head;
+    uint32_t                    *cq_tail;
+    struct io_uring_cqe         *cqes;
+    uint32_t                    cq_mask;
+    uint32_t                    cq_entries;
+    uint32_t                    to_submit;              /* 已放入SQ但内核还未接收的个数 */
+    struct epoll_fd_action      action;
+};
+#endif
+
+struct eh_file{
+    struct eh_list_head         pending_list;
+    eh_loop_poll_task_t         poll_task;
+    const struct iovec          *fixed_iov;
+    unsigned int                fixed_nr;
+    struct eh_file_stat         stat;
+#if EH_FILE_HAVE_IO_URING
+    struct eh_file_uring        uring;
+#endif
+};
+
+static struct eh_file file;
+
+static ssize_t file_req_syscall(struct eh_file_req *req){
+    ssize_t ret;
+    switch(req->opcode){
+        case EH_FILE_OP_READ:
+        case EH_FILE_OP_READ_FIXED:
+            ret = pread(req->fd, req->buf, req->len, req->offset);
+            break;
+        case EH_FILE_OP_WRITE:
+        case EH_FILE_OP_WRITE_FIXED:
+            ret = pwrite(req->fd, req->buf, req->len, req->offset);
+            break;
+        case EH_FILE_OP_FSYNC:
+            ret = req->datasync ? fdatasync(req->fd) : fsync(req->fd);
+            break;
+        default:
+            errno = EINVAL;
+            ret = -1;
+            break;
+    }
+    return ret < 0 ? -(ssize_t)errno : ret;
+}
+
+static void* file_offload_fn(void *arg){
+    struct eh_file_req *req = (struct eh_file_req *)arg;
+    req->res = file_req_syscall(req);
+    return NULL;
+}
+
+static void file_offload_flush(void){
+    struct eh_file_req *req, *n;
+    struct eh_list_head job_list;
+    uint32_t cnt = 0;
+
+    eh_list_head_init(&job_list);
+    eh_list_for_each_entry_safe(req, n, &file.pending_list, list_node){
+        eh_list_del_init(&req->list_node);
+        eh_list_add_tail(&req->job.list_node, &job_list);
+        cnt++;
+    }
+    file.stat.pending_cnt -= cnt;
+    file.stat.inflight_cnt += cnt;
+    file.stat.submit_cnt += cnt;
+    file.stat.batch_cnt++;
+    if(eh_offload_job_submit_list(&job_list) == 0)
+        return ;
+    /* 线程池不可用，直接以失败完成，job不在线程池中，可以由本线程置位 */
+    eh_list_for_each_entry_safe(req, n, &job_list, job.list_node){
+        eh_list_del_init(&req->job.list_node);
+        req->res = -ECANCELED;
+        req->job.done = 1;
+        eh_event_notify(&req->job.done_event);
+    }
+}
+
+#if EH_FILE_HAVE_IO_URING
+
+static void file_uring_prep(struct io_uring_sqe *sqe, struct eh_file_req *req){
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->fd = req->fd;
+    sqe->user_data = (uint64_t)(uintptr_t)req;
+    switch(req->opcode){
+        case EH_FILE_OP_READ:
+            sqe->opcode = IORING_OP_READ;
+            break;
+        case EH_FILE_OP_WRITE:
+            sqe->opcode = IORING_OP_WRITE;
+            break;
+        case EH_FILE_OP_READ_FIXED:
+            sqe->opcode = IORING_OP_READ_FIXED;
+            sqe->buf_index = (uint16_t)req->buf_index;
+            break;
+        case EH_FILE_OP_WRITE_FIXED:
+            sqe->opcode = IORING_OP_WRITE_FIXED;
+            sqe->buf_index = (uint16_t)req->buf_index;
+            break;
+        case EH_FILE_OP_FSYNC:
+            sqe->opcode = IORING_OP_FSYNC;
+            sqe->fsync_flags = req->datasync ? IORING_FSYNC_DATASYNC : 0;
+            return ;
+    }
+    sqe->addr = (uint64_t)(uintptr_t)req->buf;
+    /* SQE的长度只有32位，更长的请求截断成一次短读写，与pread/pwrite的语义一致 */
+    sqe->len = req->len > UINT32_MAX ? UINT32_MAX : (uint32_t)req->len;
+    sqe->off = (uint64_t)req->offset;
+}
+
+static void file_uring_flush(void){
+    struct eh_file_uring *ring = &file.uring;
+    struct eh_file_req *req, *n;
+    uint32_t head, tail, idx;
+    uint32_t cnt = 0;
+    int ret;
+
+    tail = *ring->sq_tail;
+    head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    eh_list_for_each_entry_safe(req, n, &file.pending_list, list_node){
+        /* inflight不超过CQ大小，保证完成队列不会溢出 */
+        if(tail - head >= ring->sq_entries || file.stat.inflight_cnt >= ring->cq_entries)
+            break;
+        eh_list_del_init(&req->list_node);
+        idx = tail & ring->sq_mask;
+        file_uring_prep(&ring->sqes[idx], req);
+        ring->sq_array[idx] = idx;
+        tail++;
+        cnt++;
+        file.stat.inflight_cnt++;
+    }
+    if(cnt){
+        __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+        ring->to_submit += cnt;
+        file.stat.pending_cnt -= cnt;
+        file.stat.submit_cnt += cnt;
+    }
+    if(ring->to_submit == 0)
+        return ;
+    ret = (int)syscall(__NR_io_uring_enter, ring->ring_fd, ring->to_submit, 0, 0, NULL, 0);
+    if(ret > 0){
+        ring->to_submit -= (uint32_t)ret;
+        file.stat.batch_cnt++;
+    }else if(ret < 0 && errno != EAGAIN && errno != EBUSY && errno != EINTR){
+        eh_errfl("io_uring_enter error %d", errno);
+    }
+}
+
+static void file_uring_event_callback(uint32_t events, void *arg){
+    struct eh_file_uring *ring = (struct eh_file_uring *)arg;
+    struct io_uring_cqe *cqe;
+    struct eh_file_req *req;
+    uint32_t head, tail;
+    uint64_t val;
+    (void)events;
+
+    if(read(ring->event_fd, &val, sizeof(val)) < 0 && errno != EAGAIN)
+        return ;
+    head = *ring->cq_head;
+    tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    while(head != tail){
+        cqe = &ring->cqes[head & ring->cq_mask];
+        req = (struct eh_file_req *)(uintptr_t)cqe->user_data;
+        req->res = cqe->res;
+        req->done = 1;
+        eh_event_notify(&req->done_event);
+        head++;
+    }
+    __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+}
+
+static int file_uring_init(struct eh_file_uring *ring){
+    struct io_uring_params params;
+    int ret;
+
+    memset(ring, 0, sizeof(*ring));
+    memset(&params, 0, sizeof(params));
+    ring->ring_fd = (int)syscall(__NR_io_uring_setup, EH_CONFIG_FILE_URING_ENTRIES, &params);
+    if(ring->ring_fd < 0)
+        return EH_RET_NOT_SUPPORTED;
+    /* FAST_POLL(5.7)之后的内核才保证支持 IORING_OP_READ/IORING_OP_WRITE */
+    if(!(params.features & IORING_FEAT_FAST_POLL)){
+        ret = EH_RET_NOT_SUPPORTED;
+        goto features_error;
+    }
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if(params.features & IORING_FEAT_SINGLE_MMAP){
+        if(ring->cq_ring_size > ring->sq_ring_size)
+            ring->sq_ring_size = ring->cq_ring_size;
+        ring->cq_ring_size = ring->sq_ring_size;
+    }
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_SQ_RING);
+    if(ring->sq_ring == MAP_FAILED){
+        ret = EH_RET_MALLOC_ERROR;
+        goto sq_ring_mmap_error;
+    }
+    if(params.features & IORING_FEAT_SINGLE_MMAP){
+        ring->cq_ring = ring->sq_ring;
+    }else{
+        ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_CQ_RING);
+        if(ring->cq_ring == MAP_FAILED){
+            ret = EH_RET_MALLOC_ERROR;
+            goto cq_ring_mmap_error;
+        }
+    }
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_SQES);
+    if(ring->sqes == MAP_FAILED){
+        ret = EH_RET_MALLOC_ERROR;
+        goto sqes_mmap_error;
+    }
+
+    ring->sq_head = (uint32_t *)((uint8_t *)ring->sq_ring + params.sq_off.head);
+    ring->sq_tail = (uint32_t *)((uint8_t *)ring->sq_ring + params.sq_off.tail);
+    ring->sq_array = (uint32_t *)((uint8_t *)ring->sq_ring + params.sq_off.array);
+    ring->sq_mask = *(uint32_t *)((uint8_t *)ring->sq_ring + params.sq_off.ring_mask);
+    ring->sq_entries = params.sq_entries;
+    ring->cq_head = (uint32_t *)((uint8_t *)ring->cq_ring + params.cq_off.head);
+    ring->cq_tail = (uint32_t *)((uint8_t *)ring->cq_ring + params.cq_off.tail);
+    ring->cqes = (struct io_uring_cqe *)((uint8_t *)ring->cq_ring + params.cq_off.cqes);
+    ring->cq_mask = *(uint32_t *)((uint8_t *)ring->cq_ring + params.cq_off.ring_mask);
+    ring->cq_entries = params.cq_entries;
+
+    ring->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(ring->event_fd < 0){
+        ret = EH_RET_FAULT;
+        goto eventfd_error;
+    }
+    ret = (int)syscall(__NR_io_uring_register, ring->ring_fd, IORING_REGISTER_EVENTFD, &ring->event_fd, 1);
+    if(ret < 0){
+        ret = EH_RET_FAULT;
+        goto register_eventfd_error;
+    }
+    ring->action.callback = file_uring_event_callback;
+    ring->action.arg = ring;
+    ret = epoll_hub_add_fd(ring->event_fd, EPOLLIN, &ring->action);
+    if(ret < 0){
+        ret = EH_RET_FAULT;
+        goto epoll_hub_add_error;
+    }
+    return 0;
+
+epoll_hub_add_error:
+register_eventfd_error:
+    close(ring->event_fd);
+eventfd_error:
+    munmap(ring->sqes, ring->sqes_size);
+sqes_mmap_error:
+    if(ring->cq_ring != ring->sq_ring)
+        munmap(ring->cq_ring, ring->cq_ring_size);
+cq_ring_mmap_error:
+    munmap(ring->sq_ring, ring->sq_ring_size);
+sq_ring_mmap_error:
+features_error:
+    close(ring->ring_fd);
+    return ret;
+}
+
+static void file_uring_exit(struct eh_file_uring *ring){
+    epoll_hub_del_fd(ring->event_fd);
+    close(ring->event_fd);
+    munmap(ring->sqes, ring->sqes_size);
+    if(ring->cq_ring != ring->sq_ring)
+        munmap(ring->cq_ring, ring->cq_ring_size);
+    munmap(ring->sq_ring, ring->sq_ring_size);
+    close(ring->ring_fd);
+}
+
+#endif /* EH_FILE_HAVE_IO_URING */
+
+static void file_poll_task(void *arg){
+    (void)arg;
+#if EH_FILE_HAVE_IO_URING
+    if(file.stat.backend == EH_FILE_BACKEND_IO_URING){
+        file_uring_flush();
+        /* SQ或CQ已满时保留在轮询链表中，完成事件唤醒循环后再次提交 */
+        if(eh_list_empty(&file.pending_list) && file.uring.to_submit == 0)
+            eh_loop_poll_task_del(&file.poll_task);
+        return ;
+    }
+#endif
+    file_offload_flush();
+    eh_loop_poll_task_del(&file.poll_task);
+}
+
+static bool file_req_condition(void *arg){
+    struct eh_file_req *req = (struct eh_file_req *)arg;
+    return !!eh_read_once(req->done);
+}
+
+static ssize_t __async file_req_exec(struct eh_file_req *req){
+    req->res = 0;
+    req->done = 0;
+    eh_list_head_init(&req->list_node);
+    eh_event_init(&req->done_event);
+    eh_offload_job_init(&req->job, file_offload_fn, req);
+
+    eh_list_add_tail(&req->list_node, &file.pending_list);
+    file.stat.pending_cnt++;
+    eh_loop_poll_task_add(&file.poll_task);
+
+    /* 请求已交给内核或工作线程，无论被何种原因唤醒都必须等到完成 */
+    if(file.stat.backend == EH_FILE_BACKEND_IO_URING){
+        while(!eh_read_once(req->done))
+            __await eh_event_wait_condition_timeout(&req->done_event, req, file_req_condition, EH_TIME_FOREVER);
+    }else{
+        while(!eh_offload_job_is_done(&req->job))
+            __await eh_offload_job_wait(&req->job, EH_TIME_FOREVER);
+    }
+    file.stat.inflight_cnt--;
+    file.stat.complete_cnt++;
+    eh_offload_job_clean(&req->job);
+    eh_event_clean(&req->done_event);
+
+    if(req->res < 0){
+        errno = (int)-req->res;
+        return EH_RET_FAULT;
+    }
+    return req->res;
+}
+
+static bool file_fixed_buf_check(const void *buf, size_t len, unsigned int buf_index){
+    const uint8_t *base;
+    if(buf_index >= file.fixed_nr)
+        return false;
+    base = (const uint8_t *)file.fixed_iov[buf_index].iov_base;
+    return  (const uint8_t *)buf >= base &&
+            (const uint8_t *)buf + len <= base + file.fixed_iov[buf_index].iov_len;
+}
+
+ssize_t __async eh_file_pread(int fd, void *buf, size_t len, off_t offset){
+    struct eh_file_req req;
+    eh_param_assert(fd >= 0);
+    eh_param_assert(buf || len == 0);
+    req.opcode = EH_FILE_OP_READ;
+    req.fd = fd;
+    req.buf = buf;
+    req.len = len;
+    req.offset = offset;
+    return __await file_req_exec(&req);
+}
+
+ssize_t __async eh_file_pwrite(int fd, const void *buf, size_t len, off_t offset){
+    struct eh_file_req req;
+    eh_param_assert(fd >= 0);
+    eh_param_assert(buf || len == 0);
+    req.opcode = EH_FILE_OP_WRITE;
+    req.fd = fd;
+    req.buf = (void*)buf;
+    req.len = len;
+    req.offset = offset;
+    return __await file_req_exec(&req);
+}
+
+int __async eh_file_fsync(int fd, bool datasync){
+    struct eh_file_req req;
+    eh_param_assert(fd >= 0);
+    req.opcode = EH_FILE_OP_FSYNC;
+    req.fd = fd;
+    req.buf = NULL;
+    req.len = 0;
+    req.offset = 0;
+    req.datasync = datasync;
+    return (int)__await file_req_exec(&req);
+}
+
+ssize_t __async eh_file_pread_fixed(int fd, void *buf, size_t len, off_t offset, unsigned int buf_index){
+    struct eh_file_req req;
+    eh_param_assert(fd >= 0);
+    eh_param_assert(file_fixed_buf_check(buf, len, buf_index));
+    req.opcode = EH_FILE_OP_READ_FIXED;
+    req.fd = fd;
+    req.buf = buf;
+    req.len = len;
+    req.offset = offset;
+    req.buf_index = buf_index;
+    return __await file_req_exec(&req);
+}
+
+ssize_t __async eh_file_pwrite_fixed(int fd, const void *buf, size_t len, off_t offset, unsigned int buf_index){
+    struct eh_file_req req;
+    eh_param_assert(fd >= 0);
+    eh_param_assert(file_fixed_buf_check(buf, len, buf_index));
+    req.opcode = EH_FILE_OP_WRITE_FIXED;
+    req.fd = fd;
+    req.buf = (void*)buf;
+    req.len = len;
+    req.offset = offset;
+    req.buf_index = buf_index;
+    return __await file_req_exec(&req);
+}
+
+int eh_file_buffers_register(const struct iovec *iov, unsigned int nr){
+    eh_param_assert(iov);
+    eh_param_assert(nr > 0);
+    if(file.fixed_iov)
+        return EH_RET_BUSY;
+#if EH_FILE_HAVE_IO_URING
+    if(file.stat.backend == EH_FILE_BACKEND_IO_URING &&
+        syscall(__NR_io_uring_register, file.uring.ring_fd, IORING_REGISTER_BUFFERS, iov, nr) < 0){
+        eh_errfl("io_uring register buffers error %d", errno);
+        return EH_RET_FAULT;
+    }
+#endif
+    file.fixed_iov = iov;
+    file.fixed_nr = nr;
+    return EH_RET_OK;
+}
+
+void eh_file_buffers_unregister(void){
+    if(file.fixed_iov == NULL)
+        return ;
+#if EH_FILE_HAVE_IO_URING
+    if(file.stat.backend == EH_FILE_BACKEND_IO_URING)
+        syscall(__NR_io_uring_register, file.uring.ring_fd, IORING_UNREGISTER_BUFFERS, NULL, 0);
+#endif
+    file.fixed_iov = NULL;
+    file.fixed_nr = 0;
+}
+
+void eh_file_get_stat(struct eh_file_stat *stat){
+    *stat = file.stat;
+}
+
+static int __init eh_file_init(void){
+    memset(&file, 0, sizeof(file));
+    eh_list_head_init(&file.pending_list);
+    eh_list_head_init(&file.poll_task.list_node);
+    file.poll_task.poll_task = file_poll_task;
+    file.poll_task.arg = NULL;
+    file.stat.backend = EH_FILE_BACKEND_OFFLOAD;
+#if EH_FILE_HAVE_IO_URING
+    if(file_uring_init(&file.uring) == 0)
+        file.stat.backend = EH_FILE_BACKEND_IO_URING;
+#endif
+    return 0;
+}
+
+static void __exit eh_file_exit(void){
+    eh_loop_poll_task_del(&file.poll_task);
+    eh_file_buffers_unregister();
+#if EH_FILE_HAVE_IO_URING
+    if(file.stat.backend == EH_FILE_BACKEND_IO_URING)
+        file_uring_exit(&file.uring);
+#endif
+}
+
+eh_interior_module_export(eh_file_init, eh_file_exit);
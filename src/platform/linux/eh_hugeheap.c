@@ -0,0 +1,215 @@
+/**
+ * @file eh_hugeheap.c
+ * @brief Linux大页堆，每个区域尾部放一个按2MiB块计的状态数组，trim时借助 eh_free_block_dump
+ *        找出完全落在空闲块负载内的2MiB块，空闲块开头的块头和空闲链表指针所在部分始终保留
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <eh.h>
+#include <eh_debug.h>
+#include <eh_error.h>
+#include <eh_mem.h>
+#include <eh_types.h>
+#include <eh_config.h>
+#include <eh_platform.h>
+#include <eh_hugeheap.h>
+
+#if (!defined(EH_CONFIG_USE_LIBC_MEM_MANAGE)) || (EH_CONFIG_USE_LIBC_MEM_MANAGE == 0)
+
+#ifndef MADV_FREE
+#define MADV_FREE                   8
+#endif
+
+/* 空闲块开头这部分放着块头和空闲链表指针，不能归还 */
+#define EH_HUGEHEAP_FREE_BLOCK_KEEP     (256U)
+
+#define EH_HUGEHEAP_CHUNK_RELEASED      (0x80U)
+#define EH_HUGEHEAP_CHUNK_COVERED       (0x40U)
+#define EH_HUGEHEAP_CHUNK_IDLE_MASK     (0x3fU)
+
+eh_static_assert(EH_CONFIG_HUGEHEAP_IDLE_TRIM_CNT >= 1 && EH_CONFIG_HUGEHEAP_IDLE_TRIM_CNT <= EH_HUGEHEAP_CHUNK_IDLE_MASK,
+    "EH_CONFIG_HUGEHEAP_IDLE_TRIM_CNT must be in [1, 63]");
+
+struct eh_hugeheap_region{
+    uint8_t                     *base;
+    size_t                      size;
+    size_t                      chunk_cnt;
+    uint8_t                     *chunk_state;           /* 位于区域尾部，每个2MiB块一个字节 */
+    int                         heap_id;
+};
+
+static struct eh_hugeheap_region hugeheap_region[EH_CONFIG_HUGEHEAP_REGION_MAX];
+static size_t hugeheap_region_cnt;
+static size_t hugeheap_release_cnt;
+static size_t hugeheap_thp_region_cnt;
+static int hugeheap_free_advice = MADV_FREE;
+
+static void *hugeheap_map(size_t size){
+    uint8_t *raw, *base;
+    size_t head, tail;
+
+    /* 多映射一个大页再裁掉首尾，保证起始地址按2MiB对齐，THP才能整页映射 */
+    raw = mmap(NULL, size + EH_HUGEHEAP_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(raw == MAP_FAILED)
+        return NULL;
+    base = (uint8_t*)eh_align_up((uintptr_t)raw, EH_HUGEHEAP_PAGE_SIZE);
+    head = (size_t)(base - raw);
+    tail = EH_HUGEHEAP_PAGE_SIZE - head;
+    if(head)
+        munmap(raw, head);
+    if(tail)
+        munmap(base + size, tail);
+    return base;
+}
+
+int eh_hugeheap_create(size_t size, uint32_t heap_flags){
+    struct eh_hugeheap_region *region;
+    struct eh_mem_heap heap;
+    eh_save_state_t state;
+    size_t meta_size;
+    uint8_t *base;
+    int heap_id;
+
+    if(size == 0 || size > SIZE_MAX - EH_HUGEHEAP_PAGE_SIZE * 2)
+        return EH_RET_INVALID_PARAM;
+    size = eh_align_up(size, EH_HUGEHEAP_PAGE_SIZE);
+    if(hugeheap_region_cnt >= EH_CONFIG_HUGEHEAP_REGION_MAX)
+        return EH_RET_BUSY;
+    base = hugeheap_map(size);
+    if(base == NULL)
+        return EH_RET_MALLOC_ERROR;
+#ifdef MADV_HUGEPAGE
+    if(madvise(base, size, MADV_HUGEPAGE) == 0)
+        hugeheap_thp_region_cnt++;
+#endif
+    meta_size = eh_align_up(size / EH_HUGEHEAP_PAGE_SIZE, (size_t)64);
+    heap.heap_start = base;
+    heap.heap_size = size - meta_size;
+    heap.flags = heap_flags;
+    heap_id = eh_mem_heap_register(&heap);
+    if(heap_id < 0){
+        munmap(base, size);
+        return heap_id;
+    }
+    state = eh_enter_critical();
+    region = &hugeheap_region[hugeheap_region_cnt];
+    region->base = base;
+    region->size = size;
+    region->chunk_cnt = size / EH_HUGEHEAP_PAGE_SIZE;
+    region->chunk_state = base + size - meta_size;
+    region->heap_id = heap_id;
+    hugeheap_region_cnt++;
+    eh_exit_critical(state);
+    eh_infofl("hugeheap %d: %lu bytes @%#p", heap_id, (unsigned long)size, base);
+    return heap_id;
+}
+
+static void hugeheap_free_block_cover(void *start, size_t size){
+    struct eh_hugeheap_region *region;
+    uintptr_t begin, end;
+    size_t first, last;
+
+    if(size <= EH_HUGEHEAP_FREE_BLOCK_KEEP + EH_HUGEHEAP_PAGE_SIZE)
+        return ;
+    for(size_t i = 0; i < hugeheap_region_cnt; i++){
+        region = &hugeheap_region[i];
+        if((uint8_t*)start < region->base || (uint8_t*)start >= region->base + region->size)
+            continue;
+        begin = eh_align_up((uintptr_t)start + EH_HUGEHEAP_FREE_BLOCK_KEEP, EH_HUGEHEAP_PAGE_SIZE);
+        end = ((uintptr_t)start + size) & ~(uintptr_t)(EH_HUGEHEAP_PAGE_SIZE - 1);
+        if(end <= begin)
+            return ;
+        first = (begin - (uintptr_t)region->base) / EH_HUGEHEAP_PAGE_SIZE;
+        last = (end - (uintptr_t)region->base) / EH_HUGEHEAP_PAGE_SIZE;
+        for(size_t c = first; c < last; c++)
+            region->chunk_state[c] |= EH_HUGEHEAP_CHUNK_COVERED;
+        return ;
+    }
+}
+
+static size_t hugeheap_region_trim(struct eh_hugeheap_region *region){
+    uint8_t *chunk_state;
+    size_t released = 0;
+    uint8_t idle;
+
+    for(size_t c = 0; c < region->chunk_cnt; c++){
+        chunk_state = &region->chunk_state[c];
+        if(!(*chunk_state & EH_HUGEHEAP_CHUNK_COVERED)){
+            /* 被重新使用，写入时缺页自动补回 */
+            *chunk_state = 0;
+            continue;
+        }
+        idle = *chunk_state & EH_HUGEHEAP_CHUNK_IDLE_MASK;
+        if(idle < EH_HUGEHEAP_CHUNK_IDLE_MASK)
+            idle++;
+        *chunk_state = (uint8_t)((*chunk_state & EH_HUGEHEAP_CHUNK_RELEASED) | idle);
+        if((*chunk_state & EH_HUGEHEAP_CHUNK_RELEASED) || idle < EH_CONFIG_HUGEHEAP_IDLE_TRIM_CNT)
+            continue;
+        if( madvise(region->base + c * EH_HUGEHEAP_PAGE_SIZE, EH_HUGEHEAP_PAGE_SIZE, hugeheap_free_advice) < 0 &&
+            errno == EINVAL && hugeheap_free_advice == MADV_FREE ){
+            /* 4.5之前的内核没有MADV_FREE */
+            hugeheap_free_advice = MADV_DONTNEED;
+            madvise(region->base + c * EH_HUGEHEAP_PAGE_SIZE, EH_HUGEHEAP_PAGE_SIZE, hugeheap_free_advice);
+        }
+        *chunk_state |= EH_HUGEHEAP_CHUNK_RELEASED;
+        hugeheap_release_cnt++;
+        released += EH_HUGEHEAP_PAGE_SIZE;
+    }
+    return released;
+}
+
+size_t eh_hugeheap_trim(void){
+    eh_save_state_t state;
+    size_t released = 0;
+
+    state = eh_enter_critical();
+    eh_free_block_dump(hugeheap_free_block_cover);
+    for(size_t i = 0; i < hugeheap_region_cnt; i++)
+        released += hugeheap_region_trim(&hugeheap_region[i]);
+    eh_exit_critical(state);
+    return released;
+}
+
+void eh_hugeheap_get_stat(struct eh_hugeheap_stat *stat){
+    eh_save_state_t state;
+    memset(stat, 0, sizeof(struct eh_hugeheap_stat));
+    state = eh_enter_critical();
+    stat->region_cnt = hugeheap_region_cnt;
+    stat->release_cnt = hugeheap_release_cnt;
+    stat->thp_region_cnt = hugeheap_thp_region_cnt;
+    for(size_t i = 0; i < hugeheap_region_cnt; i++){
+        stat->mapped_size += hugeheap_region[i].size;
+        for(size_t c = 0; c < hugeheap_region[i].chunk_cnt; c++){
+            if(hugeheap_region[i].chunk_state[c] & EH_HUGEHEAP_CHUNK_RELEASED)
+                stat->released_size += EH_HUGEHEAP_PAGE_SIZE;
+        }
+    }
+    eh_exit_critical(state);
+}
+
+#else
+
+int eh_hugeheap_create(size_t size, uint32_t heap_flags){
+    (void)size;
+    (void)heap_flags;
+    return EH_RET_NOT_SUPPORTED;
+}
+
+size_t eh_hugeheap_trim(void){
+    return 0;
+}
+
+void eh_hugeheap_get_stat(struct eh_hugeheap_stat *stat){
+    memset(stat, 0, sizeof(struct eh_hugeheap_stat));
+}
+
+#endif
@@ -0,0 +1,236 @@
+/**
+ * @file eh_offload.c
+ * @brief 阻塞调用卸载线程池，工作线程完成后通过 eh_event_notify 唤醒等待任务，
+ *        跨线程的通知会经过 wait_break eventfd 打断事件循环的epoll_wait
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <string.h>
+#include <signal.h>
+#include <pthread.h>
+#include <eh.h>
+#include <eh_debug.h>
+#include <eh_event.h>
+#include <eh_module.h>
+#include <eh_platform.h>
+#include <eh_offload.h>
+
+struct eh_offload_pool{
+    pthread_mutex_t             lock;
+    pthread_cond_t              cond;
+    struct eh_list_head         job_list;
+    pthread_t                   workers[EH_CONFIG_OFFLOAD_WORKER_MAX];
+    bool                        quit;
+    struct eh_offload_stat      stat;
+};
+
+static struct eh_offload_pool offload_pool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+};
+
+static void* offload_worker(void *arg){
+    struct eh_offload_pool *pool = (struct eh_offload_pool *)arg;
+    eh_offload_job_t *job;
+    eh_save_state_t state;
+    eh_clock_t latency;
+    sigset_t mask;
+    void *result;
+
+    /* 工作线程不接收任何信号，交由事件循环线程(signalfd)处理 */
+    sigfillset(&mask);
+    pthread_sigmask(SIG_BLOCK, &mask, NULL);
+
+    pthread_mutex_lock(&pool->lock);
+    for(;;){
+        while(eh_list_empty(&pool->job_list) && !pool->quit)
+            pthread_cond_wait(&pool->cond, &pool->lock);
+        if(eh_list_empty(&pool->job_list))
+            break;
+        job = eh_list_entry(pool->job_list.next, eh_offload_job_t, list_node);
+        eh_list_del_init(&job->list_node);
+        pool->stat.queue_depth--;
+        pool->stat.busy_worker_cnt++;
+        pthread_mutex_unlock(&pool->lock);
+
+        job->start_time = eh_get_clock_monotonic_time();
+        result = job->fn(job->arg);
+        job->finish_time = eh_get_clock_monotonic_time();
+
+        pthread_mutex_lock(&pool->lock);
+        latency = job->finish_time - job->submit_time;
+        pool->stat.busy_worker_cnt--;
+        pool->stat.complete_cnt++;
+        pool->stat.total_wait_time += job->start_time - job->submit_time;
+        pool->stat.total_run_time += job->finish_time - job->start_time;
+        if(latency > pool->stat.max_latency)
+            pool->stat.max_latency = latency;
+        pthread_mutex_unlock(&pool->lock);
+
+        /*
+         * 等待者在临界区内检查done，所以置位和通知必须在同一个临界区内完成，
+         * 退出临界区后job可能已经被等待者释放，不可再访问
+         */
+        state = eh_enter_critical();
+        job->result = result;
+        job->done = 1;
+        eh_event_notify(&job->done_event);
+        eh_exit_critical(state);
+
+        pthread_mutex_lock(&pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+static bool offload_job_condition(void *arg){
+    eh_offload_job_t *job = (eh_offload_job_t *)arg;
+    return eh_offload_job_is_done(job);
+}
+
+void eh_offload_job_init(eh_offload_job_t *job, void* (*fn)(void *arg), void *arg){
+    eh_list_head_init(&job->list_node);
+    eh_event_init(&job->done_event);
+    job->fn = fn;
+    job->arg = arg;
+    job->result = NULL;
+    job->done = 0;
+    job->submit_time = 0;
+    job->start_time = 0;
+    job->finish_time = 0;
+}
+
+static void offload_worker_expand(struct eh_offload_pool *pool){
+    /* 非忙碌线程(空闲的和刚启动的)不足以消化队列时按需扩充，最多 EH_CONFIG_OFFLOAD_WORKER_MAX 个 */
+    while(  pool->stat.worker_cnt - pool->stat.busy_worker_cnt < pool->stat.queue_depth &&
+            pool->stat.worker_cnt < EH_CONFIG_OFFLOAD_WORKER_MAX ){
+        if(pthread_create(&pool->workers[pool->stat.worker_cnt], NULL, offload_worker, pool) != 0)
+            break;
+        pool->stat.worker_cnt++;
+    }
+}
+
+int eh_offload_job_submit_list(struct eh_list_head *job_list){
+    struct eh_offload_pool *pool = &offload_pool;
+    eh_offload_job_t *job, *n;
+    eh_clock_t now;
+    uint32_t cnt = 0;
+    int ret = EH_RET_OK;
+
+    eh_param_assert(job_list);
+    if(eh_list_empty(job_list))
+        return EH_RET_OK;
+
+    now = eh_get_clock_monotonic_time();
+    eh_list_for_each_entry(job, job_list, list_node){
+        job->done = 0;
+        job->submit_time = now;
+        cnt++;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    if(pool->quit){
+        ret = EH_RET_INVALID_STATE;
+        goto out;
+    }
+    pool->stat.queue_depth += cnt;
+    offload_worker_expand(pool);
+    if(pool->stat.worker_cnt == 0){
+        pool->stat.queue_depth -= cnt;
+        ret = EH_RET_FAULT;
+        goto out;
+    }
+    eh_list_for_each_entry_safe(job, n, job_list, list_node)
+        eh_list_move_tail(&job->list_node, &pool->job_list);
+    pool->stat.submit_cnt += cnt;
+    if(pool->stat.queue_depth > pool->stat.max_queue_depth)
+        pool->stat.max_queue_depth = pool->stat.queue_depth;
+    if(cnt == 1)
+        pthread_cond_signal(&pool->cond);
+    else
+        pthread_cond_broadcast(&pool->cond);
+out:
+    pthread_mutex_unlock(&pool->lock);
+    return ret;
+}
+
+int eh_offload_job_submit(eh_offload_job_t *job){
+    struct eh_list_head job_list;
+    int ret;
+    eh_param_assert(job);
+    eh_param_assert(job->fn);
+    eh_list_head_init(&job_list);
+    eh_list_add_tail(&job->list_node, &job_list);
+    ret = eh_offload_job_submit_list(&job_list);
+    /* 失败时job仍在临时链表上，需要摘下 */
+    if(ret < 0)
+        eh_list_del_init(&job->list_node);
+    return ret;
+}
+
+int __async eh_offload_job_wait(eh_offload_job_t *job, eh_sclock_t timeout){
+    eh_param_assert(job);
+    return __await eh_event_wait_condition_timeout(&job->done_event, job, offload_job_condition, timeout);
+}
+
+void eh_offload_job_clean(eh_offload_job_t *job){
+    eh_event_clean(&job->done_event);
+}
+
+int __async eh_offload(void* (*fn)(void *arg), void *arg, void **result){
+    eh_offload_job_t job;
+    int ret;
+
+    eh_offload_job_init(&job, fn, arg);
+    ret = eh_offload_job_submit(&job);
+    if(ret < 0)
+        goto out;
+    /* 提交后job正在被工作线程引用，必须等到完成 */
+    do{
+        ret = __await eh_offload_job_wait(&job, EH_TIME_FOREVER);
+    }while(!eh_offload_job_is_done(&job));
+    ret = EH_RET_OK;
+    if(result)
+        *result = job.result;
+out:
+    eh_offload_job_clean(&job);
+    return ret;
+}
+
+void eh_offload_get_stat(struct eh_offload_stat *stat){
+    pthread_mutex_lock(&offload_pool.lock);
+    *stat = offload_pool.stat;
+    pthread_mutex_unlock(&offload_pool.lock);
+}
+
+static int __init eh_offload_init(void){
+    struct eh_offload_pool *pool = &offload_pool;
+    pthread_mutex_lock(&pool->lock);
+    eh_list_head_init(&pool->job_list);
+    memset(&pool->stat, 0, sizeof(pool->stat));
+    pool->quit = false;
+    pthread_mutex_unlock(&pool->lock);
+    return 0;
+}
+
+static void __exit eh_offload_exit(void){
+    struct eh_offload_pool *pool = &offload_pool;
+    uint32_t worker_cnt;
+
+    /* 排队中的任务仍会被执行完，然后工作线程退出 */
+    pthread_mutex_lock(&pool->lock);
+    pool->quit = true;
+    worker_cnt = pool->stat.worker_cnt;
+    pthread_cond_broadcast(&pool->cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    for(uint32_t i = 0; i < worker_cnt; i++)
+        pthread_join(pool->workers[i], NULL);
+    pool->stat.worker_cnt = 0;
+}
+
+eh_interior_module_export(eh_offload_init, eh_offload_exit);
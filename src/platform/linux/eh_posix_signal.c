@@ -0,0 +1,144 @@
+/**
+ * @file eh_posix_signal.c
+ * @brief 通过 signalfd 将POSIX信号转换为eh信号
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <eh.h>
+#include <eh_debug.h>
+#include <eh_module.h>
+#include <epoll_hub.h>
+#include <eh_posix_signal.h>
+
+struct eh_posix_signal_hub{
+    int                         fd;
+    sigset_t                    mask;
+    struct epoll_fd_action      action;
+};
+
+eh_posix_signal_t eh_posix_signal_table[_NSIG];
+
+static struct eh_posix_signal_hub posix_signal_hub = {
+    .fd = -1,
+};
+
+static void posix_signal_callback(uint32_t events, void *arg){
+    struct eh_posix_signal_hub *hub = (struct eh_posix_signal_hub *)arg;
+    struct signalfd_siginfo infos[EH_CONFIG_POSIX_SIGNAL_READ_BATCH];
+    struct eh_posix_signal_event *e;
+    sigset_t hit;
+    ssize_t n;
+    int signo;
+    (void)events;
+
+    sigemptyset(&hit);
+    /* 一次读出多个信号，同一批次内的重复信号只通知一次 */
+    for(;;){
+        n = read(hub->fd, infos, sizeof(infos));
+        if(n <= 0)
+            break;
+        for(size_t i = 0; i < (size_t)n / sizeof(infos[0]); i++){
+            signo = (int)infos[i].ssi_signo;
+            if(signo <= 0 || signo >= _NSIG)
+                continue;
+            e = eh_signal_to_custom_event(eh_posix_signal(signo));
+            e->cnt++;
+            e->last_info = infos[i];
+            sigaddset(&hit, signo);
+        }
+        if((size_t)n < sizeof(infos))
+            break;
+    }
+    for(signo = 1; signo < _NSIG; signo++){
+        if(sigismember(&hit, signo) == 1)
+            eh_signal_notify(eh_posix_signal(signo));
+    }
+}
+
+int eh_posix_signal_enable(int signo){
+    struct eh_posix_signal_hub *hub = &posix_signal_hub;
+    sigset_t mask, one;
+    int fd;
+
+    eh_param_assert(signo > 0 && signo < _NSIG);
+    if(signo == SIGKILL || signo == SIGSTOP)
+        return EH_RET_INVALID_PARAM;
+    if(sigismember(&hub->mask, signo) == 1)
+        return EH_RET_OK;
+
+    mask = hub->mask;
+    sigaddset(&mask, signo);
+    sigemptyset(&one);
+    sigaddset(&one, signo);
+    if(pthread_sigmask(SIG_BLOCK, &one, NULL) != 0)
+        return EH_RET_FAULT;
+
+    /* 已有signalfd时直接更新其信号集 */
+    fd = signalfd(hub->fd, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if(fd < 0)
+        goto signalfd_error;
+    if(hub->fd < 0){
+        if(epoll_hub_add_fd(fd, EPOLLIN, &hub->action) < 0){
+            close(fd);
+            goto signalfd_error;
+        }
+        hub->fd = fd;
+    }
+    hub->mask = mask;
+    return EH_RET_OK;
+
+signalfd_error:
+    pthread_sigmask(SIG_UNBLOCK, &one, NULL);
+    return EH_RET_FAULT;
+}
+
+void eh_posix_signal_disable(int signo){
+    struct eh_posix_signal_hub *hub = &posix_signal_hub;
+    sigset_t one;
+
+    if(signo <= 0 || signo >= _NSIG || sigismember(&hub->mask, signo) != 1)
+        return ;
+    sigdelset(&hub->mask, signo);
+    if(hub->fd >= 0)
+        signalfd(hub->fd, &hub->mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    sigemptyset(&one);
+    sigaddset(&one, signo);
+    pthread_sigmask(SIG_UNBLOCK, &one, NULL);
+}
+
+static int __init eh_posix_signal_init(void){
+    struct eh_posix_signal_hub *hub = &posix_signal_hub;
+    hub->fd = -1;
+    sigemptyset(&hub->mask);
+    hub->action.callback = posix_signal_callback;
+    hub->action.arg = hub;
+    for(int signo = 0; signo < _NSIG; signo++){
+        memset(eh_signal_to_custom_event(eh_posix_signal(signo)), 0, sizeof(struct eh_posix_signal_event));
+        eh_signal_init(eh_posix_signal(signo));
+    }
+    return 0;
+}
+
+static void __exit eh_posix_signal_exit(void){
+    struct eh_posix_signal_hub *hub = &posix_signal_hub;
+    if(hub->fd >= 0){
+        epoll_hub_del_fd(hub->fd);
+        close(hub->fd);
+        hub->fd = -1;
+    }
+    pthread_sigmask(SIG_UNBLOCK, &hub->mask, NULL);
+    sigemptyset(&hub->mask);
+    for(int signo = 0; signo < _NSIG; signo++)
+        eh_event_clean(&eh_posix_signal(signo)->event);
+}
+
+eh_interior_module_export(eh_posix_signal_init, eh_posix_signal_exit);
@@ -0,0 +1,179 @@
+/**
+ * @file eh_prefork.c
+ * @brief 多进程预派生模式的监管进程实现
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <eh.h>
+#include <eh_debug.h>
+#include <eh_prefork.h>
+
+static pid_t prefork_spawn(const struct eh_prefork_config *config, unsigned int worker_id, const sigset_t *old_mask){
+    pid_t supervisor = getpid();
+    cpu_set_t cpu_set;
+    long ncpu;
+    pid_t pid;
+    int ret;
+
+    /* 避免缓冲区中未输出的内容被子进程重复输出 */
+    fflush(NULL);
+    pid = fork();
+    if(pid != 0)
+        return pid;
+
+    /* 子进程，恢复监管进程修改前的信号屏蔽字，监管进程退出时随之退出 */
+    sigprocmask(SIG_SETMASK, old_mask, NULL);
+    prctl(PR_SET_PDEATHSIG, SIGTERM);
+    if(getppid() != supervisor)
+        _exit(1);
+
+    if(config->cpu_affinity){
+        ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+        if(ncpu > 0){
+            CPU_ZERO(&cpu_set);
+            CPU_SET(worker_id % (unsigned long)ncpu, &cpu_set);
+            if(sched_setaffinity(0, sizeof(cpu_set), &cpu_set) < 0)
+                eh_warnfl("worker %u sched_setaffinity error %d", worker_id, errno);
+        }
+    }
+
+    ret = eh_global_init();
+    if(ret < 0){
+        eh_errfl("worker %u eh_global_init error %d", worker_id, ret);
+        _exit(1);
+    }
+    ret = config->worker_main(worker_id, config->arg);
+    eh_global_exit();
+    fflush(NULL);
+    _exit(ret < 0 ? 1 : (ret & 0xff));
+}
+
+static uint64_t prefork_now_ms(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000U + (uint64_t)ts.tv_nsec / 1000000U;
+}
+
+static void prefork_kill_all(const pid_t *pids, unsigned int cnt, int signo){
+    for(unsigned int i = 0; i < cnt; i++){
+        if(pids[i] > 0)
+            kill(pids[i], signo);
+    }
+}
+
+int eh_prefork_run(const struct eh_prefork_config *config){
+    pid_t pids[EH_CONFIG_PREFORK_WORKER_MAX];
+    uint64_t start_ms[EH_CONFIG_PREFORK_WORKER_MAX];
+    sigset_t mask, old_mask;
+    unsigned int alive = 0;
+    unsigned int id;
+    bool stopping = false;
+    bool abnormal;
+    int status;
+    pid_t pid;
+    int signo;
+
+    eh_param_assert(config);
+    eh_param_assert(config->worker_main);
+    eh_param_assert(config->worker_cnt > 0 && config->worker_cnt <= EH_CONFIG_PREFORK_WORKER_MAX);
+
+    /* 监管进程同步地等待信号，不需要事件循环 */
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGCHLD);
+    sigaddset(&mask, SIGTERM);
+    sigaddset(&mask, SIGINT);
+    if(sigprocmask(SIG_BLOCK, &mask, &old_mask) < 0)
+        return EH_RET_FAULT;
+
+    for(id = 0; id < config->worker_cnt; id++){
+        start_ms[id] = prefork_now_ms();
+        pids[id] = prefork_spawn(config, id, &old_mask);
+        if(pids[id] < 0){
+            eh_errfl("fork worker %u error %d", id, errno);
+            prefork_kill_all(pids, id, SIGTERM);
+            while(alive && wait(NULL) > 0)
+                alive--;
+            sigprocmask(SIG_SETMASK, &old_mask, NULL);
+            return EH_RET_FAULT;
+        }
+        alive++;
+    }
+
+    while(alive){
+        signo = sigwaitinfo(&mask, NULL);
+        if(signo < 0)
+            continue;
+        if(signo == SIGTERM || signo == SIGINT){
+            stopping = true;
+            prefork_kill_all(pids, config->worker_cnt, SIGTERM);
+            continue;
+        }
+        /* 多个SIGCHLD可能合并为一个，回收到没有为止 */
+        while((pid = waitpid(-1, &status, WNOHANG)) > 0){
+            for(id = 0; id < config->worker_cnt; id++){
+                if(pids[id] == pid)
+                    break;
+            }
+            if(id == config->worker_cnt)
+                continue;
+            pids[id] = -1;
+            alive--;
+            abnormal = WIFSIGNALED(status) || (WIFEXITED(status) && WEXITSTATUS(status) != 0);
+            if(stopping || !config->restart || !abnormal)
+                continue;
+            eh_warnfl("worker %u(pid %d) died, status %#x, restart", id, pid, status);
+            /* 启动后很快就退出的进程稍作延时再重启，避免崩溃循环占满CPU */
+            if(prefork_now_ms() - start_ms[id] < 1000)
+                usleep(100*1000);
+            start_ms[id] = prefork_now_ms();
+            pids[id] = prefork_spawn(config, id, &old_mask);
+            if(pids[id] < 0){
+                eh_errfl("restart worker %u error %d", id, errno);
+                continue;
+            }
+            alive++;
+        }
+    }
+
+    sigprocmask(SIG_SETMASK, &old_mask, NULL);
+    return EH_RET_OK;
+}
+
+int eh_prefork_reuseport_listen(const struct sockaddr *addr, socklen_t addrlen, int backlog){
+    int on = 1;
+    int fd;
+
+    eh_param_assert(addr);
+    fd = socket(addr->sa_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(fd < 0)
+        return EH_RET_FAULT;
+    if( setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) < 0 ||
+        setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) < 0 )
+        goto error;
+    if(bind(fd, addr, addrlen) < 0)
+        goto error;
+    if(listen(fd, backlog) < 0)
+        goto error;
+    return fd;
+error:
+    close(fd);
+    return EH_RET_FAULT;
+}
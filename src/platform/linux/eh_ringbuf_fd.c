@@ -0,0 +1,64 @@
+/**
+ * @file eh_ringbuf_fd.c
+ * @brief 环形缓冲区与文件描述符之间的直接搬运，借助 eh_ringbuf 的预留/获取接口拿到两段内存交给 readv/writev
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <eh.h>
+#include <eh_error.h>
+#include <eh_ringbuf.h>
+#include <eh_ringbuf_fd.h>
+
+static int ringbuf_to_iovec(const struct eh_ringbuf_iovec vec[2], struct iovec iov[2]){
+    iov[0].iov_base = vec[0].base;
+    iov[0].iov_len = (size_t)vec[0].len;
+    iov[1].iov_base = vec[1].base;
+    iov[1].iov_len = (size_t)vec[1].len;
+    return vec[1].len ? 2 : 1;
+}
+
+static int32_t ringbuf_fd_error(void){
+    return (errno == EAGAIN || errno == EWOULDBLOCK) ? EH_RET_AGAIN : EH_RET_FAULT;
+}
+
+int32_t eh_ringbuf_read_from_fd(eh_ringbuf_t *ringbuf, int fd){
+    struct eh_ringbuf_iovec vec[2];
+    struct iovec iov[2];
+    ssize_t ret;
+    int iovcnt;
+
+    if(eh_ringbuf_write_reserve(ringbuf, vec, eh_ringbuf_total_size(ringbuf)) == 0)
+        return EH_RET_BUSY;
+    iovcnt = ringbuf_to_iovec(vec, iov);
+    do{
+        ret = readv(fd, iov, iovcnt);
+    }while(ret < 0 && errno == EINTR);
+    if(ret < 0)
+        return ringbuf_fd_error();
+    return eh_ringbuf_write_commit(ringbuf, (int32_t)ret);
+}
+
+int32_t eh_ringbuf_write_to_fd(eh_ringbuf_t *ringbuf, int fd){
+    struct eh_ringbuf_iovec vec[2];
+    struct iovec iov[2];
+    ssize_t ret;
+    int iovcnt;
+
+    if(eh_ringbuf_read_acquire(ringbuf, vec, eh_ringbuf_total_size(ringbuf)) == 0)
+        return 0;
+    iovcnt = ringbuf_to_iovec(vec, iov);
+    do{
+        ret = writev(fd, iov, iovcnt);
+    }while(ret < 0 && errno == EINTR);
+    if(ret < 0)
+        return ringbuf_fd_error();
+    return eh_ringbuf_read_release(ringbuf, (int32_t)ret);
+}
@@ -0,0 +1,99 @@
+/**
+ * @file eh_ringbuf_mirror.c
+ * @brief Linux镜像环形缓冲区，先保留2倍大小的连续虚拟地址，再用MAP_FIXED把同一个memfd映射到前后两半，
+ *        映射完成后fd即可关闭，缓冲区的生命周期由映射维持
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <eh.h>
+#include <eh_error.h>
+#include <eh_mem.h>
+#include <eh_types.h>
+#include <eh_ringbuf.h>
+#include <eh_ringbuf_mirror.h>
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC                 0x0001U
+#endif
+
+/* 镜像法读写指针在[0, 2*size)内运行，size需要留出一位 */
+#define EH_RINGBUF_MIRROR_SIZE_MAX  (INT32_MAX / 2)
+
+static int ringbuf_memfd(size_t size){
+    int fd;
+#ifdef __NR_memfd_create
+    fd = (int)syscall(__NR_memfd_create, "eh_ringbuf", MFD_CLOEXEC);
+#else
+    errno = ENOSYS;
+    fd = -1;
+#endif
+    if(fd < 0)
+        return -1;
+    if(ftruncate(fd, (off_t)size) < 0){
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+eh_ringbuf_t* eh_ringbuf_create_mirrored(int32_t size){
+    eh_ringbuf_t *ringbuf;
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t map_size;
+    uint8_t *base;
+    int fd, ret;
+
+    if(size <= 0 || size > EH_RINGBUF_MIRROR_SIZE_MAX)
+        return eh_error_to_ptr(EH_RET_INVALID_PARAM);
+    map_size = eh_align_up((size_t)size, page_size);
+    if(map_size > EH_RINGBUF_MIRROR_SIZE_MAX)
+        return eh_error_to_ptr(EH_RET_INVALID_PARAM);
+    ringbuf = eh_malloc(sizeof(eh_ringbuf_t));
+    if(ringbuf == NULL)
+        return eh_error_to_ptr(EH_RET_MALLOC_ERROR);
+    fd = ringbuf_memfd(map_size);
+    if(fd < 0){
+        ret = errno == ENOSYS ? EH_RET_NOT_SUPPORTED : EH_RET_MALLOC_ERROR;
+        goto memfd_error;
+    }
+    /* 先占住连续的2倍地址空间，避免两次映射之间被其他映射插入 */
+    base = mmap(NULL, map_size << 1, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(base == MAP_FAILED){
+        ret = EH_RET_MALLOC_ERROR;
+        goto reserve_error;
+    }
+    if( mmap(base, map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+        mmap(base + map_size, map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ){
+        ret = EH_RET_MALLOC_ERROR;
+        goto map_error;
+    }
+    close(fd);
+    ringbuf->buf = base;
+    ringbuf->r = ringbuf->w = 0;
+    ringbuf->size = (int32_t)map_size;
+    ringbuf->flags = EH_RINGBUF_FLAGS_MIRRORED;
+    if((map_size & (map_size - 1)) == 0)
+        ringbuf->flags |= EH_RINGBUF_FLAGS_POW2;
+    return ringbuf;
+map_error:
+    munmap(base, map_size << 1);
+reserve_error:
+    close(fd);
+memfd_error:
+    eh_free(ringbuf);
+    return eh_error_to_ptr(ret);
+}
+
+void eh_ringbuf_destroy_mirrored(eh_ringbuf_t *ringbuf){
+    munmap(ringbuf->buf, (size_t)ringbuf->size << 1);
+    eh_free(ringbuf);
+}
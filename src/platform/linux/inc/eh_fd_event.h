@@ -0,0 +1,90 @@
+/**
+ * @file eh_fd_event.h
+ * @brief 将文件描述符的可读/可写状态包装为 eh_event_t，
+ *        可直接用于 eh_epoll_add_event、eh_event_wait_timeout 以及 eh_event_loop 的槽函数
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#ifndef _EH_FD_EVENT_H_
+#define _EH_FD_EVENT_H_
+
+#include <stdint.h>
+#include <eh.h>
+#include <eh_event.h>
+#include <epoll_hub.h>
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C"{
+#endif
+#endif /* __cplusplus */
+
+typedef struct eh_fd_event eh_fd_event_t;
+
+struct eh_fd_event{
+    eh_event_t                  readable;               /* 可读事件(包括对端关闭和错误) */
+    eh_event_t                  writable;               /* 可写事件(包括错误) */
+    struct epoll_fd_action      action;
+    int                         fd;
+    uint32_t                    revents;                /* 锁存的epoll事件位，由 eh_fd_event_wait 消费 */
+};
+
+/**
+ * @brief                   注册一个文件描述符，注册后fd的可读可写状态将以边沿触发的方式通知到事件上,
+ *                          fd应当为非阻塞模式，使用者在收到事件后应当读写到EAGAIN为止
+ * @param  fd_event         fd事件实例指针
+ * @param  fd               文件描述符
+ * @return int              成功返回0，失败返回负数错误码
+ */
+extern int eh_fd_event_init(eh_fd_event_t *fd_event, int fd);
+
+/**
+ * @brief                   注销文件描述符并唤醒所有正在等待的任务(等待者得到EH_RET_EVENT_ERROR)，
+ *                          不会关闭fd
+ * @param  fd_event         fd事件实例指针
+ */
+extern void eh_fd_event_clean(eh_fd_event_t *fd_event);
+
+/**
+ * @brief                   等待fd事件，与 eh_event_wait_timeout 不同的是，本函数会消费锁存的事件位，
+ *                          所以在等待前发生的边沿也不会丢失，若要同时等待读写，请将两个事件加入eh_epoll
+ * @param  fd_event         fd事件实例指针
+ * @param  events           要等待的事件 EPOLLIN 或 EPOLLOUT
+ * @param  timeout          超时时间，EH_TIME_FOREVER为永不超时, 0 为只检查锁存位
+ * @return int              成功返回发生的事件位(大于0)，失败返回负数错误码
+ */
+extern int __async eh_fd_event_wait(eh_fd_event_t *fd_event, uint32_t events, eh_sclock_t timeout);
+
+/**
+ * @brief                   获取fd可读事件
+ */
+#define eh_fd_event_readable(fd_event)          (&(fd_event)->readable)
+
+/**
+ * @brief                   获取fd可写事件
+ */
+#define eh_fd_event_writable(fd_event)          (&(fd_event)->writable)
+
+/**
+ * @brief                   获取fd
+ */
+#define eh_fd_event_fd(fd_event)                ((fd_event)->fd)
+
+/**
+ * @brief                   从事件指针获取fd事件实例，常用于 eh_epoll_wait 之后
+ */
+#define eh_fd_event_from_readable(e)            eh_container_of(e, eh_fd_event_t, readable)
+#define eh_fd_event_from_writable(e)            eh_container_of(e, eh_fd_event_t, writable)
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
+
+
+#endif // _EH_FD_EVENT_H_
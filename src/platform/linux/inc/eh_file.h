@@ -0,0 +1,109 @@
+/**
+ * @file eh_file.h
+ * @brief 异步文件IO，提供挂起任务的定位读写和fsync，不会阻塞事件循环，
+ *        同一轮循环内的请求会被合并为一次提交，内核支持时使用io_uring，否则使用eh_offload线程池
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#ifndef _EH_FILE_H_
+#define _EH_FILE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <eh.h>
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C"{
+#endif
+#endif /* __cplusplus */
+
+enum eh_file_backend{
+    EH_FILE_BACKEND_OFFLOAD,
+    EH_FILE_BACKEND_IO_URING,
+};
+
+struct eh_file_stat{
+    enum eh_file_backend        backend;
+    uint32_t                    pending_cnt;            /* 等待下一轮循环提交的请求数 */
+    uint32_t                    inflight_cnt;           /* 已提交未完成的请求数 */
+    uint64_t                    submit_cnt;             /* 累计提交请求数 */
+    uint64_t                    batch_cnt;              /* 累计提交批次数 */
+    uint64_t                    complete_cnt;           /* 累计完成请求数 */
+};
+
+/**
+ * @brief                   定位读，当前任务挂起直到完成，与pread相同，返回值可能小于len
+ * @param  fd               文件描述符
+ * @param  buf              缓冲区
+ * @param  len              读取长度
+ * @param  offset           文件偏移
+ * @return ssize_t          成功返回读取的字节数，失败返回EH_RET_FAULT并设置errno
+ */
+extern ssize_t __async eh_file_pread(int fd, void *buf, size_t len, off_t offset);
+
+/**
+ * @brief                   定位写，当前任务挂起直到完成，与pwrite相同，返回值可能小于len
+ * @param  fd               文件描述符
+ * @param  buf              缓冲区
+ * @param  len              写入长度
+ * @param  offset           文件偏移
+ * @return ssize_t          成功返回写入的字节数，失败返回EH_RET_FAULT并设置errno
+ */
+extern ssize_t __async eh_file_pwrite(int fd, const void *buf, size_t len, off_t offset);
+
+/**
+ * @brief                   将文件数据刷到存储设备，当前任务挂起直到完成
+ * @param  fd               文件描述符
+ * @param  datasync         为true时只同步数据(fdatasync)
+ * @return int              成功返回0，失败返回EH_RET_FAULT并设置errno
+ */
+extern int __async eh_file_fsync(int fd, bool datasync);
+
+/**
+ * @brief                   注册固定缓冲区，io_uring后端下内核只做一次页面固定，
+ *                          之后使用 eh_file_pread_fixed/eh_file_pwrite_fixed 不再有映射开销，
+ *                          同一时间只能注册一组，iov数组由调用者保证在注销前有效
+ * @param  iov              缓冲区数组
+ * @param  nr               缓冲区个数
+ * @return int              成功返回0，失败返回负数错误码
+ */
+extern int eh_file_buffers_register(const struct iovec *iov, unsigned int nr);
+
+/**
+ * @brief                   注销固定缓冲区，调用前必须保证没有使用固定缓冲区的请求在执行
+ */
+extern void eh_file_buffers_unregister(void);
+
+/**
+ * @brief                   使用固定缓冲区定位读，buf~buf+len必须位于第buf_index个注册的缓冲区内
+ * @return ssize_t          成功返回读取的字节数，失败返回负数错误码
+ */
+extern ssize_t __async eh_file_pread_fixed(int fd, void *buf, size_t len, off_t offset, unsigned int buf_index);
+
+/**
+ * @brief                   使用固定缓冲区定位写，buf~buf+len必须位于第buf_index个注册的缓冲区内
+ * @return ssize_t          成功返回写入的字节数，失败返回负数错误码
+ */
+extern ssize_t __async eh_file_pwrite_fixed(int fd, const void *buf, size_t len, off_t offset, unsigned int buf_index);
+
+/**
+ * @brief                   获取统计信息
+ * @param  stat             统计信息输出
+ */
+extern void eh_file_get_stat(struct eh_file_stat *stat);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
+
+
+#endif // _EH_FILE_H_
@@ -0,0 +1,66 @@
+/**
+ * @file eh_hugeheap.h
+ * @brief Linux大页堆，用mmap按2MiB对齐映射一段匿名内存并请求透明大页(THP)，
+ *        通过 eh_mem_heap_register 注册为自带内存管理的一个堆，配合 eh_malloc_from 存放大块缓冲区，
+ *        周期调用 eh_hugeheap_trim 将长期空闲的2MiB块以 MADV_FREE 归还内核，流量高峰过后RSS随实际用量回落，
+ *        仅在 EH_CONFIG_USE_LIBC_MEM_MANAGE 为0时可用，映射的区域在进程退出前不会解除
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#ifndef _EH_HUGEHEAP_H_
+#define _EH_HUGEHEAP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C"{
+#endif
+#endif /* __cplusplus */
+
+#define EH_HUGEHEAP_PAGE_SIZE       ((size_t)2*1024*1024)
+
+struct eh_hugeheap_stat{
+    size_t                      region_cnt;             /* 已映射的区域数 */
+    size_t                      mapped_size;            /* 所有区域的映射大小之和 */
+    size_t                      released_size;          /* 当前处于已归还状态的字节数 */
+    size_t                      release_cnt;            /* 累计归还的2MiB块数 */
+    size_t                      thp_region_cnt;         /* madvise(MADV_HUGEPAGE)成功的区域数 */
+};
+
+/**
+ * @brief                   映射一段大页内存并注册为堆，eh_global_init前后均可调用
+ * @param  size             大小，向上取整到2MiB
+ * @param  heap_flags       传给 eh_mem_heap_register 的 EH_MEM_HEAP_FLAGS_*，
+ *                          通常使用 EH_MEM_HEAP_FLAGS_EXCLUSIVE 只给 eh_malloc_from 使用
+ * @return int              成功返回堆id，失败返回负数错误码
+ */
+extern int eh_hugeheap_create(size_t size, uint32_t heap_flags);
+
+/**
+ * @brief                   扫描所有大页堆，连续 EH_CONFIG_HUGEHEAP_IDLE_TRIM_CNT 次都完全空闲的2MiB块
+ *                          以 MADV_FREE 归还(内核不支持时使用 MADV_DONTNEED)，之后被重新分配时由缺页自动补回，
+ *                          建议由定时器或空闲任务周期调用
+ * @return size_t           本次新归还的字节数
+ */
+extern size_t eh_hugeheap_trim(void);
+
+/**
+ * @brief                   获取大页堆的统计信息
+ * @param  stat             统计信息
+ */
+extern void eh_hugeheap_get_stat(struct eh_hugeheap_stat *stat);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
+
+
+#endif // _EH_HUGEHEAP_H_
@@ -0,0 +1,122 @@
+/**
+ * @file eh_offload.h
+ * @brief 阻塞调用卸载，将会阻塞的函数(getaddrinfo、fsync、大文件读写、压缩等)
+ *        放到工作线程池中执行，调用任务挂起等待，不会阻塞整个事件循环
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#ifndef _EH_OFFLOAD_H_
+#define _EH_OFFLOAD_H_
+
+#include <stdint.h>
+#include <eh.h>
+#include <eh_event.h>
+#include <eh_list.h>
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C"{
+#endif
+#endif /* __cplusplus */
+
+typedef struct eh_offload_job eh_offload_job_t;
+
+struct eh_offload_job{
+    struct eh_list_head         list_node;
+    void*                       (*fn)(void *arg);
+    void                        *arg;
+    void                        *result;
+    eh_event_t                  done_event;
+    eh_clock_t                  submit_time;
+    eh_clock_t                  start_time;
+    eh_clock_t                  finish_time;
+    int                         done;
+};
+
+struct eh_offload_stat{
+    uint32_t                    worker_cnt;             /* 已启动的工作线程数 */
+    uint32_t                    busy_worker_cnt;        /* 正在执行任务的工作线程数 */
+    uint32_t                    queue_depth;            /* 排队中的任务数 */
+    uint32_t                    max_queue_depth;        /* 历史最大排队数 */
+    uint64_t                    submit_cnt;             /* 累计提交数 */
+    uint64_t                    complete_cnt;           /* 累计完成数 */
+    eh_clock_t                  total_wait_time;        /* 累计排队时间 */
+    eh_clock_t                  total_run_time;         /* 累计执行时间 */
+    eh_clock_t                  max_latency;            /* 单个任务最大延迟(提交到完成) */
+};
+
+/**
+ * @brief                   初始化一个卸载任务，job可以放在调用者的栈上
+ * @param  job              任务实例指针
+ * @param  fn               要在工作线程中执行的函数，不得调用eventhub的任务相关接口
+ * @param  arg              fn的参数
+ */
+extern void eh_offload_job_init(eh_offload_job_t *job, void* (*fn)(void *arg), void *arg);
+
+/**
+ * @brief                   提交卸载任务，提交后到完成前job不得被释放，
+ *                          所以持有未完成job的任务不可被 eh_task_destroy 强制回收
+ * @param  job              任务实例指针
+ * @return int              成功返回0，失败返回负数错误码
+ */
+extern int eh_offload_job_submit(eh_offload_job_t *job);
+
+/**
+ * @brief                   批量提交卸载任务，只加锁一次，job_list中的job通过list_node链接，
+ *                          提交成功后job_list被清空
+ * @param  job_list         任务链表
+ * @return int              成功返回0，失败返回负数错误码(链表保持不变)
+ */
+extern int eh_offload_job_submit_list(struct eh_list_head *job_list);
+
+/**
+ * @brief                   等待卸载任务完成
+ * @param  job              任务实例指针
+ * @param  timeout          超时时间，EH_TIME_FOREVER为永不超时，超时返回后任务仍在执行，job不得被释放
+ * @return int              成功返回0，失败返回负数错误码
+ */
+extern int __async eh_offload_job_wait(eh_offload_job_t *job, eh_sclock_t timeout);
+
+/**
+ * @brief                   清理已完成的卸载任务
+ * @param  job              任务实例指针
+ */
+extern void eh_offload_job_clean(eh_offload_job_t *job);
+
+/**
+ * @brief                   在工作线程中执行 fn(arg)，当前任务挂起直到执行完成
+ * @param  fn               要执行的函数
+ * @param  arg              fn的参数
+ * @param  result           fn的返回值，可为NULL
+ * @return int              成功返回0，失败返回负数错误码
+ */
+extern int __async eh_offload(void* (*fn)(void *arg), void *arg, void **result);
+
+/**
+ * @brief                   获取线程池统计信息
+ * @param  stat             统计信息输出
+ */
+extern void eh_offload_get_stat(struct eh_offload_stat *stat);
+
+/**
+ * @brief                   判断卸载任务是否完成
+ */
+#define eh_offload_job_is_done(job)             (!!eh_read_once((job)->done))
+
+/**
+ * @brief                   任务延迟(提交到完成)，仅在完成后有效
+ */
+#define eh_offload_job_latency(job)             ((job)->finish_time - (job)->submit_time)
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
+
+
+#endif // _EH_OFFLOAD_H_
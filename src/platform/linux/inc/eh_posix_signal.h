@@ -0,0 +1,74 @@
+/**
+ * @file eh_posix_signal.h
+ * @brief 通过 signalfd 将POSIX信号(SIGTERM、SIGHUP、SIGCHLD等)转换为eh信号，
+ *        槽函数在任务上下文中执行，不受异步信号安全的限制
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#ifndef _EH_POSIX_SIGNAL_H_
+#define _EH_POSIX_SIGNAL_H_
+
+#include <stdint.h>
+#include <signal.h>
+#include <sys/signalfd.h>
+#include <eh.h>
+#include <eh_event.h>
+#include <eh_signal.h>
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C"{
+#endif
+#endif /* __cplusplus */
+
+struct eh_posix_signal_event{
+    eh_event_t                  event;
+    uint32_t                    cnt;                    /* 累计收到的次数，同一批次内的多次只通知一次 */
+    struct signalfd_siginfo     last_info;              /* 最近一次的信号信息 */
+};
+
+typedef EH_STRUCT_CUSTOM_SIGNAL(struct eh_posix_signal_event) eh_posix_signal_t;
+
+extern eh_posix_signal_t eh_posix_signal_table[_NSIG];
+
+/**
+ * @brief                   启用对某个POSIX信号的接管，信号将被屏蔽并改由signalfd接收，
+ *                          信号屏蔽字会被线程继承，所以应当在创建其他线程之前调用
+ * @param  signo            信号编号(SIGKILL和SIGSTOP无法接管)
+ * @return int              成功返回0，失败返回负数错误码
+ */
+extern int eh_posix_signal_enable(int signo);
+
+/**
+ * @brief                   取消接管，解除屏蔽后信号恢复原来的处理方式
+ * @param  signo            信号编号
+ */
+extern void eh_posix_signal_disable(int signo);
+
+/**
+ * @brief                   获取POSIX信号对应的eh信号，可直接用于 eh_signal_slot_connect 等接口
+ */
+#define eh_posix_signal(signo)                  (&eh_posix_signal_table[(signo)])
+
+/**
+ * @brief                   获取累计收到的次数
+ */
+#define eh_posix_signal_cnt(signo)              (eh_posix_signal(signo)->custom_event.cnt)
+
+/**
+ * @brief                   获取最近一次的信号信息(struct signalfd_siginfo *)
+ */
+#define eh_posix_signal_last_info(signo)        (&eh_posix_signal(signo)->custom_event.last_info)
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
+
+
+#endif // _EH_POSIX_SIGNAL_H_
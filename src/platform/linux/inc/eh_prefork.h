@@ -0,0 +1,64 @@
+/**
+ * @file eh_prefork.h
+ * @brief 多进程预派生模式，eventhub运行时是进程内单例，单个进程只能使用一个核心，
+ *        监管进程派生N个工作进程，每个工作进程独立 eh_global_init 并运行自己的事件循环，
+ *        配合 SO_REUSEPORT 由内核在各进程的监听套接字之间分配连接
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#ifndef _EH_PREFORK_H_
+#define _EH_PREFORK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/socket.h>
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C"{
+#endif
+#endif /* __cplusplus */
+
+struct eh_prefork_config{
+    unsigned int                worker_cnt;             /* 工作进程数，最多 EH_CONFIG_PREFORK_WORKER_MAX 个 */
+    bool                        cpu_affinity;           /* 为true时第i个工作进程绑定到第 i%ncpu 个CPU */
+    bool                        restart;                /* 为true时异常退出(被信号杀死或返回非0)的工作进程会被重新派生 */
+    /*
+     * 工作进程的主函数，在子进程的主任务中执行，调用前已完成 eh_global_init，
+     * 返回后执行 eh_global_exit 并以返回值退出
+     */
+    int                         (*worker_main)(unsigned int worker_id, void *arg);
+    void                        *arg;
+};
+
+/**
+ * @brief                   运行监管进程，派生工作进程并监管，必须在 eh_global_init 之前调用，
+ *                          收到SIGTERM/SIGINT后向所有工作进程转发SIGTERM并等待其退出，
+ *                          所有工作进程正常退出后返回
+ * @param  config           配置
+ * @return int              成功返回0，失败返回负数错误码
+ */
+extern int eh_prefork_run(const struct eh_prefork_config *config);
+
+/**
+ * @brief                   创建一个开启了 SO_REUSEPORT 的非阻塞监听套接字，
+ *                          每个工作进程在自己的进程内创建一个，绑定同一个地址
+ * @param  addr             监听地址
+ * @param  addrlen          地址长度
+ * @param  backlog          listen的backlog
+ * @return int              成功返回fd，失败返回负数错误码
+ */
+extern int eh_prefork_reuseport_listen(const struct sockaddr *addr, socklen_t addrlen, int backlog);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
+
+
+#endif // _EH_PREFORK_H_
@@ -0,0 +1,52 @@
+/**
+ * @file eh_ringbuf_fd.h
+ * @brief 环形缓冲区与文件描述符之间直接搬运数据，用 readv/writev 一次系统调用处理(最多)两段连续内存，
+ *        不需要中间缓冲区，适合非阻塞socket/pipe在每次可读/可写唤醒时各搬运一次
+ *        使用限制: 与 eh_ringbuf 相同，read_from_fd 只能由写者调用，write_to_fd 只能由读者调用
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#ifndef _EH_RINGBUF_FD_H_
+#define _EH_RINGBUF_FD_H_
+
+#include <stdint.h>
+#include <eh_ringbuf.h>
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C"{
+#endif
+#endif /* __cplusplus */
+
+/**
+ * @brief                           从fd读取数据直接写入环形缓冲区的空闲空间，被信号打断时自动重试
+ * @param  ringbuf                  环形缓冲区指针
+ * @param  fd                       文件描述符
+ * @return int32_t                  成功返回读到的字节数，对端关闭(EOF)返回0，
+ *                                  缓冲区已满返回 EH_RET_BUSY，非阻塞fd暂无数据返回 EH_RET_AGAIN，
+ *                                  其他错误返回 EH_RET_FAULT，此时errno保留系统调用的错误码
+ */
+extern int32_t eh_ringbuf_read_from_fd(eh_ringbuf_t *ringbuf, int fd);
+
+/**
+ * @brief                           把环形缓冲区中的数据直接写到fd，只释放实际写出的部分，被信号打断时自动重试
+ * @param  ringbuf                  环形缓冲区指针
+ * @param  fd                       文件描述符
+ * @return int32_t                  成功返回写出的字节数，缓冲区为空时返回0，
+ *                                  非阻塞fd暂时不可写返回 EH_RET_AGAIN，
+ *                                  其他错误返回 EH_RET_FAULT，此时errno保留系统调用的错误码
+ */
+extern int32_t eh_ringbuf_write_to_fd(eh_ringbuf_t *ringbuf, int fd);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
+
+
+#endif // _EH_RINGBUF_FD_H_
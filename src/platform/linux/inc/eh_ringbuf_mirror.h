@@ -0,0 +1,46 @@
+/**
+ * @file eh_ringbuf_mirror.h
+ * @brief Linux镜像环形缓冲区，用memfd申请一段共享内存并在相邻的两段虚拟地址上各映射一次，
+ *        缓冲区末尾之后紧跟着缓冲区开头的内容，读写、预留/获取和 eh_ringbuf_peek 都只返回一段连续内存，
+ *        协议解析可以直接在缓冲区中进行而不用关心绕回，其余接口与 eh_ringbuf 完全相同
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#ifndef _EH_RINGBUF_MIRROR_H_
+#define _EH_RINGBUF_MIRROR_H_
+
+#include <stdint.h>
+#include <eh_ringbuf.h>
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C"{
+#endif
+#endif /* __cplusplus */
+
+/**
+ * @brief                           创建镜像环形缓冲区
+ * @param  size                     环形缓冲区大小，向上取整到页大小，实际大小用 eh_ringbuf_total_size 获取
+ * @return eh_ringbuf_t*            返回值请使用eh_ptr_to_error来判断是否创建成功，
+ *                                  内核不支持memfd时返回 EH_RET_NOT_SUPPORTED
+ */
+extern eh_ringbuf_t* eh_ringbuf_create_mirrored(int32_t size);
+
+/**
+ * @brief                           销毁镜像环形缓冲区，解除两段映射
+ * @param  ringbuf                  eh_ringbuf_create_mirrored 创建的环形缓冲区指针
+ */
+extern void eh_ringbuf_destroy_mirrored(eh_ringbuf_t *ringbuf);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
+
+
+#endif // _EH_RINGBUF_MIRROR_H_
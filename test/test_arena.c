@@ -0,0 +1,195 @@
+/**
+ * @file test_arena.c
+ * @brief arena分配器测试，检查分配对齐、reset后块的复用、高水位统计、超大请求失败、绑定任务后随任务销毁释放，
+ *        并对比一次请求内大量小块临时内存使用arena与逐个eh_malloc/eh_free的耗时
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <eh.h>
+#include <eh_config.h>
+#include <eh_debug.h>
+#include <eh_error.h>
+#include <eh_mem.h>
+#include <eh_arena.h>
+
+#define TEST_CHUNK_SIZE         (4096)
+#define TEST_REQ_ALLOC_CNT      (64)
+#define TEST_BENCH_ROUND        (20000)
+
+static void *ptrs[TEST_REQ_ALLOC_CNT];
+
+void stdout_write(void *stream, const uint8_t *buf, size_t size){
+    (void)stream;
+    printf("%.*s", (int)size, (const char*)buf);
+}
+
+static uint64_t now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* 模拟一次请求中的临时分配，大小在16~200之间变化 */
+static size_t req_size(int i){
+    return 16 + (size_t)((i * 37) % 185);
+}
+
+static int test_basic(void){
+    struct eh_arena_stat stat;
+    eh_arena_t arena;
+    uint8_t *p;
+    size_t high_water = 0;
+    int round, i;
+
+    arena = eh_arena_create(TEST_CHUNK_SIZE);
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(arena) < 0, return -1);
+    for(round = 0; round < 3; round++){
+        for(i = 0; i < TEST_REQ_ALLOC_CNT; i++){
+            p = eh_arena_alloc(arena, req_size(i));
+            EH_DBG_ERROR_EXEC(p == NULL, goto error);
+            EH_DBG_ERROR_EXEC(((uintptr_t)p & (sizeof(void*)*2 - 1)) != 0, goto error);
+            memset(p, i, req_size(i));
+            ptrs[i] = p;
+        }
+        for(i = 0; i < TEST_REQ_ALLOC_CNT; i++)
+            EH_DBG_ERROR_EXEC(((uint8_t*)ptrs[i])[req_size(i)-1] != (uint8_t)i, goto error);
+        /* 超过块大小的分配单独成块 */
+        p = eh_arena_alloc(arena, TEST_CHUNK_SIZE * 2);
+        EH_DBG_ERROR_EXEC(p == NULL, goto error);
+        memset(p, 0xa5, TEST_CHUNK_SIZE * 2);
+        eh_arena_get_stat(arena, &stat);
+        EH_DBG_ERROR_EXEC(stat.alloc_cnt != TEST_REQ_ALLOC_CNT + 1, goto error);
+        if(round == 0)
+            high_water = stat.high_water;
+        eh_arena_reset(arena);
+    }
+    /* 每轮分配序列相同，reset后块全部复用，不再向堆申请 */
+    eh_arena_get_stat(arena, &stat);
+    eh_infofl("chunk_cnt %lu capacity %lu high_water %lu", (unsigned long)stat.chunk_cnt,
+        (unsigned long)stat.capacity, (unsigned long)stat.high_water);
+    EH_DBG_ERROR_EXEC(stat.used != 0 || stat.alloc_cnt != 0, goto error);
+    EH_DBG_ERROR_EXEC(stat.high_water != high_water, goto error);
+    EH_DBG_ERROR_EXEC(stat.capacity < stat.high_water, goto error);
+    EH_DBG_ERROR_EXEC(stat.chunk_cnt > 4, goto error);
+    eh_arena_destroy(arena);
+    return 0;
+error:
+    eh_arena_destroy(arena);
+    return -1;
+}
+
+static int test_overflow(void){
+    struct eh_arena_stat stat;
+    eh_arena_t arena;
+
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(eh_arena_create(SIZE_MAX)) != EH_RET_INVALID_PARAM, return -1);
+    arena = eh_arena_create(TEST_CHUNK_SIZE);
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(arena) < 0, return -1);
+    /* 对齐后会回绕到0或加上块头后溢出的大小直接失败，不申请块 */
+    EH_DBG_ERROR_EXEC(eh_arena_alloc(arena, SIZE_MAX) != NULL, goto error);
+    EH_DBG_ERROR_EXEC(eh_arena_alloc(arena, SIZE_MAX - sizeof(void*)*2 + 2) != NULL, goto error);
+    EH_DBG_ERROR_EXEC(eh_arena_alloc(arena, SIZE_MAX - sizeof(void*)*2 - 8) != NULL, goto error);
+    eh_arena_get_stat(arena, &stat);
+    EH_DBG_ERROR_EXEC(stat.chunk_cnt != 0 || stat.alloc_cnt != 0 || stat.used != 0, goto error);
+    EH_DBG_ERROR_EXEC(eh_arena_alloc(arena, 16) == NULL, goto error);
+    eh_arena_destroy(arena);
+    return 0;
+error:
+    eh_arena_destroy(arena);
+    return -1;
+}
+
+static int task_arena(void *arg){
+    eh_arena_t arena;
+    (void)arg;
+    arena = eh_arena_create(TEST_CHUNK_SIZE);
+    if(eh_ptr_to_error(arena) < 0)
+        return -1;
+    eh_arena_bind_task(arena, eh_task_self());
+    for(int i = 0; i < TEST_REQ_ALLOC_CNT * 4; i++){
+        if(eh_arena_alloc(arena, req_size(i)) == NULL)
+            return -1;
+    }
+    /* 不主动销毁，交由任务销毁时释放 */
+    return 0;
+}
+
+#if (defined(EH_CONFIG_USE_LIBC_MEM_MANAGE)) && (EH_CONFIG_USE_LIBC_MEM_MANAGE == 1)
+#define heap_free_size()        ((size_t)0)
+#else
+static size_t heap_free_size(void){
+    struct eh_mem_heap_info info;
+    eh_mem_get_heap_info(&info);
+    return info.free_size;
+}
+#endif
+
+static int test_bind_task(void){
+    eh_task_t *task;
+    size_t free_size;
+    int task_ret = -1;
+    int ret;
+
+    free_size = heap_free_size();
+    task = eh_task_create("task_arena", 0, 8*1024, NULL, task_arena);
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(task) < 0, return -1);
+    ret = __await eh_task_join(task, &task_ret, EH_TIME_FOREVER);
+    EH_DBG_ERROR_EXEC(ret < 0 || task_ret != 0, return -1);
+    /* 任务连同绑定的arena全部释放，堆恢复原状 */
+    EH_DBG_ERROR_EXEC(heap_free_size() != free_size, return -1);
+    return 0;
+}
+
+static void bench(void){
+    eh_arena_t arena;
+    uint64_t t, malloc_ns, arena_ns;
+    int r, i;
+
+    t = now_ns();
+    for(r = 0; r < TEST_BENCH_ROUND; r++){
+        for(i = 0; i < TEST_REQ_ALLOC_CNT; i++)
+            ptrs[i] = eh_malloc(req_size(i));
+        for(i = 0; i < TEST_REQ_ALLOC_CNT; i++)
+            eh_free(ptrs[i]);
+    }
+    malloc_ns = now_ns() - t;
+
+    arena = eh_arena_create(TEST_CHUNK_SIZE);
+    if(eh_ptr_to_error(arena) < 0)
+        return ;
+    t = now_ns();
+    for(r = 0; r < TEST_BENCH_ROUND; r++){
+        for(i = 0; i < TEST_REQ_ALLOC_CNT; i++)
+            ptrs[i] = eh_arena_alloc(arena, req_size(i));
+        eh_arena_reset(arena);
+    }
+    arena_ns = now_ns() - t;
+    eh_arena_destroy(arena);
+
+    eh_infofl("per request(%d allocs): eh_malloc/eh_free %lluns, arena %lluns", TEST_REQ_ALLOC_CNT,
+        (unsigned long long)(malloc_ns / TEST_BENCH_ROUND), (unsigned long long)(arena_ns / TEST_BENCH_ROUND));
+}
+
+int main(void){
+    int fail = 0;
+
+    eh_global_init();
+    if(test_basic() < 0)
+        fail++;
+    if(test_overflow() < 0)
+        fail++;
+    if(test_bind_task() < 0)
+        fail++;
+    bench();
+    eh_infofl("fail=%d", fail);
+    eh_global_exit();
+    return fail ? -1 : 0;
+}
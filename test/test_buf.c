@@ -0,0 +1,213 @@
+/**
+ * @file test_buf.c
+ * @brief eh_buf测试，检查切片共享存储块、最后一个视图释放时归还内存池、链的追加/消费/聚集拷贝、
+ *        跨任务交出视图，并对比经过 eh_ringbuf 拷贝传递与 eh_buf 零拷贝传递大块数据的耗时
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <eh.h>
+#include <eh_config.h>
+#include <eh_debug.h>
+#include <eh_error.h>
+#include <eh_mem.h>
+#include <eh_ringbuf.h>
+#include <eh_buf.h>
+
+#define TEST_BUF_SIZE           (2048)
+#define TEST_PAYLOAD_SIZE       (64*1024)
+#define TEST_BENCH_ROUND        (2000)
+
+static eh_buf_pool_t pool;
+static struct eh_buf_chain handoff;
+
+void stdout_write(void *stream, const uint8_t *buf, size_t size){
+    (void)stream;
+    printf("%.*s", (int)size, (const char*)buf);
+}
+
+static uint64_t now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static size_t pool_inuse(void){
+    struct eh_buf_pool_stat stat;
+    eh_buf_pool_get_stat(pool, &stat);
+    return stat.inuse_cnt;
+}
+
+static int test_slice(void){
+    eh_buf_t *buf, *head, *body;
+    int i;
+
+    buf = eh_buf_pool_alloc(pool);
+    EH_DBG_ERROR_EXEC(buf == NULL, return -1);
+    EH_DBG_ERROR_EXEC(eh_buf_len(buf) != TEST_BUF_SIZE || eh_buf_is_shared(buf), goto error);
+    for(i = 0; i < TEST_BUF_SIZE; i++)
+        eh_buf_data(buf)[i] = (uint8_t)i;
+    head = eh_buf_slice(buf, 0, 16);
+    body = eh_buf_slice(buf, 16, TEST_BUF_SIZE - 16);
+    EH_DBG_ERROR_EXEC(head == NULL || body == NULL, goto error);
+    EH_DBG_ERROR_EXEC(eh_buf_slice(buf, 16, TEST_BUF_SIZE) != NULL, goto error);
+    /* 切片与原视图共享数据 */
+    EH_DBG_ERROR_EXEC(eh_buf_data(body) != eh_buf_data(buf) + 16 || !eh_buf_is_shared(body), goto error);
+    eh_buf_unref(buf);
+    EH_DBG_ERROR_EXEC(pool_inuse() != 1, return -1);
+    EH_DBG_ERROR_EXEC(eh_buf_data(head)[15] != 15 || eh_buf_data(body)[0] != 16, return -1);
+    eh_buf_unref(head);
+    EH_DBG_ERROR_EXEC(eh_buf_is_shared(body), return -1);
+    eh_buf_pull(body, 100);
+    eh_buf_trim(body, 10);
+    EH_DBG_ERROR_EXEC(eh_buf_len(body) != 10 || eh_buf_data(body)[0] != 116, return -1);
+    eh_buf_unref(body);
+    /* 最后一个视图释放后存储块回到内存池 */
+    EH_DBG_ERROR_EXEC(pool_inuse() != 0, return -1);
+    return 0;
+error:
+    eh_buf_unref(buf);
+    return -1;
+}
+
+static int test_chain(void){
+    struct eh_buf_chain chain, tail;
+    eh_buf_t *a, *b, *c;
+    uint8_t out[12];
+
+    eh_buf_chain_init(&chain);
+    eh_buf_chain_init(&tail);
+    a = eh_buf_alloc(4);
+    b = eh_buf_alloc(4);
+    c = eh_buf_alloc(4);
+    EH_DBG_ERROR_EXEC(a == NULL || b == NULL || c == NULL, return -1);
+    memcpy(eh_buf_data(a), "abcd", 4);
+    memcpy(eh_buf_data(b), "efgh", 4);
+    memcpy(eh_buf_data(c), "ijkl", 4);
+    eh_buf_chain_append(&chain, a);
+    eh_buf_chain_append(&chain, b);
+    eh_buf_chain_append(&tail, c);
+    eh_buf_chain_splice(&chain, &tail);
+    EH_DBG_ERROR_EXEC(chain.len != 12 || chain.cnt != 3 || tail.head != NULL, goto error);
+    EH_DBG_ERROR_EXEC(eh_buf_chain_copy_out(&chain, 2, out, sizeof(out)) != 10, goto error);
+    EH_DBG_ERROR_EXEC(memcmp(out, "cdefghijkl", 10) != 0, goto error);
+    /* 跨视图消费，完全消费的视图被释放 */
+    eh_buf_chain_pull(&chain, 6);
+    EH_DBG_ERROR_EXEC(chain.len != 6 || chain.cnt != 2 || chain.head != b, goto error);
+    EH_DBG_ERROR_EXEC(eh_buf_chain_copy_out(&chain, 0, out, sizeof(out)) != 6, goto error);
+    EH_DBG_ERROR_EXEC(memcmp(out, "ghijkl", 6) != 0, goto error);
+    eh_buf_chain_clear(&chain);
+    EH_DBG_ERROR_EXEC(chain.head != NULL || chain.len != 0, return -1);
+    return 0;
+error:
+    eh_buf_chain_clear(&chain);
+    return -1;
+}
+
+static int task_producer(void *arg){
+    eh_buf_t *buf, *hdr, *payload;
+    (void)arg;
+    buf = eh_buf_pool_alloc(pool);
+    if(buf == NULL)
+        return -1;
+    memset(eh_buf_data(buf), 0x11, 8);
+    memset(eh_buf_data(buf) + 8, 0x22, TEST_BUF_SIZE - 8);
+    hdr = eh_buf_slice(buf, 0, 8);
+    payload = eh_buf_slice(buf, 8, TEST_BUF_SIZE - 8);
+    eh_buf_unref(buf);
+    if(hdr == NULL || payload == NULL){
+        eh_buf_unref(hdr);
+        eh_buf_unref(payload);
+        return -1;
+    }
+    /* 只交出视图，数据不拷贝 */
+    eh_buf_chain_append(&handoff, hdr);
+    eh_buf_chain_append(&handoff, payload);
+    return 0;
+}
+
+static int test_handoff(void){
+    eh_task_t *task;
+    int task_ret = -1;
+    int ret;
+
+    eh_buf_chain_init(&handoff);
+    task = eh_task_create("producer", 0, 8*1024, NULL, task_producer);
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(task) < 0, return -1);
+    ret = __await eh_task_join(task, &task_ret, EH_TIME_FOREVER);
+    EH_DBG_ERROR_EXEC(ret < 0 || task_ret != 0, return -1);
+    EH_DBG_ERROR_EXEC(handoff.len != TEST_BUF_SIZE || handoff.cnt != 2, goto error);
+    EH_DBG_ERROR_EXEC(eh_buf_data(handoff.head)[7] != 0x11 || eh_buf_data(handoff.head->next)[0] != 0x22, goto error);
+    EH_DBG_ERROR_EXEC(pool_inuse() != 1, goto error);
+    eh_buf_chain_clear(&handoff);
+    EH_DBG_ERROR_EXEC(pool_inuse() != 0, return -1);
+    return 0;
+error:
+    eh_buf_chain_clear(&handoff);
+    return -1;
+}
+
+static void bench(void){
+    static uint8_t payload[TEST_PAYLOAD_SIZE], sink[TEST_PAYLOAD_SIZE];
+    eh_ringbuf_t *ringbuf;
+    eh_buf_t *buf, *view;
+    uint64_t t, copy_ns, zc_ns;
+    int r;
+
+    ringbuf = eh_ringbuf_create(TEST_PAYLOAD_SIZE, NULL);
+    if(eh_ptr_to_error(ringbuf) < 0)
+        return ;
+    memset(payload, 0x5a, sizeof(payload));
+    t = now_ns();
+    for(r = 0; r < TEST_BENCH_ROUND; r++){
+        eh_ringbuf_write(ringbuf, payload, TEST_PAYLOAD_SIZE);
+        eh_ringbuf_read(ringbuf, sink, TEST_PAYLOAD_SIZE);
+    }
+    copy_ns = now_ns() - t;
+    eh_ringbuf_destroy(ringbuf);
+
+    t = now_ns();
+    for(r = 0; r < TEST_BENCH_ROUND; r++){
+        /* 生产者填充一次，消费者拿到视图直接读 */
+        buf = eh_buf_alloc(TEST_PAYLOAD_SIZE);
+        if(buf == NULL)
+            break;
+        view = eh_buf_ref(buf);
+        eh_buf_unref(buf);
+        sink[r % TEST_PAYLOAD_SIZE] = eh_buf_data(view)[r % TEST_PAYLOAD_SIZE];
+        eh_buf_unref(view);
+    }
+    zc_ns = now_ns() - t;
+    eh_infofl("hand off %d bytes: ringbuf copy %lluns, eh_buf %lluns", TEST_PAYLOAD_SIZE,
+        (unsigned long long)(copy_ns / TEST_BENCH_ROUND), (unsigned long long)(zc_ns / TEST_BENCH_ROUND));
+}
+
+int main(void){
+    int fail = 0;
+
+    eh_global_init();
+    pool = eh_buf_pool_create(TEST_BUF_SIZE, 8);
+    if(eh_ptr_to_error(pool) < 0){
+        eh_errfl("eh_buf_pool_create failed");
+        eh_global_exit();
+        return -1;
+    }
+    if(test_slice() < 0)
+        fail++;
+    if(test_chain() < 0)
+        fail++;
+    if(test_handoff() < 0)
+        fail++;
+    eh_buf_pool_destroy(pool);
+    bench();
+    eh_infofl("fail=%d", fail);
+    eh_global_exit();
+    return fail ? -1 : 0;
+}
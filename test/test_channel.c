@@ -0,0 +1,247 @@
+/**
+ * @file test_channel.c
+ * @brief 通道测试，检查有界通道的满/空/超时、无界通道扩容后保序、关闭后的返回值、
+ *        其他线程try_send唤醒接收任务，并对比 ringbuf+信号量、逐个收发、成批收发三种流水线的耗时和调度次数
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <eh.h>
+#include <eh_debug.h>
+#include <eh_error.h>
+#include <eh_ringbuf.h>
+#include <eh_sem.h>
+#include <eh_channel.h>
+
+#define TEST_CAPACITY           (256)
+#define TEST_BATCH              (64)
+#define TEST_BENCH_MSG_CNT      (1000000U)
+
+enum bench_mode{
+    BENCH_MODE_RINGBUF_SEM,
+    BENCH_MODE_CHANNEL,
+    BENCH_MODE_CHANNEL_BATCH,
+};
+
+static eh_channel_t channel;
+static eh_ringbuf_t *bench_ringbuf;
+static eh_sem_t bench_data_sem, bench_space_sem;
+
+void stdout_write(void *stream, const uint8_t *buf, size_t size){
+    (void)stream;
+    printf("%.*s", (int)size, (const char*)buf);
+}
+
+static uint64_t now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int test_bounded(void){
+    uint32_t v, out[8];
+
+    channel = eh_channel_create(sizeof(uint32_t), 4);
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(channel) < 0, return -1);
+    EH_DBG_ERROR_EXEC(__await eh_channel_recv(channel, &v, 0) != EH_RET_TIMEOUT, goto error);
+    EH_DBG_ERROR_EXEC(__await eh_channel_recv(channel, &v, (eh_sclock_t)eh_msec_to_clock(10)) != EH_RET_TIMEOUT, goto error);
+    for(v = 0; v < 3; v++)
+        EH_DBG_ERROR_EXEC(__await eh_channel_send(channel, &v, 0) != 0, goto error);
+    /* 空间不足时只放入放得下的部分 */
+    EH_DBG_ERROR_EXEC(__await eh_channel_send_many(channel, out, 8, 0) != 1, goto error);
+    EH_DBG_ERROR_EXEC(eh_channel_len(channel) != 4, goto error);
+    EH_DBG_ERROR_EXEC(eh_channel_try_send(channel, &v) != EH_RET_BUSY, goto error);
+    EH_DBG_ERROR_EXEC(__await eh_channel_send(channel, &v, (eh_sclock_t)eh_msec_to_clock(10)) != EH_RET_TIMEOUT, goto error);
+    EH_DBG_ERROR_EXEC(__await eh_channel_recv_many(channel, out, 8, 0) != 4, goto error);
+    EH_DBG_ERROR_EXEC(out[0] != 0 || out[2] != 2, goto error);
+    eh_channel_destroy(channel);
+    return 0;
+error:
+    eh_channel_destroy(channel);
+    return -1;
+}
+
+static int test_unbounded(void){
+    uint32_t v, out[TEST_BATCH];
+    uint32_t next = 0;
+    int n;
+
+    channel = eh_channel_create(sizeof(uint32_t), 0);
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(channel) < 0, return -1);
+    /* 取走一部分让读位置不在开头，扩容时需要处理绕回 */
+    for(v = 0; v < 10; v++)
+        EH_DBG_ERROR_EXEC(__await eh_channel_send(channel, &v, 0) != 0, goto error);
+    EH_DBG_ERROR_EXEC(__await eh_channel_recv_many(channel, out, 8, 0) != 8, goto error);
+    next = 8;
+    for(; v < 1000; v++)
+        EH_DBG_ERROR_EXEC(__await eh_channel_send(channel, &v, 0) != 0, goto error);
+    EH_DBG_ERROR_EXEC(eh_channel_len(channel) != 992, goto error);
+    while(eh_channel_len(channel)){
+        n = __await eh_channel_recv_many(channel, out, TEST_BATCH, 0);
+        EH_DBG_ERROR_EXEC(n <= 0, goto error);
+        for(int i = 0; i < n; i++)
+            EH_DBG_ERROR_EXEC(out[i] != next++, goto error);
+    }
+    /* 关闭后发送失败，剩余数据取完后接收失败 */
+    EH_DBG_ERROR_EXEC(__await eh_channel_send(channel, &v, 0) != 0, goto error);
+    eh_channel_close(channel);
+    EH_DBG_ERROR_EXEC(__await eh_channel_send(channel, &v, 0) != EH_RET_INVALID_STATE, goto error);
+    EH_DBG_ERROR_EXEC(__await eh_channel_recv(channel, out, EH_TIME_FOREVER) != 0 || out[0] != 1000, goto error);
+    EH_DBG_ERROR_EXEC(__await eh_channel_recv(channel, out, EH_TIME_FOREVER) != EH_RET_INVALID_STATE, goto error);
+    eh_channel_destroy(channel);
+    return 0;
+error:
+    eh_channel_destroy(channel);
+    return -1;
+}
+
+static void* thread_try_send(void *arg){
+    (void)arg;
+    for(uint32_t v = 0; v < 100; v++){
+        while(eh_channel_try_send(channel, &v) == EH_RET_BUSY)
+            usleep(100);
+    }
+    eh_channel_close(channel);
+    return NULL;
+}
+
+static int test_thread(void){
+    pthread_t thread_id;
+    uint32_t out[TEST_BATCH], next = 0;
+    int n;
+
+    channel = eh_channel_create(sizeof(uint32_t), 8);
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(channel) < 0, return -1);
+    EH_DBG_ERROR_EXEC(pthread_create(&thread_id, NULL, thread_try_send, NULL) != 0, goto error);
+    while((n = __await eh_channel_recv_many(channel, out, TEST_BATCH, EH_TIME_FOREVER)) > 0){
+        for(int i = 0; i < n; i++)
+            EH_DBG_ERROR_EXEC(out[i] != next++, next = UINT32_MAX; break);
+    }
+    pthread_join(thread_id, NULL);
+    EH_DBG_ERROR_EXEC(n != EH_RET_INVALID_STATE || next != 100, goto error);
+    eh_channel_destroy(channel);
+    return 0;
+error:
+    eh_channel_destroy(channel);
+    return -1;
+}
+
+static int task_bench_producer(void *arg){
+    enum bench_mode mode = (enum bench_mode)(intptr_t)arg;
+    uint32_t batch[TEST_BATCH];
+    uint32_t v = 0;
+    int n;
+
+    while(v < TEST_BENCH_MSG_CNT){
+        switch(mode){
+            case BENCH_MODE_RINGBUF_SEM:
+                if(__await eh_sem_wait(bench_space_sem, EH_TIME_FOREVER) < 0)
+                    return -1;
+                eh_ringbuf_write(bench_ringbuf, (const uint8_t *)&v, sizeof(v));
+                eh_sem_post(bench_data_sem);
+                v++;
+                break;
+            case BENCH_MODE_CHANNEL:
+                if(__await eh_channel_send(channel, &v, EH_TIME_FOREVER) < 0)
+                    return -1;
+                v++;
+                break;
+            case BENCH_MODE_CHANNEL_BATCH:
+                n = 0;
+                for(uint32_t i = v; i < TEST_BENCH_MSG_CNT && n < TEST_BATCH; i++)
+                    batch[n++] = i;
+                n = __await eh_channel_send_many(channel, batch, (uint32_t)n, EH_TIME_FOREVER);
+                if(n < 0)
+                    return -1;
+                v += (uint32_t)n;
+                break;
+        }
+    }
+    return 0;
+}
+
+static int bench_run(enum bench_mode mode, uint64_t *ns, unsigned int *dispatch){
+    uint32_t batch[TEST_BATCH], next = 0;
+    unsigned int dispatch_start;
+    eh_task_t *task;
+    uint64_t t;
+    int n, task_ret = -1;
+
+    if(mode == BENCH_MODE_RINGBUF_SEM){
+        bench_ringbuf = eh_ringbuf_create(TEST_CAPACITY * sizeof(uint32_t), NULL);
+        bench_data_sem = eh_sem_create(0);
+        bench_space_sem = eh_sem_create(TEST_CAPACITY);
+    }else{
+        channel = eh_channel_create(sizeof(uint32_t), TEST_CAPACITY);
+    }
+    dispatch_start = eh_task_dispatch_cnt();
+    t = now_ns();
+    task = eh_task_create("producer", 0, 16*1024, (void*)(intptr_t)mode, task_bench_producer);
+    while(next < TEST_BENCH_MSG_CNT){
+        if(mode == BENCH_MODE_RINGBUF_SEM){
+            if(__await eh_sem_wait(bench_data_sem, EH_TIME_FOREVER) < 0)
+                break;
+            eh_ringbuf_read(bench_ringbuf, (uint8_t *)batch, sizeof(uint32_t));
+            eh_sem_post(bench_space_sem);
+            n = 1;
+        }else if(mode == BENCH_MODE_CHANNEL){
+            n = __await eh_channel_recv(channel, batch, EH_TIME_FOREVER) == 0 ? 1 : -1;
+        }else{
+            n = __await eh_channel_recv_many(channel, batch, TEST_BATCH, EH_TIME_FOREVER);
+        }
+        if(n < 0 || batch[0] != next)
+            break;
+        next += (uint32_t)n;
+    }
+    *ns = now_ns() - t;
+    *dispatch = eh_task_dispatch_cnt() - dispatch_start;
+    __await eh_task_join(task, &task_ret, EH_TIME_FOREVER);
+    if(mode == BENCH_MODE_RINGBUF_SEM){
+        eh_ringbuf_destroy(bench_ringbuf);
+        eh_sem_destroy(bench_data_sem);
+        eh_sem_destroy(bench_space_sem);
+    }else{
+        eh_channel_destroy(channel);
+    }
+    return next == TEST_BENCH_MSG_CNT && task_ret == 0 ? 0 : -1;
+}
+
+static int bench(void){
+    static const char *name[] = {"ringbuf+sem", "channel", "channel batch"};
+    unsigned int dispatch;
+    uint64_t ns;
+
+    for(int mode = BENCH_MODE_RINGBUF_SEM; mode <= BENCH_MODE_CHANNEL_BATCH; mode++){
+        if(bench_run((enum bench_mode)mode, &ns, &dispatch) < 0)
+            return -1;
+        eh_infofl("%-14s %u msgs: %.1fns/msg, %u dispatches", name[mode], TEST_BENCH_MSG_CNT,
+            (double)ns / TEST_BENCH_MSG_CNT, dispatch);
+    }
+    return 0;
+}
+
+int main(void){
+    int fail = 0;
+
+    eh_global_init();
+    if(test_bounded() < 0)
+        fail++;
+    if(test_unbounded() < 0)
+        fail++;
+    if(test_thread() < 0)
+        fail++;
+    if(bench() < 0)
+        fail++;
+    eh_infofl("fail=%d", fail);
+    eh_global_exit();
+    return fail ? -1 : 0;
+}
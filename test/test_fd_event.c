@@ -0,0 +1,125 @@
+/**
+ * @file test_fd_event.c
+ * @brief fd事件测试，socket与定时器在同一个epoll中等待
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <eh.h>
+#include <eh_debug.h>
+#include <eh_event.h>
+#include <eh_formatio.h>
+#include <eh_sleep.h>
+#include <eh_timer.h>
+#include <eh_fd_event.h>
+
+#define TEST_WRITE_CNT      10
+
+void stdout_write(void *stream, const uint8_t *buf, size_t size){
+    (void)stream;
+    printf("%.*s", (int)size, (const char*)buf);
+}
+
+static int set_nonblock(int fd){
+    int flags = fcntl(fd, F_GETFL, 0);
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+static int task_writer(void *arg){
+    int fd = *(int*)arg;
+    eh_fd_event_t fd_event;
+    char buf[32];
+    int ret;
+    EH_DBG_ERROR_EXEC(eh_fd_event_init(&fd_event, fd) < 0, return -1);
+    /* 注册后的首次轮询会上报可写边沿 */
+    ret = eh_fd_event_wait(&fd_event, EPOLLOUT, (eh_sclock_t)eh_msec_to_clock(1000));
+    eh_infofl("writer wait EPOLLOUT ret=%#x", ret);
+    for(int i = 0; i < TEST_WRITE_CNT; i++){
+        eh_usleep(1000*100);
+        ret = eh_snprintf(buf, sizeof(buf), "hello %d", i);
+        EH_DBG_ERROR_EXEC(write(fd, buf, (size_t)ret) != ret, break);
+    }
+    eh_fd_event_clean(&fd_event);
+    close(fd);
+    return 0;
+}
+
+int task_app(void *arg){
+    (void)arg;
+    int sv[2];
+    eh_fd_event_t fd_event;
+    eh_event_timer_t timer;
+    eh_epoll_t epoll;
+    eh_epoll_slot_t epoll_slot[4];
+    eh_task_t *writer;
+    char buf[64];
+    int timer_cnt = 0, read_cnt = 0;
+    bool eof = false;
+    ssize_t n;
+    int ret;
+
+    EH_DBG_ERROR_EXEC(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0, return -1);
+    set_nonblock(sv[0]);
+    set_nonblock(sv[1]);
+
+    EH_DBG_ERROR_EXEC(eh_fd_event_init(&fd_event, sv[0]) < 0, return -1);
+
+    eh_timer_init(&timer);
+    eh_timer_config_interval(&timer, (eh_sclock_t)eh_msec_to_clock(250));
+    eh_timer_set_attr(&timer, EH_TIMER_ATTR_AUTO_CIRCULATION);
+    eh_timer_start(&timer);
+
+    epoll = eh_epoll_new();
+    eh_epoll_add_event(epoll, eh_fd_event_readable(&fd_event), "socket");
+    eh_epoll_add_event(epoll, eh_timer_to_event(&timer), "timer");
+
+    writer = eh_task_create("writer", 0, 16*1024, &sv[1], task_writer);
+
+    while(!eof){
+        ret = eh_epoll_wait(epoll, epoll_slot, 4, (eh_sclock_t)eh_msec_to_clock(3000));
+        EH_DBG_ERROR_EXEC(ret < 0, break);
+        for(int i = 0; i < ret; i++){
+            if(epoll_slot[i].event == eh_timer_to_event(&timer)){
+                timer_cnt++;
+                continue;
+            }
+            /* 边沿触发，需要读到EAGAIN为止 */
+            for(;;){
+                n = read(eh_fd_event_fd(&fd_event), buf, sizeof(buf));
+                if(n > 0){
+                    read_cnt++;
+                    eh_infofl("%s: %.*s", epoll_slot[i].userdata, (int)n, buf);
+                    continue;
+                }
+                if(n == 0)
+                    eof = true;
+                break;
+            }
+        }
+    }
+    eh_infofl("read_cnt=%d timer_cnt=%d eof=%d", read_cnt, timer_cnt, eof);
+
+    eh_task_join(writer, NULL, EH_TIME_FOREVER);
+    eh_epoll_del(epoll);
+    eh_timer_clean(&timer);
+    eh_fd_event_clean(&fd_event);
+    close(sv[0]);
+    return 0;
+}
+
+int main(void){
+    eh_global_init();
+    task_app("task_app");
+    eh_global_exit();
+    return 0;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file test_file.c
+ * @brief 异步文件IO测试，多个任务并发写不同偏移，同一轮循环的请求应被合并提交
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <eh.h>
+#include <eh_debug.h>
+#include <eh_file.h>
+
+#define TEST_TASK_CNT       16
+#define TEST_BLOCK_SIZE     4096
+#define TEST_BLOCK_PER_TASK 8
+
+static int test_fd;
+static uint8_t fixed_buf[2][TEST_BLOCK_SIZE];
+
+void stdout_write(void *stream, const uint8_t *buf, size_t size){
+    (void)stream;
+    printf("%.*s", (int)size, (const char*)buf);
+}
+
+static int task_writer(void *arg){
+    int id = (int)(intptr_t)arg;
+    uint8_t buf[TEST_BLOCK_SIZE];
+    off_t offset;
+    ssize_t ret;
+
+    memset(buf, id, sizeof(buf));
+    for(int i = 0; i < TEST_BLOCK_PER_TASK; i++){
+        offset = (off_t)(i * TEST_TASK_CNT + id) * TEST_BLOCK_SIZE;
+        ret = __await eh_file_pwrite(test_fd, buf, sizeof(buf), offset);
+        EH_DBG_ERROR_EXEC(ret != TEST_BLOCK_SIZE, return -1);
+    }
+    return 0;
+}
+
+static int test_verify(void){
+    uint8_t buf[TEST_BLOCK_SIZE];
+    ssize_t ret;
+    for(int blk = 0; blk < TEST_TASK_CNT * TEST_BLOCK_PER_TASK; blk++){
+        ret = __await eh_file_pread(test_fd, buf, sizeof(buf), (off_t)blk * TEST_BLOCK_SIZE);
+        EH_DBG_ERROR_EXEC(ret != TEST_BLOCK_SIZE, return -1);
+        for(int i = 0; i < TEST_BLOCK_SIZE; i++){
+            if(buf[i] != (uint8_t)(blk % TEST_TASK_CNT)){
+                eh_errfl("block %d byte %d mismatch", blk, i);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int test_fixed(void){
+    struct iovec iov[2] = {
+        {.iov_base = fixed_buf[0], .iov_len = TEST_BLOCK_SIZE},
+        {.iov_base = fixed_buf[1], .iov_len = TEST_BLOCK_SIZE},
+    };
+    ssize_t ret;
+
+    EH_DBG_ERROR_EXEC(eh_file_buffers_register(iov, 2) < 0, return -1);
+    memset(fixed_buf[0], 0x5a, TEST_BLOCK_SIZE);
+    ret = __await eh_file_pwrite_fixed(test_fd, fixed_buf[0], TEST_BLOCK_SIZE, 0, 0);
+    EH_DBG_ERROR_EXEC(ret != TEST_BLOCK_SIZE, goto error);
+    ret = __await eh_file_pread_fixed(test_fd, fixed_buf[1], TEST_BLOCK_SIZE, 0, 1);
+    EH_DBG_ERROR_EXEC(ret != TEST_BLOCK_SIZE, goto error);
+    EH_DBG_ERROR_EXEC(memcmp(fixed_buf[0], fixed_buf[1], TEST_BLOCK_SIZE) != 0, goto error);
+    /* 越界的固定缓冲区应当被拒绝 */
+    ret = __await eh_file_pread_fixed(test_fd, fixed_buf[1] + 1, TEST_BLOCK_SIZE, 0, 1);
+    EH_DBG_ERROR_EXEC(ret != EH_RET_INVALID_PARAM, goto error);
+    eh_file_buffers_unregister();
+    return 0;
+error:
+    eh_file_buffers_unregister();
+    return -1;
+}
+
+int task_app(void *arg){
+    (void)arg;
+    char path[] = "/tmp/eh_test_file_XXXXXX";
+    eh_task_t *tasks[TEST_TASK_CNT];
+    struct eh_file_stat stat;
+    int task_ret, fail = 0;
+    int bad_fd;
+    int ret;
+
+    test_fd = mkstemp(path);
+    EH_DBG_ERROR_EXEC(test_fd < 0, return -1);
+    unlink(path);
+
+    for(int i = 0; i < TEST_TASK_CNT; i++)
+        tasks[i] = eh_task_create("writer", 0, 16*1024, (void*)(intptr_t)i, task_writer);
+    for(int i = 0; i < TEST_TASK_CNT; i++){
+        __await eh_task_join(tasks[i], &task_ret, EH_TIME_FOREVER);
+        if(task_ret < 0)
+            fail++;
+    }
+    ret = __await eh_file_fsync(test_fd, false);
+    EH_DBG_ERROR_EXEC(ret < 0, fail++);
+    if(test_verify() < 0)
+        fail++;
+    if(test_fixed() < 0)
+        fail++;
+
+    /* 已关闭的fd应当返回失败并带上errno */
+    bad_fd = dup(test_fd);
+    close(bad_fd);
+    ret = __await eh_file_fsync(bad_fd, true);
+    EH_DBG_ERROR_EXEC(ret != EH_RET_FAULT || errno != EBADF, fail++);
+
+    eh_file_get_stat(&stat);
+    eh_infofl("backend=%s submit=%llu batch=%llu complete=%llu inflight=%u pending=%u fail=%d",
+        stat.backend == EH_FILE_BACKEND_IO_URING ? "io_uring" : "offload",
+        (unsigned long long)stat.submit_cnt, (unsigned long long)stat.batch_cnt,
+        (unsigned long long)stat.complete_cnt, stat.inflight_cnt, stat.pending_cnt, fail);
+    close(test_fd);
+    return fail ? -1 : 0;
+}
+
+int main(void){
+    int ret;
+    eh_global_init();
+    ret = task_app("task_app");
+    eh_global_exit();
+    return ret;
+}
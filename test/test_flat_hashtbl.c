@@ -0,0 +1,275 @@
+/**
+ * @file test_flat_hashtbl.c
+ * @brief eh_flat_hashtbl测试，检查插入/重复插入/查找/删除/遍历，随机操作下与参考数组对比(覆盖DELETED复用、
+ *        原大小重建和扩容)，并在10^3~10^7个元素下对比 eh_hashtbl 与 eh_flat_hashtbl 的插入、查找、删除耗时
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <eh.h>
+#include <eh_debug.h>
+#include <eh_error.h>
+#include <eh_mem.h>
+#include <eh_hashtbl.h>
+#include <eh_flat_hashtbl.h>
+
+#define TEST_KEY_RANGE          (4096)
+#define TEST_RANDOM_OP_CNT      (1000000)
+#define TEST_BENCH_MAX_CNT      (10000000)
+#define TEST_BENCH_STRIDE       (7919)
+
+struct test_key{
+    uint32_t                    a[3];
+};
+
+void stdout_write(void *stream, const uint8_t *buf, size_t size){
+    (void)stream;
+    printf("%.*s", (int)size, (const char*)buf);
+}
+
+static uint64_t now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int test_basics(void){
+    eh_flat_hashtbl_t hashtbl, set;
+    uint32_t key, value, sum = 0;
+    const void *out_key;
+    void *out_value;
+    size_t iter = 0, n = 0;
+
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(eh_flat_hashtbl_create(0, 4, 0)) != EH_RET_INVALID_PARAM, return -1);
+    hashtbl = eh_flat_hashtbl_create(sizeof(uint32_t), sizeof(uint32_t), 0);
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(hashtbl) < 0, return -1);
+    for(key = 0; key < 100; key++){
+        value = key * 3;
+        EH_DBG_ERROR_EXEC(eh_flat_hashtbl_insert(hashtbl, &key, &value, NULL) != 0, goto error);
+    }
+    key = 7;
+    value = 0;
+    EH_DBG_ERROR_EXEC(eh_flat_hashtbl_insert(hashtbl, &key, &value, &out_value) != EH_RET_EXISTS, goto error);
+    EH_DBG_ERROR_EXEC(*(uint32_t*)out_value != 21, goto error);
+    /* 值为NULL时由调用者填写 */
+    key = 1000;
+    EH_DBG_ERROR_EXEC(eh_flat_hashtbl_insert(hashtbl, &key, NULL, &out_value) != 0, goto error);
+    *(uint32_t*)out_value = 3000;
+    EH_DBG_ERROR_EXEC(eh_flat_hashtbl_count(hashtbl) != 101, goto error);
+    for(key = 0; key < 100; key += 2)
+        EH_DBG_ERROR_EXEC(eh_flat_hashtbl_erase(hashtbl, &key) != 0, goto error);
+    key = 0;
+    EH_DBG_ERROR_EXEC(eh_flat_hashtbl_erase(hashtbl, &key) != EH_RET_NOT_EXISTS, goto error);
+    EH_DBG_ERROR_EXEC(eh_flat_hashtbl_find(hashtbl, &key) != NULL, goto error);
+    key = 99;
+    out_value = eh_flat_hashtbl_find(hashtbl, &key);
+    EH_DBG_ERROR_EXEC(out_value == NULL || *(uint32_t*)out_value != 297, goto error);
+    while((out_value = eh_flat_hashtbl_next(hashtbl, &iter, &out_key)) != NULL){
+        EH_DBG_ERROR_EXEC(*(const uint32_t*)out_key * 3 != *(uint32_t*)out_value, goto error);
+        sum += *(uint32_t*)out_value;
+        n++;
+    }
+    EH_DBG_ERROR_EXEC(n != 51 || sum != 3 * 2500 + 3000, goto error);
+    eh_flat_hashtbl_destroy(hashtbl);
+
+    /* 值长度为0时当作集合使用 */
+    set = eh_flat_hashtbl_create(sizeof(uint32_t), 0, 1000);
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(set) < 0, return -1);
+    for(key = 0; key < 1000; key++)
+        EH_DBG_ERROR_EXEC(eh_flat_hashtbl_insert(set, &key, NULL, NULL) != 0, goto set_error);
+    key = 999;
+    EH_DBG_ERROR_EXEC(eh_flat_hashtbl_find(set, &key) == NULL, goto set_error);
+    eh_flat_hashtbl_destroy(set);
+    return 0;
+error:
+    eh_flat_hashtbl_destroy(hashtbl);
+    return -1;
+set_error:
+    eh_flat_hashtbl_destroy(set);
+    return -1;
+}
+
+static int test_random(void){
+    static bool present[TEST_KEY_RANGE];
+    static uint16_t ref[TEST_KEY_RANGE];
+    eh_flat_hashtbl_t hashtbl;
+    struct test_key key;
+    const void *out_key;
+    uint16_t value, *out_value;
+    size_t iter = 0, n = 0, count = 0;
+    uint32_t k;
+    int ret;
+
+    hashtbl = eh_flat_hashtbl_create(sizeof(struct test_key), sizeof(uint16_t), 0);
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(hashtbl) < 0, return -1);
+    srandom(1);
+    for(int i = 0; i < TEST_RANDOM_OP_CNT; i++){
+        /* 前半段偏向插入使表扩容，后半段偏向删除产生大量DELETED */
+        k = (uint32_t)random() % TEST_KEY_RANGE;
+        key.a[0] = k;
+        key.a[1] = ~k;
+        key.a[2] = k * 2654435761U;
+        switch(random() % 4){
+            case 0:
+                if(i > TEST_RANDOM_OP_CNT / 2)
+                    goto erase;
+                /* fall through */
+            case 1:
+                value = (uint16_t)random();
+                ret = eh_flat_hashtbl_insert(hashtbl, &key, &value, (void**)&out_value);
+                EH_DBG_ERROR_EXEC(ret != (present[k] ? EH_RET_EXISTS : 0), goto error);
+                EH_DBG_ERROR_EXEC(present[k] && *out_value != ref[k], goto error);
+                if(!present[k]){
+                    present[k] = true;
+                    ref[k] = value;
+                    count++;
+                }
+                break;
+            case 2:
+            erase:
+                ret = eh_flat_hashtbl_erase(hashtbl, &key);
+                EH_DBG_ERROR_EXEC(ret != (present[k] ? 0 : EH_RET_NOT_EXISTS), goto error);
+                if(present[k]){
+                    present[k] = false;
+                    count--;
+                }
+                break;
+            default:
+                out_value = eh_flat_hashtbl_find(hashtbl, &key);
+                EH_DBG_ERROR_EXEC((out_value != NULL) != present[k], goto error);
+                EH_DBG_ERROR_EXEC(out_value && *out_value != ref[k], goto error);
+                break;
+        }
+    }
+    EH_DBG_ERROR_EXEC(eh_flat_hashtbl_count(hashtbl) != count, goto error);
+    while((out_value = eh_flat_hashtbl_next(hashtbl, &iter, &out_key)) != NULL){
+        k = ((const struct test_key *)out_key)->a[0];
+        EH_DBG_ERROR_EXEC(k >= TEST_KEY_RANGE || !present[k] || *out_value != ref[k], goto error);
+        n++;
+    }
+    EH_DBG_ERROR_EXEC(n != count, goto error);
+    eh_flat_hashtbl_destroy(hashtbl);
+    return 0;
+error:
+    eh_flat_hashtbl_destroy(hashtbl);
+    return -1;
+}
+
+#define bench_key(n, i)     ((uint32_t)(((uint64_t)(i) * TEST_BENCH_STRIDE % (n)) * 2654435761U))
+
+/* 返回false表示内存不足 */
+static bool bench_chained(uint32_t n, uint64_t ns[3]){
+    struct eh_hashtbl_node *node;
+    eh_hashtbl_t hashtbl;
+    uint32_t key;
+    uint64_t t;
+    bool ok = true;
+
+    hashtbl = eh_hashtbl_create(EH_HASHTBL_DEFAULT_LOADFACTOR);
+    if(eh_ptr_to_error(hashtbl) < 0)
+        return false;
+    t = now_ns();
+    for(uint32_t i = 0; i < n; i++){
+        key = (uint32_t)(i * 2654435761U);
+        node = eh_hashtbl_node_new_refresh(hashtbl, &key, sizeof(key), sizeof(uint32_t));
+        if(node == NULL || eh_hashtbl_insert(hashtbl, node) < 0){
+            eh_free(node);
+            ok = false;
+            goto out;
+        }
+        *(uint32_t*)eh_hashtbl_node_value(node) = i;
+    }
+    ns[0] = now_ns() - t;
+    t = now_ns();
+    for(uint32_t i = 0; i < n; i++){
+        key = bench_key(n, i);
+        if(eh_hashtbl_find(hashtbl, &key, sizeof(key), &node) < 0)
+            ok = false;
+    }
+    ns[1] = now_ns() - t;
+    t = now_ns();
+    for(uint32_t i = 0; i < n; i++){
+        key = bench_key(n, i);
+        if(eh_hashtbl_find(hashtbl, &key, sizeof(key), &node) == 0)
+            eh_hashtbl_node_delete(hashtbl, node);
+    }
+    ns[2] = now_ns() - t;
+out:
+    eh_hashtbl_destroy(hashtbl);
+    return ok;
+}
+
+static bool bench_flat(uint32_t n, uint64_t ns[3]){
+    eh_flat_hashtbl_t hashtbl;
+    uint32_t key;
+    uint64_t t;
+    bool ok = true;
+
+    hashtbl = eh_flat_hashtbl_create(sizeof(uint32_t), sizeof(uint32_t), 0);
+    if(eh_ptr_to_error(hashtbl) < 0)
+        return false;
+    t = now_ns();
+    for(uint32_t i = 0; i < n; i++){
+        key = (uint32_t)(i * 2654435761U);
+        if(eh_flat_hashtbl_insert(hashtbl, &key, &i, NULL) < 0){
+            ok = false;
+            goto out;
+        }
+    }
+    ns[0] = now_ns() - t;
+    t = now_ns();
+    for(uint32_t i = 0; i < n; i++){
+        key = bench_key(n, i);
+        if(eh_flat_hashtbl_find(hashtbl, &key) == NULL)
+            ok = false;
+    }
+    ns[1] = now_ns() - t;
+    t = now_ns();
+    for(uint32_t i = 0; i < n; i++){
+        key = bench_key(n, i);
+        eh_flat_hashtbl_erase(hashtbl, &key);
+    }
+    ns[2] = now_ns() - t;
+    if(eh_flat_hashtbl_count(hashtbl) != 0)
+        ok = false;
+out:
+    eh_flat_hashtbl_destroy(hashtbl);
+    return ok;
+}
+
+static void bench(void){
+    uint64_t chained_ns[3], flat_ns[3];
+
+    for(uint32_t n = 1000; n <= TEST_BENCH_MAX_CNT; n *= 10){
+        if(!bench_chained(n, chained_ns) || !bench_flat(n, flat_ns)){
+            eh_infofl("%8u entries: out of memory, skipped", n);
+            break;
+        }
+        eh_infofl("%8u entries ns/op: insert %6.1f / %6.1f, find %6.1f / %6.1f, erase %6.1f / %6.1f (eh_hashtbl / eh_flat_hashtbl)",
+            n, (double)chained_ns[0] / n, (double)flat_ns[0] / n, (double)chained_ns[1] / n, (double)flat_ns[1] / n,
+            (double)chained_ns[2] / n, (double)flat_ns[2] / n);
+    }
+}
+
+int main(void){
+    int fail = 0;
+
+    eh_global_init();
+    if(test_basics() < 0)
+        fail++;
+    if(test_random() < 0)
+        fail++;
+    bench();
+    eh_infofl("fail=%d", fail);
+    eh_global_exit();
+    return fail ? -1 : 0;
+}
@@ -9,6 +9,7 @@
  */
 
 #include <math.h>
+#include <time.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -20,6 +21,7 @@
 #include <eh_error.h>
 #include <eh_debug.h>
 #include <eh_formatio.h>
+#include <eh_mem.h>
 #include <eh_hashtbl.h>
 
 void stdout_write(void *stream, const uint8_t *buf, size_t size){
@@ -200,15 +202,242 @@ test_quit:
 
 
 
+static uint64_t now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+#define HASH_TEST_KEY_MAX       200
+#define HASH_BENCH_KEY_CNT      100000
+#define HASH_BENCH_ROUND        1000000
+#define HASH_REHASH_KEY_CNT     4096
+#define HASH_LATENCY_OP_CNT     2000000
+
+static int test_hash(void){
+    static uint64_t storage[(HASH_TEST_KEY_MAX + 32) / 8];
+    char *buf = (char *)storage;
+    const struct eh_hashtbl_hash_ops *ops[] = {&eh_hashtbl_hash_wy, &eh_hashtbl_hash_fnv1a};
+    struct eh_hashtbl_node *node;
+    eh_hashtbl_t hashtbl;
+    char key[32];
+    size_t len;
+
+    /* 字符串版本在各种起始对齐和长度下与二进制版本一致 */
+    for(size_t off = 0; off < 16; off++){
+        for(size_t n = 0; n <= HASH_TEST_KEY_MAX; n++){
+            for(size_t i = 0; i < n; i++)
+                buf[off + i] = (char)(1 + (off * 7 + i * 13) % 255);
+            buf[off + n] = '\0';
+            buf[off + n + 1] = 'x';
+            for(size_t k = 0; k < EH_ARRAY_SIZE(ops); k++){
+                EH_DBG_ERROR_EXEC(ops[k]->hash_str(buf + off, &len, n) != ops[k]->hash(buf + off, n, n) || len != n, return -1);
+            }
+        }
+    }
+    /* 末尾的0字节参与哈希，种子改变哈希值 */
+    EH_DBG_ERROR_EXEC(eh_hash_wy("a\0", 1, 0) == eh_hash_wy("a\0", 2, 0), return -1);
+    EH_DBG_ERROR_EXEC(eh_hash_wy("abcdefghijklmnopq", 17, 1) == eh_hash_wy("abcdefghijklmnopq", 17, 2), return -1);
+
+    for(size_t k = 0; k < EH_ARRAY_SIZE(ops); k++){
+        hashtbl = eh_hashtbl_create_with_hash(EH_HASHTBL_DEFAULT_LOADFACTOR, ops[k], 0x9e3779b97f4a7c15ULL);
+        EH_DBG_ERROR_EXEC(eh_ptr_to_error(hashtbl) < 0, return -1);
+        for(uint32_t i = 0; i < 1000; i++){
+            eh_snprintf(key, sizeof(key), "seeded-key-%u", i);
+            node = eh_hashtbl_node_new_with_string_refresh(hashtbl, key, 4);
+            EH_DBG_ERROR_EXEC(node == NULL, goto error);
+            *(uint32_t*)eh_hashtbl_node_value(node) = i;
+            EH_DBG_ERROR_EXEC(eh_hashtbl_insert(hashtbl, node) < 0, goto error);
+        }
+        for(uint32_t i = 0; i < 1000; i++){
+            eh_snprintf(key, sizeof(key), "seeded-key-%u", i);
+            EH_DBG_ERROR_EXEC(eh_hashtbl_find_with_string(hashtbl, key, &node) < 0, goto error);
+            EH_DBG_ERROR_EXEC(*(uint32_t*)eh_hashtbl_node_value(node) != i, goto error);
+            EH_DBG_ERROR_EXEC(eh_hashtbl_find(hashtbl, key, (eh_hashtbl_kv_len_t)strlen(key), &node) < 0, goto error);
+        }
+        eh_hashtbl_destroy(hashtbl);
+    }
+    return 0;
+error:
+    eh_hashtbl_destroy(hashtbl);
+    return -1;
+}
+
+static int rehash_find(eh_hashtbl_t hashtbl, uint32_t key){
+    struct eh_hashtbl_node *node;
+    if(eh_hashtbl_find(hashtbl, &key, sizeof(key), &node) < 0)
+        return -1;
+    return *(uint32_t*)eh_hashtbl_node_value(node) == key ? 0 : -1;
+}
+
+static int test_rehash(void){
+    struct eh_hashtbl *tbl;
+    struct eh_hashtbl_node *node, *n;
+    eh_hashtbl_t hashtbl;
+    unsigned int i, peak_mask, cnt;
+
+    hashtbl = eh_hashtbl_create(EH_HASHTBL_DEFAULT_LOADFACTOR);
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(hashtbl) < 0, return -1);
+    tbl = (struct eh_hashtbl *)hashtbl;
+    for(i = 0; i < HASH_REHASH_KEY_CNT; i++){
+        node = eh_hashtbl_node_new_refresh(hashtbl, &i, sizeof(i), sizeof(uint32_t));
+        EH_DBG_ERROR_EXEC(node == NULL, goto error);
+        *(uint32_t*)eh_hashtbl_node_value(node) = i;
+        EH_DBG_ERROR_EXEC(eh_hashtbl_insert(hashtbl, node) < 0, goto error);
+        /* 迁移过程中新旧两个散列表里的键都能找到 */
+        EH_DBG_ERROR_EXEC(rehash_find(hashtbl, i / 2) < 0, goto error);
+    }
+    peak_mask = tbl->mask;
+
+    /* 遍历时先完成迁移，遍历中删除节点 */
+    cnt = 0;
+    eh_hashtbl_for_each_safe(hashtbl, node, n, i){
+        cnt++;
+        if(*(uint32_t*)eh_hashtbl_node_value(node) >= 8)
+            eh_hashtbl_node_delete(hashtbl, node);
+    }
+    EH_DBG_ERROR_EXEC(cnt != HASH_REHASH_KEY_CNT || tbl->old_table != NULL, goto error);
+    EH_DBG_ERROR_EXEC(tbl->count != 8 || tbl->mask != peak_mask, goto error);
+
+    /* 删除不缩容，之后的查找逐步缩小散列表 */
+    for(i = 0; i < HASH_REHASH_KEY_CNT; i++)
+        EH_DBG_ERROR_EXEC((rehash_find(hashtbl, i) == 0) != (i < 8), goto error);
+    EH_DBG_ERROR_EXEC(tbl->mask >= peak_mask, goto error);
+    EH_DBG_ERROR_EXEC(eh_hashtbl_shrink(hashtbl) < 0, goto error);
+    EH_DBG_ERROR_EXEC(tbl->old_table != NULL || tbl->mask + 1 != EH_CONFIG_HASHTBL_MIN_SIZE, goto error);
+    for(i = 0; i < 8; i++)
+        EH_DBG_ERROR_EXEC(rehash_find(hashtbl, i) < 0, goto error);
+    eh_hashtbl_destroy(hashtbl);
+    return 0;
+error:
+    eh_hashtbl_destroy(hashtbl);
+    return -1;
+}
+
+static int latency_cmp(const void *a, const void *b){
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+/* 每次插入一个键并查找一个已有的键，统计单次操作耗时的分布，eager为真时每次插入后立即完成迁移，等价于一次性扩容 */
+static void bench_rehash_latency(int eager){
+    struct eh_hashtbl_node *node;
+    eh_hashtbl_t hashtbl;
+    uint64_t *lat, t, total = 0;
+    uint32_t key, cnt;
+
+    lat = malloc(sizeof(uint64_t) * HASH_LATENCY_OP_CNT);
+    if(lat == NULL)
+        return ;
+    hashtbl = eh_hashtbl_create(EH_HASHTBL_DEFAULT_LOADFACTOR);
+    if(eh_ptr_to_error(hashtbl) < 0){
+        free(lat);
+        return ;
+    }
+    for(cnt = 0; cnt < HASH_LATENCY_OP_CNT; cnt++){
+        key = cnt / 2;
+        t = now_ns();
+        node = eh_hashtbl_node_new_refresh(hashtbl, &cnt, sizeof(cnt), 0);
+        if(node == NULL || eh_hashtbl_insert(hashtbl, node) < 0){
+            eh_free(node);
+            break;
+        }
+        if(eager)
+            eh_hashtbl_rehash_step(hashtbl, UINT32_MAX);
+        eh_hashtbl_find(hashtbl, &key, sizeof(key), &node);
+        lat[cnt] = now_ns() - t;
+        total += lat[cnt];
+    }
+    eh_hashtbl_destroy(hashtbl);
+    if(cnt >= 10000){
+        qsort(lat, cnt, sizeof(uint64_t), latency_cmp);
+        eh_infofl("%s rehash, %u insert+find ns: avg %.1f, p99 %llu, p99.99 %llu, max %llu",
+            eager ? "eager" : "incremental", cnt, (double)total / cnt,
+            (unsigned long long)lat[(uint64_t)cnt * 99 / 100], (unsigned long long)lat[(uint64_t)cnt * 9999 / 10000],
+            (unsigned long long)lat[cnt - 1]);
+    }
+    free(lat);
+}
+
+/* 长度为len的字符串键，只有开头的编号不同 */
+static void bench_key(char *key, size_t len, uint32_t i){
+    memset(key, 'k', len);
+    for(size_t j = 0; j < 8 && j < len; j++, i /= 10)
+        key[j] = (char)('0' + i % 10);
+    key[len] = '\0';
+}
+
+static void bench_hash(void){
+    static const size_t key_len[] = {8, 32, 64, 128};
+    const struct eh_hashtbl_hash_ops *ops[] = {&eh_hashtbl_hash_fnv1a, &eh_hashtbl_hash_wy};
+    struct eh_hashtbl_node *node;
+    eh_hashtbl_t hashtbl;
+    char key[130];
+    double hash_ns[2], str_ns[2], find_ns[2];
+    eh_hash_val_t sink = 0;
+    size_t len;
+    uint64_t t;
+
+    for(size_t l = 0; l < EH_ARRAY_SIZE(key_len); l++){
+        for(size_t k = 0; k < EH_ARRAY_SIZE(ops); k++){
+            bench_key(key, key_len[l], 12345);
+            t = now_ns();
+            for(uint32_t r = 0; r < HASH_BENCH_ROUND; r++){
+                key[0] = (char)r;
+                sink += ops[k]->hash(key, key_len[l], 0);
+            }
+            hash_ns[k] = (double)(now_ns() - t) / HASH_BENCH_ROUND;
+            t = now_ns();
+            for(uint32_t r = 0; r < HASH_BENCH_ROUND; r++){
+                key[0] = (char)(r | 1);
+                sink += ops[k]->hash_str(key, &len, 0);
+            }
+            str_ns[k] = (double)(now_ns() - t) / HASH_BENCH_ROUND;
+
+            find_ns[k] = 0;
+            hashtbl = eh_hashtbl_create_with_hash(EH_HASHTBL_DEFAULT_LOADFACTOR, ops[k], 0);
+            if(eh_ptr_to_error(hashtbl) < 0)
+                continue;
+            for(uint32_t i = 0; i < HASH_BENCH_KEY_CNT; i++){
+                bench_key(key, key_len[l], i);
+                node = eh_hashtbl_node_new_with_string_refresh(hashtbl, key, 0);
+                if(node == NULL || eh_hashtbl_insert(hashtbl, node) < 0){
+                    eh_free(node);
+                    break;
+                }
+            }
+            t = now_ns();
+            for(uint32_t i = 0; i < HASH_BENCH_KEY_CNT; i++){
+                bench_key(key, key_len[l], (uint32_t)((uint64_t)i * 7919 % HASH_BENCH_KEY_CNT));
+                if(eh_hashtbl_find_with_string(hashtbl, key, &node) < 0)
+                    break;
+            }
+            find_ns[k] = (double)(now_ns() - t) / HASH_BENCH_KEY_CNT;
+            eh_hashtbl_destroy(hashtbl);
+        }
+        eh_infofl("%3u byte keys ns: hash %6.1f / %5.1f, hash_str %6.1f / %5.1f, find_with_string %6.1f / %5.1f (fnv1a / wy)",
+            (unsigned)key_len[l], hash_ns[0], hash_ns[1], str_ns[0], str_ns[1], find_ns[0], find_ns[1]);
+    }
+    (void)sink;
+}
+
 int main(void){
-    
+    int fail = 0;
     
     eh_global_init();
     
     task_app("task_app");
+    if(test_hash() < 0)
+        fail++;
+    if(test_rehash() < 0)
+        fail++;
+    bench_hash();
+    bench_rehash_latency(1);
+    bench_rehash_latency(0);
+    eh_infofl("fail=%d", fail);
     
     eh_global_exit();
-    return 0;
+    return fail ? -1 : 0;
 }
  
  
\ No newline at end of file
@@ -0,0 +1,193 @@
+/**
+ * @file test_hugeheap.c
+ * @brief 大页堆测试，检查eh_malloc_from从大页堆分配、空闲块连续多次trim后归还、重新使用后状态复位，
+ *        并对比大页堆与4K页映射上随机访问的耗时
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <eh.h>
+#include <eh_config.h>
+#include <eh_debug.h>
+#include <eh_error.h>
+#include <eh_mem.h>
+#include <eh_hugeheap.h>
+
+#define TEST_REGION_SIZE        (32*1024*1024U)
+#define TEST_BUF_SIZE           (3*1024*1024U)
+#define TEST_BUF_CNT            (8)
+#define TEST_BENCH_SIZE         (24*1024*1024U)
+#define TEST_BENCH_ACCESS_CNT   (4*1024*1024)
+#define TEST_BENCH_ROUND        (5)
+
+void stdout_write(void *stream, const uint8_t *buf, size_t size){
+    (void)stream;
+    printf("%.*s", (int)size, (const char*)buf);
+}
+
+#if (!defined(EH_CONFIG_USE_LIBC_MEM_MANAGE)) || (EH_CONFIG_USE_LIBC_MEM_MANAGE == 0)
+
+static uint8_t *bufs[TEST_BUF_CNT];
+
+static uint64_t now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static unsigned long rss_kb(void){
+    unsigned long size = 0, resident = 0;
+    FILE *fp = fopen("/proc/self/statm", "r");
+    if(fp == NULL)
+        return 0;
+    if(fscanf(fp, "%lu %lu", &size, &resident) != 2)
+        resident = 0;
+    fclose(fp);
+    return resident * (unsigned long)sysconf(_SC_PAGESIZE) / 1024;
+}
+
+/* MADV_FREE的页在内存紧张前仍计入RSS，单独统计在LazyFree中 */
+static unsigned long smaps_kb(const char *key){
+    char line[128];
+    unsigned long kb = 0;
+    FILE *fp = fopen("/proc/self/smaps_rollup", "r");
+    if(fp == NULL)
+        return 0;
+    while(fgets(line, sizeof(line), fp)){
+        if(strncmp(line, key, strlen(key)) == 0){
+            kb = strtoul(line + strlen(key), NULL, 10);
+            break;
+        }
+    }
+    fclose(fp);
+    return kb;
+}
+
+static int test_alloc_trim(int heap_id){
+    struct eh_hugeheap_stat stat;
+    size_t released;
+    int i;
+
+    for(i = 0; i < TEST_BUF_CNT; i++){
+        bufs[i] = eh_malloc_from(heap_id, TEST_BUF_SIZE);
+        EH_DBG_ERROR_EXEC(bufs[i] == NULL, return -1);
+        memset(bufs[i], i + 1, TEST_BUF_SIZE);
+    }
+    /* 专用堆不参与普通分配 */
+    EH_DBG_ERROR_EXEC(eh_malloc(TEST_BUF_SIZE) != NULL, return -1);
+    eh_infofl("after touch %d x %u bytes: rss %lukB, AnonHugePages %lukB", TEST_BUF_CNT, TEST_BUF_SIZE,
+        rss_kb(), smaps_kb("AnonHugePages:"));
+
+    for(i = 0; i < TEST_BUF_CNT; i++)
+        eh_free(bufs[i]);
+    /* 第一次只记录空闲，连续空闲达到次数后才归还 */
+    EH_DBG_ERROR_EXEC(eh_hugeheap_trim() != 0, return -1);
+    released = eh_hugeheap_trim();
+    eh_hugeheap_get_stat(&stat);
+    eh_infofl("after free: released %lu bytes, rss %lukB, LazyFree %lukB, thp regions %lu",
+        (unsigned long)released, rss_kb(), smaps_kb("LazyFree:"), (unsigned long)stat.thp_region_cnt);
+    EH_DBG_ERROR_EXEC(released < TEST_REGION_SIZE - EH_HUGEHEAP_PAGE_SIZE * 2, return -1);
+    EH_DBG_ERROR_EXEC(stat.released_size != released, return -1);
+    EH_DBG_ERROR_EXEC(eh_hugeheap_trim() != 0, return -1);
+
+    /* 归还过的内存重新分配后照常可用，trim时状态复位 */
+    for(i = 0; i < TEST_BUF_CNT; i++){
+        bufs[i] = eh_malloc_from(heap_id, TEST_BUF_SIZE);
+        EH_DBG_ERROR_EXEC(bufs[i] == NULL, return -1);
+        memset(bufs[i], 0x5a, TEST_BUF_SIZE);
+    }
+    for(i = 0; i < TEST_BUF_CNT; i++)
+        EH_DBG_ERROR_EXEC(bufs[i][TEST_BUF_SIZE - 1] != 0x5a, return -1);
+    /* 只剩尾部仍然空闲的块保持归还状态 */
+    eh_hugeheap_trim();
+    eh_hugeheap_get_stat(&stat);
+    EH_DBG_ERROR_EXEC(stat.released_size > TEST_REGION_SIZE - TEST_BUF_CNT * TEST_BUF_SIZE, return -1);
+    for(i = 0; i < TEST_BUF_CNT; i++)
+        eh_free(bufs[i]);
+    return 0;
+}
+
+static uint64_t random_access(volatile uint64_t *buf, size_t cnt){
+    uint64_t sum = 0, x = 88172645463325252ULL;
+    uint64_t t = now_ns();
+    for(int i = 0; i < TEST_BENCH_ACCESS_CNT; i++){
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        sum += buf[x % cnt];
+    }
+    (void)sum;
+    return now_ns() - t;
+}
+
+static void bench(int heap_id){
+    uint64_t huge_ns, small_ns, t;
+    uint8_t *huge, *small;
+
+    huge = eh_malloc_from(heap_id, TEST_BENCH_SIZE);
+    small = mmap(NULL, TEST_BENCH_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(huge == NULL || small == MAP_FAILED){
+        eh_free(huge);
+        return ;
+    }
+#ifdef MADV_NOHUGEPAGE
+    madvise(small, TEST_BENCH_SIZE, MADV_NOHUGEPAGE);
+#endif
+    memset(huge, 1, TEST_BENCH_SIZE);
+    memset(small, 1, TEST_BENCH_SIZE);
+    /* 交替运行取最小值，减少调度抖动的影响 */
+    huge_ns = small_ns = UINT64_MAX;
+    for(int r = 0; r < TEST_BENCH_ROUND; r++){
+        t = random_access((volatile uint64_t *)huge, TEST_BENCH_SIZE / sizeof(uint64_t));
+        huge_ns = t < huge_ns ? t : huge_ns;
+        t = random_access((volatile uint64_t *)small, TEST_BENCH_SIZE / sizeof(uint64_t));
+        small_ns = t < small_ns ? t : small_ns;
+    }
+    eh_infofl("random 8B read over %uMiB: hugeheap %.2fns, 4K pages %.2fns", TEST_BENCH_SIZE / 1024 / 1024,
+        (double)huge_ns / TEST_BENCH_ACCESS_CNT, (double)small_ns / TEST_BENCH_ACCESS_CNT);
+    munmap(small, TEST_BENCH_SIZE);
+    eh_free(huge);
+}
+
+int main(void){
+    int heap_id;
+    int fail = 0;
+
+    eh_global_init();
+    heap_id = eh_hugeheap_create(TEST_REGION_SIZE, EH_MEM_HEAP_FLAGS_EXCLUSIVE | EH_MEM_HEAP_FLAGS_NO_FALLBACK);
+    if(heap_id < 0){
+        eh_errfl("eh_hugeheap_create %d", heap_id);
+        eh_global_exit();
+        return -1;
+    }
+    if(test_alloc_trim(heap_id) < 0)
+        fail++;
+    bench(heap_id);
+    eh_infofl("fail=%d", fail);
+    eh_global_exit();
+    return fail ? -1 : 0;
+}
+
+#else
+
+int main(void){
+    int ret = 0;
+    eh_global_init();
+    if(eh_hugeheap_create(EH_HUGEHEAP_PAGE_SIZE, 0) != EH_RET_NOT_SUPPORTED)
+        ret = -1;
+    eh_infofl("EH_CONFIG_USE_LIBC_MEM_MANAGE is enabled, eh_hugeheap not supported.");
+    eh_global_exit();
+    return ret;
+}
+
+#endif
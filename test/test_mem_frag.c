@@ -0,0 +1,189 @@
+/**
+ * @file test_mem_frag.c
+ * @brief 内存碎片压力基准测试，随机大小的分配与释放交替进行，统计每次操作的平均/最大耗时以及碎片程度，
+ *        并用遍历空闲块的结果校验 eh_mem_get_heap_info 中增量维护的碎片统计，分别以 -DEH_CONFIG_USE_LIBC_MEM_MANAGE=0 -DEH_CONFIG_MEM_USE_TLSF=0/1 编译即可对比首次适配和TLSF
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <eh.h>
+#include "eh_config.h"
+#include <eh_debug.h>
+#include <eh_mem.h>
+
+void stdout_write(void *stream, const uint8_t *buf, size_t size){
+    (void)stream;
+    printf("%.*s", (int)size, (const char*)buf);
+}
+
+#if  defined(EH_CONFIG_USE_LIBC_MEM_MANAGE) && EH_CONFIG_USE_LIBC_MEM_MANAGE == 0
+
+#define TEST_SLOT_NUM           (4096)
+#define TEST_CHURN_CNT          (400000)
+
+struct op_stat{
+    uint64_t cnt;
+    uint64_t fail;
+    uint64_t total_ns;
+    uint64_t max_ns;
+};
+
+static void *slots[TEST_SLOT_NUM];
+static uint32_t rand_state = 0x12345678;
+static size_t free_block_cnt;
+static size_t max_free_block;
+
+static uint32_t test_rand(void){
+    rand_state = rand_state * 1664525U + 1013904223U;
+    return rand_state >> 8;
+}
+
+/* 大部分为小对象，偶尔有大对象，比较接近真实负载 */
+static size_t test_rand_size(void){
+    uint32_t r = test_rand() % 100;
+    if(r < 70)
+        return 16 + test_rand() % 112;
+    if(r < 95)
+        return 128 + test_rand() % 896;
+    return 1024 + test_rand() % 7168;
+}
+
+static uint64_t now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void stat_add(struct op_stat *stat, uint64_t ns, bool fail){
+    stat->cnt++;
+    stat->total_ns += ns;
+    if(ns > stat->max_ns)
+        stat->max_ns = ns;
+    if(fail)
+        stat->fail++;
+}
+
+static void dump_func(void* start, size_t size){
+    (void)start;
+    free_block_cnt++;
+    if(size > max_free_block)
+        max_free_block = size;
+}
+
+static int report(const char *phase, const struct op_stat *malloc_stat, const struct op_stat *free_stat){
+    struct eh_mem_heap_info info;
+    size_t hist_sum = 0, hist_len = 0;
+    unsigned int top_bin = 0;
+    char hist_line[256];
+
+    eh_mem_get_heap_info(&info);
+    free_block_cnt = 0;
+    max_free_block = 0;
+    eh_free_block_dump(dump_func);
+    hist_line[0] = '\0';
+    for(unsigned int i = 0; i < EH_MEM_FREE_HIST_BIN_CNT; i++){
+        hist_sum += info.free_hist[i];
+        if(info.free_hist[i])
+            top_bin = i;
+    }
+    eh_infofl("[%s] malloc: cnt %llu fail %llu avg %lluns max %lluns",
+        phase, (unsigned long long)malloc_stat->cnt, (unsigned long long)malloc_stat->fail,
+        (unsigned long long)(malloc_stat->cnt ? malloc_stat->total_ns / malloc_stat->cnt : 0),
+        (unsigned long long)malloc_stat->max_ns);
+    eh_infofl("[%s] free:   cnt %llu avg %lluns max %lluns",
+        phase, (unsigned long long)free_stat->cnt,
+        (unsigned long long)(free_stat->cnt ? free_stat->total_ns / free_stat->cnt : 0),
+        (unsigned long long)free_stat->max_ns);
+    eh_infofl("[%s] free size %lu, free blocks %lu, largest free block %lu, fragmentation %lu%%",
+        phase, (unsigned long)info.free_size, (unsigned long)info.free_block_cnt, (unsigned long)info.largest_free_block,
+        (unsigned long)(info.free_size ? 100 - (info.largest_free_block * 100 / info.free_size) : 0));
+    for(unsigned int i = 0; i <= top_bin; i++)
+        hist_len += (size_t)snprintf(hist_line + hist_len, sizeof(hist_line) - hist_len, " 2^%u:%lu",
+            i + EH_MEM_FREE_HIST_SHIFT_MIN, (unsigned long)info.free_hist[i]);
+    eh_infofl("[%s] free block histogram:%s", phase, hist_line);
+    /* dump出来的大小包含块头 */
+    if( info.free_block_cnt != free_block_cnt || hist_sum != free_block_cnt ||
+        info.largest_free_block > max_free_block || max_free_block - info.largest_free_block > 64 ){
+        eh_errfl("[%s] heap info mismatch: cnt %lu/%lu hist %lu largest %lu/%lu", phase,
+            (unsigned long)info.free_block_cnt, (unsigned long)free_block_cnt, (unsigned long)hist_sum,
+            (unsigned long)info.largest_free_block, (unsigned long)max_free_block);
+        return -1;
+    }
+    return 0;
+}
+
+int main(void){
+    struct op_stat malloc_stat = {0}, free_stat = {0};
+    struct eh_mem_heap_info info;
+    uint64_t t;
+    uint32_t i;
+    size_t size;
+    int ret = 0;
+
+    eh_global_init();
+    eh_infofl("allocator: %s", EH_CONFIG_MEM_USE_TLSF ? "tlsf" : "first-fit");
+
+    /* 填满后隔一个释放一个，制造碎片 */
+    for(i = 0; i < TEST_SLOT_NUM; i++){
+        size = test_rand_size();
+        t = now_ns();
+        slots[i] = eh_malloc(size);
+        stat_add(&malloc_stat, now_ns() - t, slots[i] == NULL);
+    }
+    for(i = 0; i < TEST_SLOT_NUM; i += 2){
+        t = now_ns();
+        eh_free(slots[i]);
+        stat_add(&free_stat, now_ns() - t, false);
+        slots[i] = NULL;
+    }
+    if(report("fill", &malloc_stat, &free_stat) < 0)
+        ret = -1;
+
+    memset(&malloc_stat, 0, sizeof(malloc_stat));
+    memset(&free_stat, 0, sizeof(free_stat));
+    for(uint32_t n = 0; n < TEST_CHURN_CNT; n++){
+        i = test_rand() % TEST_SLOT_NUM;
+        if(slots[i]){
+            t = now_ns();
+            eh_free(slots[i]);
+            stat_add(&free_stat, now_ns() - t, false);
+            slots[i] = NULL;
+            continue;
+        }
+        size = test_rand_size();
+        t = now_ns();
+        slots[i] = eh_malloc(size);
+        stat_add(&malloc_stat, now_ns() - t, slots[i] == NULL);
+        if(slots[i])
+            memset(slots[i], (int)i, size);
+    }
+    if(report("churn", &malloc_stat, &free_stat) < 0)
+        ret = -1;
+
+    for(i = 0; i < TEST_SLOT_NUM; i++){
+        eh_free(slots[i]);
+        slots[i] = NULL;
+    }
+    eh_mem_get_heap_info(&info);
+    if(info.free_size != info.total_size){
+        eh_errfl("leak: free %lu total %lu", (unsigned long)info.free_size, (unsigned long)info.total_size);
+        ret = -1;
+    }
+    eh_global_exit();
+    return ret;
+}
+
+#else
+
+int main(void){
+    eh_debugfl("Do not test the c library.");
+    return 0;
+}
+#endif
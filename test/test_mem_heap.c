@@ -0,0 +1,159 @@
+/**
+ * @file test_mem_heap.c
+ * @brief 多堆分配测试，检查注册返回的堆id、eh_malloc_from落在指定堆内、专用堆不参与eh_malloc、
+ *        分配失败时的回退策略、按堆的统计信息以及eh_global_init之后的运行时注册
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <eh.h>
+#include <eh_config.h>
+#include <eh_debug.h>
+#include <eh_error.h>
+#include <eh_mem.h>
+
+void stdout_write(void *stream, const uint8_t *buf, size_t size){
+    (void)stream;
+    printf("%.*s", (int)size, (const char*)buf);
+}
+
+#if (!defined(EH_CONFIG_USE_LIBC_MEM_MANAGE)) || (EH_CONFIG_USE_LIBC_MEM_MANAGE == 0)
+
+#define TEST_HEAP_SIZE          (16*1024)
+
+static uint8_t eh_aligned(64) heap_exclusive[TEST_HEAP_SIZE];
+static uint8_t eh_aligned(64) heap_no_fallback[TEST_HEAP_SIZE];
+static uint8_t eh_aligned(64) heap_runtime[TEST_HEAP_SIZE];
+
+#define in_heap(ptr, heap)      ((uint8_t*)(ptr) >= (heap) && (uint8_t*)(ptr) < (heap) + sizeof(heap))
+
+static size_t heap_id_free_size(int heap_id){
+    struct eh_mem_heap_info info;
+    if(eh_mem_get_heap_info_by_id(heap_id, &info) < 0)
+        return 0;
+    return info.free_size;
+}
+
+static int test_register(int *id_exclusive, int *id_no_fallback){
+    struct eh_mem_heap heap;
+    int id;
+
+    heap.heap_start = heap_exclusive;
+    heap.heap_size = sizeof(heap_exclusive);
+    heap.flags = EH_MEM_HEAP_FLAGS_EXCLUSIVE;
+    id = eh_mem_heap_register(&heap);
+    EH_DBG_ERROR_EXEC(id < 0, return -1);
+    *id_exclusive = id;
+
+    heap.heap_start = heap_no_fallback;
+    heap.heap_size = sizeof(heap_no_fallback);
+    heap.flags = EH_MEM_HEAP_FLAGS_NO_FALLBACK;
+    id = eh_mem_heap_register(&heap);
+    EH_DBG_ERROR_EXEC(id != *id_exclusive + 1, return -1);
+    *id_no_fallback = id;
+    return 0;
+}
+
+static int test_malloc_from(int id_exclusive, int id_no_fallback){
+    size_t free_exclusive = heap_id_free_size(id_exclusive);
+    size_t free_no_fallback = heap_id_free_size(id_no_fallback);
+    uint8_t *a, *b, *c, *n;
+
+    EH_DBG_ERROR_EXEC(free_exclusive == 0 || free_no_fallback == 0, return -1);
+    /* 公共分配不会落到专用堆，默认堆足够时也不会落到后注册的堆 */
+    c = eh_malloc(100);
+    EH_DBG_ERROR_EXEC(c == NULL || in_heap(c, heap_exclusive) || in_heap(c, heap_no_fallback), return -1);
+    EH_DBG_ERROR_EXEC(heap_id_free_size(id_exclusive) != free_exclusive, goto error_c);
+
+    a = eh_malloc_from(id_exclusive, 100);
+    EH_DBG_ERROR_EXEC(a == NULL || !in_heap(a, heap_exclusive), goto error_c);
+    EH_DBG_ERROR_EXEC(heap_id_free_size(id_exclusive) >= free_exclusive, goto error_a);
+    b = eh_malloc_from(id_no_fallback, 100);
+    EH_DBG_ERROR_EXEC(b == NULL || !in_heap(b, heap_no_fallback), goto error_a);
+    EH_DBG_ERROR_EXEC(heap_id_free_size(id_no_fallback) >= free_no_fallback, goto error_b);
+
+    /* 扩大时优先留在原来的堆 */
+    n = eh_realloc(a, 4000);
+    EH_DBG_ERROR_EXEC(n == NULL || !in_heap(n, heap_exclusive), goto error_b);
+    a = n;
+
+    /* 放不下时NO_FALLBACK返回NULL，其余回退到公共堆 */
+    EH_DBG_ERROR_EXEC(eh_malloc_from(id_no_fallback, TEST_HEAP_SIZE * 2) != NULL, goto error_b);
+    n = eh_malloc_from(id_exclusive, TEST_HEAP_SIZE * 2);
+    EH_DBG_ERROR_EXEC(n == NULL || in_heap(n, heap_exclusive), goto error_b);
+    eh_free(n);
+    EH_DBG_ERROR_EXEC(eh_malloc_from(-1, 100) != NULL, goto error_b);
+    EH_DBG_ERROR_EXEC(eh_malloc_from(100, 100) != NULL, goto error_b);
+
+    eh_free(a);
+    eh_free(b);
+    eh_free(c);
+    EH_DBG_ERROR_EXEC(heap_id_free_size(id_exclusive) != free_exclusive, return -1);
+    EH_DBG_ERROR_EXEC(heap_id_free_size(id_no_fallback) != free_no_fallback, return -1);
+    return 0;
+error_b:
+    eh_free(b);
+error_a:
+    eh_free(a);
+error_c:
+    eh_free(c);
+    return -1;
+}
+
+static int test_runtime_register(void){
+    struct eh_mem_heap_info total_before, total_after;
+    struct eh_mem_heap heap;
+    uint8_t *p;
+    int id;
+
+    eh_mem_get_heap_info(&total_before);
+    heap.heap_start = heap_runtime;
+    heap.heap_size = sizeof(heap_runtime);
+    heap.flags = EH_MEM_HEAP_FLAGS_EXCLUSIVE | EH_MEM_HEAP_FLAGS_NO_FALLBACK;
+    id = eh_mem_heap_register(&heap);
+    EH_DBG_ERROR_EXEC(id < 0, return -1);
+    /* 汇总信息包含新注册的堆 */
+    eh_mem_get_heap_info(&total_after);
+    EH_DBG_ERROR_EXEC(total_after.total_size != total_before.total_size + heap_id_free_size(id), return -1);
+    p = eh_malloc_from(id, 1000);
+    EH_DBG_ERROR_EXEC(p == NULL || !in_heap(p, heap_runtime), return -1);
+    memset(p, 0x5a, 1000);
+    eh_free(p);
+    eh_infofl("runtime heap %d free %lu", id, (unsigned long)heap_id_free_size(id));
+    return 0;
+}
+
+int main(void){
+    int id_exclusive, id_no_fallback;
+    int fail = 0;
+
+    /* eh_global_init之前注册，初始化时建立 */
+    if(test_register(&id_exclusive, &id_no_fallback) < 0){
+        eh_errfl("register failed");
+        return -1;
+    }
+    eh_global_init();
+    eh_infofl("exclusive heap %d, no fallback heap %d", id_exclusive, id_no_fallback);
+    if(test_malloc_from(id_exclusive, id_no_fallback) < 0)
+        fail++;
+    if(test_runtime_register() < 0)
+        fail++;
+    eh_infofl("fail=%d", fail);
+    eh_global_exit();
+    return fail ? -1 : 0;
+}
+
+#else
+
+int main(void){
+    eh_infofl("EH_CONFIG_USE_LIBC_MEM_MANAGE is enabled, nothing to test.");
+    return 0;
+}
+
+#endif
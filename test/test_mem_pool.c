@@ -0,0 +1,162 @@
+/**
+ * @file test_mem_pool.c
+ * @brief 内存池测试，固定内存池耗尽，可增长内存池的扩展与空块释放，块边界上交替分配释放时保留备用空块，
+ *        以及32~256个一批的突发分配释放下批量接口与逐个接口的耗时对比
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <eh.h>
+#include <eh_debug.h>
+#include <eh_error.h>
+#include <eh_mem_pool.h>
+
+#define TEST_BUF_SIZE           (64)
+#define TEST_CHUNK_NUM          (64)
+#define TEST_BURST_MAX          (256)
+#define TEST_BENCH_ROUND        (20000)
+
+static void *ptrs[TEST_BURST_MAX];
+
+void stdout_write(void *stream, const uint8_t *buf, size_t size){
+    (void)stream;
+    printf("%.*s", (int)size, (const char*)buf);
+}
+
+static uint64_t now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int test_fixed(void){
+    eh_mem_pool_t pool;
+    size_t n;
+
+    pool = eh_mem_pool_create(sizeof(void*), TEST_BUF_SIZE, 16);
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(pool) < 0, return -1);
+    n = eh_mem_pool_alloc_bulk(pool, ptrs, 20);
+    EH_DBG_ERROR_EXEC(n != 16 || eh_mem_pool_used(pool) != 16, goto error);
+    EH_DBG_ERROR_EXEC(eh_mem_pool_alloc(pool) != NULL, goto error);
+    eh_mem_pool_free_bulk(pool, ptrs, n);
+    EH_DBG_ERROR_EXEC(eh_mem_pool_used(pool) != 0, goto error);
+    eh_mem_pool_destroy(pool);
+    return 0;
+error:
+    eh_mem_pool_destroy(pool);
+    return -1;
+}
+
+static int test_growable(uint32_t flags, size_t expect_chunk_cnt){
+    eh_mem_pool_t pool;
+    size_t n;
+
+    pool = eh_mem_pool_create_growable(sizeof(void*), TEST_BUF_SIZE, TEST_CHUNK_NUM, flags);
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(pool) < 0, return -1);
+    EH_DBG_ERROR_EXEC(eh_mem_pool_chunk_cnt(pool) != 0, goto error);
+    n = eh_mem_pool_alloc_bulk(pool, ptrs, TEST_BURST_MAX);
+    EH_DBG_ERROR_EXEC(n != TEST_BURST_MAX, goto error);
+    EH_DBG_ERROR_EXEC(eh_mem_pool_chunk_cnt(pool) != TEST_BURST_MAX / TEST_CHUNK_NUM, goto error);
+    for(size_t i = 0; i < n; i++)
+        memset(ptrs[i], (int)i, TEST_BUF_SIZE);
+    for(size_t i = 0; i < n; i++)
+        EH_DBG_ERROR_EXEC(((uint8_t*)ptrs[i])[TEST_BUF_SIZE-1] != (uint8_t)i, goto error);
+    eh_mem_pool_free_bulk(pool, ptrs, n);
+    EH_DBG_ERROR_EXEC(eh_mem_pool_used(pool) != 0, goto error);
+    EH_DBG_ERROR_EXEC(eh_mem_pool_chunk_cnt(pool) != expect_chunk_cnt, goto error);
+    eh_infofl("growable flags %#x: chunk_cnt after free %lu", flags, (unsigned long)eh_mem_pool_chunk_cnt(pool));
+    eh_mem_pool_destroy(pool);
+    return 0;
+error:
+    eh_mem_pool_destroy(pool);
+    return -1;
+}
+
+/* 在第2个块用满的边界上交替分配释放，空块留作备用，不会每次都向堆申请释放整块 */
+static int test_chunk_boundary(void){
+    eh_mem_pool_t pool;
+    void *first, *p;
+    size_t n;
+
+    pool = eh_mem_pool_create_growable(sizeof(void*), TEST_BUF_SIZE, TEST_CHUNK_NUM, EH_MEM_POOL_FLAGS_RELEASE_EMPTY_CHUNK);
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(pool) < 0, return -1);
+    n = eh_mem_pool_alloc_bulk(pool, ptrs, TEST_CHUNK_NUM * 2);
+    EH_DBG_ERROR_EXEC(n != TEST_CHUNK_NUM * 2, goto error);
+    first = eh_mem_pool_alloc(pool);
+    EH_DBG_ERROR_EXEC(first == NULL || eh_mem_pool_chunk_cnt(pool) != 3, goto error);
+    eh_mem_pool_free(pool, first);
+    for(int i = 0; i < 1000; i++){
+        p = eh_mem_pool_alloc(pool);
+        EH_DBG_ERROR_EXEC(p != first || eh_mem_pool_chunk_cnt(pool) != 3, goto error);
+        eh_mem_pool_free(pool, p);
+        EH_DBG_ERROR_EXEC(eh_mem_pool_chunk_cnt(pool) != 3, goto error);
+    }
+    /* 已经有备用空块时，再空出来的块被释放 */
+    eh_mem_pool_free_bulk(pool, ptrs + TEST_CHUNK_NUM, TEST_CHUNK_NUM);
+    EH_DBG_ERROR_EXEC(eh_mem_pool_used(pool) != TEST_CHUNK_NUM || eh_mem_pool_chunk_cnt(pool) != 2, goto error);
+    eh_mem_pool_free_bulk(pool, ptrs, TEST_CHUNK_NUM);
+    EH_DBG_ERROR_EXEC(eh_mem_pool_used(pool) != 0 || eh_mem_pool_chunk_cnt(pool) != 1, goto error);
+    eh_mem_pool_destroy(pool);
+    return 0;
+error:
+    eh_mem_pool_destroy(pool);
+    return -1;
+}
+
+static void bench(size_t burst){
+    eh_mem_pool_t pool;
+    uint64_t t, single_ns, bulk_ns;
+    size_t i;
+    int r;
+
+    pool = eh_mem_pool_create_growable(sizeof(void*), TEST_BUF_SIZE, TEST_CHUNK_NUM, 0);
+    if(eh_ptr_to_error(pool) < 0)
+        return ;
+
+    t = now_ns();
+    for(r = 0; r < TEST_BENCH_ROUND; r++){
+        for(i = 0; i < burst; i++)
+            ptrs[i] = eh_mem_pool_alloc(pool);
+        for(i = 0; i < burst; i++)
+            eh_mem_pool_free(pool, ptrs[i]);
+    }
+    single_ns = now_ns() - t;
+
+    t = now_ns();
+    for(r = 0; r < TEST_BENCH_ROUND; r++){
+        eh_mem_pool_alloc_bulk(pool, ptrs, burst);
+        eh_mem_pool_free_bulk(pool, ptrs, burst);
+    }
+    bulk_ns = now_ns() - t;
+
+    eh_infofl("burst %3lu: per object alloc+free single %lluns bulk %lluns", (unsigned long)burst,
+        (unsigned long long)(single_ns / (TEST_BENCH_ROUND * burst)),
+        (unsigned long long)(bulk_ns / (TEST_BENCH_ROUND * burst)));
+    eh_mem_pool_destroy(pool);
+}
+
+int main(void){
+    int fail = 0;
+
+    eh_global_init();
+    if(test_fixed() < 0)
+        fail++;
+    if(test_growable(0, TEST_BURST_MAX / TEST_CHUNK_NUM) < 0)
+        fail++;
+    if(test_growable(EH_MEM_POOL_FLAGS_RELEASE_EMPTY_CHUNK, 1) < 0)
+        fail++;
+    if(test_chunk_boundary() < 0)
+        fail++;
+    bench(32);
+    bench(256);
+    eh_infofl("fail=%d", fail);
+    eh_global_exit();
+    return fail ? -1 : 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file test_mem_profile.c
+ * @brief 内存分配分析测试，需以 -DEH_CONFIG_MEM_PROFILE=1 编译，检查按调用点的统计与未释放分配的打印，
+ *        并对比包装前后的分配释放耗时
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <eh.h>
+#include <eh_config.h>
+#include <eh_debug.h>
+#include <eh_mem.h>
+
+void stdout_write(void *stream, const uint8_t *buf, size_t size){
+    (void)stream;
+    printf("%.*s", (int)size, (const char*)buf);
+}
+
+#if EH_CONFIG_MEM_PROFILE
+
+#define TEST_BENCH_CNT          (200000)
+
+static void *leak_ptrs[3];
+static int found_churn, found_leak;
+
+static __attribute__((noinline)) void *alloc_churn(size_t size){
+    return eh_malloc(size);
+}
+
+static __attribute__((noinline)) void *alloc_leak(size_t size){
+    return eh_malloc(size);
+}
+
+static uint64_t now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void site_check(const struct eh_mem_profile_site *site){
+    if(site->alloc_cnt == 10 && site->live_cnt == 0 && site->total_size == 1000 && site->peak_live_size == 1000)
+        found_churn++;
+    if(site->alloc_cnt == 3 && site->live_cnt == 3 && site->live_size == 768)
+        found_leak++;
+}
+
+static void bench(void){
+    uint64_t t, raw_ns, profile_ns;
+    void *p;
+    int i;
+
+    t = now_ns();
+    for(i = 0; i < TEST_BENCH_CNT; i++){
+        p = eh_mem_raw_malloc(64);
+        eh_mem_raw_free(p);
+    }
+    raw_ns = now_ns() - t;
+
+    t = now_ns();
+    for(i = 0; i < TEST_BENCH_CNT; i++){
+        p = eh_malloc(64);
+        eh_free(p);
+    }
+    profile_ns = now_ns() - t;
+    eh_infofl("malloc+free pair: raw %lluns, profiled %lluns",
+        (unsigned long long)(raw_ns / TEST_BENCH_CNT), (unsigned long long)(profile_ns / TEST_BENCH_CNT));
+}
+
+int main(void){
+    void *churn[10];
+    int ret = 0;
+    int i;
+
+    eh_global_init();
+    for(i = 0; i < 10; i++)
+        churn[i] = alloc_churn(100);
+    for(i = 0; i < 10; i++)
+        eh_free(churn[i]);
+    for(i = 0; i < 3; i++)
+        leak_ptrs[i] = alloc_leak(256);
+
+    eh_mem_profile_for_each_site(site_check);
+    if(found_churn != 1 || found_leak != 1){
+        eh_errfl("site statistics mismatch churn=%d leak=%d", found_churn, found_leak);
+        ret = -1;
+    }
+    eh_mem_profile_dump(8);
+    eh_mem_profile_dump_live(8);
+
+    for(i = 0; i < 3; i++)
+        eh_free(leak_ptrs[i]);
+    bench();
+    eh_infofl("result: %s", ret == 0 ? "pass" : "fail");
+    eh_global_exit();
+    return ret;
+}
+
+#else
+
+int main(void){
+    eh_infofl("EH_CONFIG_MEM_PROFILE is disabled.");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,181 @@
+/**
+ * @file test_mem_realloc.c
+ * @brief eh_calloc/eh_realloc/eh_malloc_aligned测试，检查清零、溢出、对齐、内容保留，
+ *        内置堆下检查相邻块空闲时原地扩展，并对比逐步增长缓冲区时eh_realloc与malloc+拷贝+free的耗时
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <eh.h>
+#include <eh_config.h>
+#include <eh_debug.h>
+#include <eh_mem.h>
+
+#define TEST_GROW_STEP          (64)
+#define TEST_GROW_MAX           (32*1024)
+#define TEST_BENCH_ROUND        (200)
+
+#if (defined(EH_CONFIG_USE_LIBC_MEM_MANAGE)) && (EH_CONFIG_USE_LIBC_MEM_MANAGE == 1)
+#define TEST_BUILTIN_HEAP       0
+#define heap_free_size()        ((size_t)0)
+#else
+#define TEST_BUILTIN_HEAP       1
+static size_t heap_free_size(void){
+    struct eh_mem_heap_info info;
+    eh_mem_get_heap_info(&info);
+    return info.free_size;
+}
+#endif
+
+void stdout_write(void *stream, const uint8_t *buf, size_t size){
+    (void)stream;
+    printf("%.*s", (int)size, (const char*)buf);
+}
+
+static uint64_t now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int test_calloc(void){
+    uint8_t *p;
+    p = eh_malloc(1000);
+    EH_DBG_ERROR_EXEC(p == NULL, return -1);
+    memset(p, 0xff, 1000);
+    eh_free(p);
+    p = eh_calloc(10, 100);
+    EH_DBG_ERROR_EXEC(p == NULL, return -1);
+    for(int i = 0; i < 1000; i++)
+        EH_DBG_ERROR_EXEC(p[i] != 0, goto error);
+    eh_free(p);
+    EH_DBG_ERROR_EXEC(eh_calloc(SIZE_MAX / 2, 4) != NULL, return -1);
+    return 0;
+error:
+    eh_free(p);
+    return -1;
+}
+
+static int test_aligned(void){
+    static const size_t aligns[] = {8, 16, 64, 256, 4096};
+    void *p[5];
+    size_t i;
+
+    EH_DBG_ERROR_EXEC(eh_malloc_aligned(48, 64) != NULL, return -1);
+    for(i = 0; i < 5; i++){
+        p[i] = eh_malloc_aligned(aligns[i], 100 + i * 300);
+        EH_DBG_ERROR_EXEC(p[i] == NULL, return -1);
+        EH_DBG_ERROR_EXEC(((uintptr_t)p[i] & (aligns[i] - 1)) != 0, return -1);
+        memset(p[i], (int)i, 100 + i * 300);
+    }
+    for(i = 0; i < 5; i++)
+        EH_DBG_ERROR_EXEC(((uint8_t*)p[i])[99 + i * 300] != (uint8_t)i, return -1);
+    for(i = 0; i < 5; i++)
+        eh_free(p[i]);
+    return 0;
+}
+
+static int test_realloc(void){
+    uint8_t *x, *y, *z, *n;
+    int i;
+
+    EH_DBG_ERROR_EXEC(eh_realloc(NULL, 0) != NULL, return -1);
+    x = eh_realloc(NULL, 64);
+    y = eh_malloc(512);
+    z = eh_malloc(64);
+    EH_DBG_ERROR_EXEC(x == NULL || y == NULL || z == NULL, return -1);
+    for(i = 0; i < 64; i++)
+        x[i] = (uint8_t)i;
+    /* y释放后紧跟在x后面的就是空闲块，内置堆应原地扩展 */
+    eh_free(y);
+    n = eh_realloc(x, 400);
+    EH_DBG_ERROR_EXEC(n == NULL, return -1);
+    EH_DBG_ERROR_EXEC(TEST_BUILTIN_HEAP && n != x, return -1);
+    x = n;
+    for(i = 0; i < 64; i++)
+        EH_DBG_ERROR_EXEC(x[i] != (uint8_t)i, return -1);
+    /* 缩小原地完成 */
+    n = eh_realloc(x, 32);
+    EH_DBG_ERROR_EXEC(n == NULL, return -1);
+    EH_DBG_ERROR_EXEC(TEST_BUILTIN_HEAP && n != x, return -1);
+    x = n;
+    /* 后面是已用块，只能搬走 */
+    n = eh_realloc(x, 4096);
+    EH_DBG_ERROR_EXEC(n == NULL, return -1);
+    x = n;
+    for(i = 0; i < 32; i++)
+        EH_DBG_ERROR_EXEC(x[i] != (uint8_t)i, return -1);
+    EH_DBG_ERROR_EXEC(eh_realloc(x, 0) != NULL, return -1);
+    eh_free(z);
+    return 0;
+}
+
+static void bench(void){
+    uint64_t t, copy_ns, realloc_ns;
+    size_t size, in_place = 0, steps = 0;
+    uint8_t *buf, *n;
+    int r;
+
+    t = now_ns();
+    for(r = 0; r < TEST_BENCH_ROUND; r++){
+        buf = eh_malloc(TEST_GROW_STEP);
+        for(size = TEST_GROW_STEP * 2; buf && size <= TEST_GROW_MAX; size += TEST_GROW_STEP){
+            n = eh_malloc(size);
+            if(n)
+                memcpy(n, buf, size - TEST_GROW_STEP);
+            eh_free(buf);
+            buf = n;
+        }
+        eh_free(buf);
+    }
+    copy_ns = now_ns() - t;
+
+    t = now_ns();
+    for(r = 0; r < TEST_BENCH_ROUND; r++){
+        buf = eh_malloc(TEST_GROW_STEP);
+        for(size = TEST_GROW_STEP * 2; buf && size <= TEST_GROW_MAX; size += TEST_GROW_STEP){
+            n = eh_realloc(buf, size);
+            if(n == NULL)
+                eh_free(buf);
+            in_place += n == buf;
+            steps++;
+            buf = n;
+        }
+        eh_free(buf);
+    }
+    realloc_ns = now_ns() - t;
+
+    eh_infofl("grow %d..%d step %d: malloc+copy+free %lluus, eh_realloc %lluus, in place %lu/%lu",
+        TEST_GROW_STEP, TEST_GROW_MAX, TEST_GROW_STEP,
+        (unsigned long long)(copy_ns / TEST_BENCH_ROUND / 1000), (unsigned long long)(realloc_ns / TEST_BENCH_ROUND / 1000),
+        (unsigned long)in_place, (unsigned long)steps);
+}
+
+int main(void){
+    size_t free_size;
+    int fail = 0;
+
+    eh_global_init();
+    free_size = heap_free_size();
+    if(test_calloc() < 0)
+        fail++;
+    if(test_aligned() < 0)
+        fail++;
+    if(test_realloc() < 0)
+        fail++;
+    if(heap_free_size() != free_size){
+        eh_errfl("heap free size %lu != %lu", (unsigned long)heap_free_size(), (unsigned long)free_size);
+        fail++;
+    }
+    bench();
+    eh_infofl("fail=%d", fail);
+    eh_global_exit();
+    return fail ? -1 : 0;
+}
@@ -0,0 +1,289 @@
+/**
+ * @file test_mpsc_queue.c
+ * @brief 多生产者单消费者队列测试，检查有界队列满/空、成批出队、多线程下每个生产者的顺序与总数，
+ *        无界侵入式队列的哨兵处理与多线程正确性，并在1~16个生产者线程下对比有界队列、
+ *        无界队列与临界区保护的 eh_llist 的吞吐
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <eh.h>
+#include <eh_debug.h>
+#include <eh_error.h>
+#include <eh_llist.h>
+#include <eh_platform.h>
+#include <eh_mpsc_queue.h>
+
+#define TEST_PRODUCER_MAX       (16)
+#define TEST_ITEM_CNT           (200000)
+#define TEST_BATCH              (64)
+
+enum test_kind{
+    TEST_KIND_BOUNDED,
+    TEST_KIND_LIST,
+    TEST_KIND_CRITICAL,
+};
+
+struct test_item{
+    uint32_t                    producer;
+    uint32_t                    seq;
+};
+
+struct test_node{
+    struct eh_llist_node        node;
+    struct test_item            item;
+};
+
+struct test_ctx{
+    enum test_kind              kind;
+    eh_mpsc_queue_t             *queue;
+    struct eh_mpsc_list         list;
+    struct eh_llist_head        llist;
+    struct test_node            *nodes;
+    int                         producer_cnt;
+    uint32_t                    item_cnt;
+    volatile bool               start;
+};
+
+struct test_producer{
+    struct test_ctx             *ctx;
+    uint32_t                    id;
+};
+
+void stdout_write(void *stream, const uint8_t *buf, size_t size){
+    (void)stream;
+    printf("%.*s", (int)size, (const char*)buf);
+}
+
+static uint64_t now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int test_bounded_basics(void){
+    struct test_item item, out[8];
+    eh_mpsc_queue_t *queue;
+    uint32_t i;
+
+    queue = eh_mpsc_queue_create(sizeof(struct test_item), 5);
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(queue) < 0, return -1);
+    EH_DBG_ERROR_EXEC(eh_mpsc_queue_capacity(queue) != 8, goto error);
+    EH_DBG_ERROR_EXEC(!eh_mpsc_queue_empty(queue) || eh_mpsc_queue_pop(queue, &item), goto error);
+    for(i = 0; i < 8; i++){
+        item.producer = 0;
+        item.seq = i;
+        EH_DBG_ERROR_EXEC(eh_mpsc_queue_push(queue, &item) != 0, goto error);
+    }
+    EH_DBG_ERROR_EXEC(eh_mpsc_queue_push(queue, &item) != EH_RET_BUSY, goto error);
+    EH_DBG_ERROR_EXEC(eh_mpsc_queue_pop_batch(queue, out, 3) != 3 || out[2].seq != 2, goto error);
+    /* 绕回之后继续使用 */
+    for(i = 8; i < 11; i++){
+        item.seq = i;
+        EH_DBG_ERROR_EXEC(eh_mpsc_queue_push(queue, &item) != 0, goto error);
+    }
+    EH_DBG_ERROR_EXEC(eh_mpsc_queue_pop_batch(queue, out, 8) != 8, goto error);
+    for(i = 0; i < 8; i++)
+        EH_DBG_ERROR_EXEC(out[i].seq != i + 3, goto error);
+    EH_DBG_ERROR_EXEC(!eh_mpsc_queue_empty(queue), goto error);
+    eh_mpsc_queue_destroy(queue);
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(eh_mpsc_queue_create(0, 8)) != EH_RET_INVALID_PARAM, return -1);
+    return 0;
+error:
+    eh_mpsc_queue_destroy(queue);
+    return -1;
+}
+
+static int test_list_basics(void){
+    struct test_node nodes[4];
+    struct eh_mpsc_list list;
+    struct eh_llist_head out, *head = &out;
+    struct eh_llist_node *node;
+    int i;
+
+    eh_mpsc_list_init(&list);
+    eh_llist_head_init(&out);
+    EH_DBG_ERROR_EXEC(!eh_mpsc_list_empty(&list) || eh_mpsc_list_pop(&list) != NULL, return -1);
+    /* 单个节点需要放回哨兵才能取走 */
+    eh_mpsc_list_push(&list, &nodes[0].node);
+    EH_DBG_ERROR_EXEC(eh_mpsc_list_empty(&list), return -1);
+    EH_DBG_ERROR_EXEC(eh_mpsc_list_pop(&list) != &nodes[0].node, return -1);
+    EH_DBG_ERROR_EXEC(!eh_mpsc_list_empty(&list) || eh_mpsc_list_pop(&list) != NULL, return -1);
+    for(i = 0; i < 4; i++){
+        nodes[i].item.seq = (uint32_t)i;
+        eh_mpsc_list_push(&list, &nodes[i].node);
+    }
+    EH_DBG_ERROR_EXEC(eh_mpsc_list_pop_batch(&list, &out, 3) != 3, return -1);
+    EH_DBG_ERROR_EXEC(eh_mpsc_list_pop_batch(&list, &out, 3) != 1, return -1);
+    i = 0;
+    eh_llist_for_each(node, head){
+        EH_DBG_ERROR_EXEC(eh_llist_entry(node, struct test_node, node)->item.seq != (uint32_t)i, return -1);
+        i++;
+    }
+    EH_DBG_ERROR_EXEC(i != 4 || !eh_mpsc_list_empty(&list), return -1);
+    return 0;
+}
+
+static void* producer_function(void *arg){
+    struct test_producer *producer = (struct test_producer *)arg;
+    struct test_ctx *ctx = producer->ctx;
+    struct test_node *node;
+    struct test_item item;
+    eh_save_state_t state;
+
+    while(!ctx->start)
+        sched_yield();
+    item.producer = producer->id;
+    for(item.seq = 0; item.seq < ctx->item_cnt; item.seq++){
+        switch(ctx->kind){
+            case TEST_KIND_BOUNDED:
+                /* 队列满时让出CPU给消费者 */
+                while(eh_mpsc_queue_push(ctx->queue, &item) != 0)
+                    sched_yield();
+                break;
+            case TEST_KIND_LIST:
+                node = &ctx->nodes[producer->id * ctx->item_cnt + item.seq];
+                node->item = item;
+                eh_mpsc_list_push(&ctx->list, &node->node);
+                break;
+            case TEST_KIND_CRITICAL:
+                node = &ctx->nodes[producer->id * ctx->item_cnt + item.seq];
+                node->item = item;
+                state = eh_enter_critical();
+                eh_llist_enqueue(&node->node, &ctx->llist);
+                eh_exit_critical(state);
+                break;
+        }
+    }
+    return NULL;
+}
+
+static uint32_t consumer_drain(struct test_ctx *ctx, struct test_item *items){
+    struct eh_llist_head out;
+    struct eh_llist_node *node;
+    eh_save_state_t state;
+    uint32_t n = 0;
+
+    switch(ctx->kind){
+        case TEST_KIND_BOUNDED:
+            return eh_mpsc_queue_pop_batch(ctx->queue, items, TEST_BATCH);
+        case TEST_KIND_LIST:
+            eh_llist_head_init(&out);
+            eh_mpsc_list_pop_batch(&ctx->list, &out, TEST_BATCH);
+            break;
+        case TEST_KIND_CRITICAL:
+            state = eh_enter_critical();
+            eh_llist_head_move_init(&ctx->llist, &out);
+            eh_exit_critical(state);
+            break;
+    }
+    while((node = eh_llist_dequeue(&out)) != NULL){
+        /* 临界区版本一次取走整个链表，不做顺序检查 */
+        if(n < TEST_BATCH)
+            items[n] = eh_llist_entry(node, struct test_node, node)->item;
+        n++;
+    }
+    return n;
+}
+
+/* 返回耗时，顺序或总数错误时返回0 */
+static uint64_t run(enum test_kind kind, int producer_cnt, uint32_t item_cnt){
+    static struct test_ctx ctx;
+    struct test_producer producer[TEST_PRODUCER_MAX];
+    pthread_t thread[TEST_PRODUCER_MAX];
+    uint32_t next_seq[TEST_PRODUCER_MAX] = {0};
+    struct test_item items[TEST_BATCH];
+    uint64_t total = (uint64_t)producer_cnt * item_cnt, received = 0, t;
+    bool ordered = true;
+    uint32_t n;
+
+    ctx.kind = kind;
+    ctx.producer_cnt = producer_cnt;
+    ctx.item_cnt = item_cnt;
+    ctx.start = false;
+    ctx.queue = eh_mpsc_queue_create(sizeof(struct test_item), 4096);
+    if(eh_ptr_to_error(ctx.queue) < 0)
+        return 0;
+    /* 节点数量超出内置堆的大小，直接使用libc */
+    ctx.nodes = malloc(sizeof(struct test_node) * total);
+    if(ctx.nodes == NULL){
+        eh_mpsc_queue_destroy(ctx.queue);
+        return 0;
+    }
+    eh_mpsc_list_init(&ctx.list);
+    eh_llist_head_init(&ctx.llist);
+    for(int i = 0; i < producer_cnt; i++){
+        producer[i].ctx = &ctx;
+        producer[i].id = (uint32_t)i;
+        pthread_create(&thread[i], NULL, producer_function, &producer[i]);
+    }
+    t = now_ns();
+    ctx.start = true;
+    while(received < total){
+        n = consumer_drain(&ctx, items);
+        if(n == 0)
+            sched_yield();
+        for(uint32_t i = 0; i < n && i < TEST_BATCH && kind != TEST_KIND_CRITICAL; i++){
+            if(items[i].seq != next_seq[items[i].producer]++)
+                ordered = false;
+        }
+        received += n;
+    }
+    t = now_ns() - t;
+    for(int i = 0; i < producer_cnt; i++)
+        pthread_join(thread[i], NULL);
+    /* 队列销毁前确认已经没有剩余的消息 */
+    if(consumer_drain(&ctx, items) != 0)
+        ordered = false;
+    eh_mpsc_queue_destroy(ctx.queue);
+    free(ctx.nodes);
+    if(!ordered || received != total)
+        return 0;
+    return t ? t : 1;
+}
+
+static int test_threads(void){
+    EH_DBG_ERROR_EXEC(run(TEST_KIND_BOUNDED, 8, TEST_ITEM_CNT / 4) == 0, return -1);
+    EH_DBG_ERROR_EXEC(run(TEST_KIND_LIST, 8, TEST_ITEM_CNT / 4) == 0, return -1);
+    return 0;
+}
+
+static void bench(void){
+    static const char *name[] = {"bounded", "list", "critical+llist"};
+    uint64_t t;
+
+    for(int producer_cnt = 1; producer_cnt <= TEST_PRODUCER_MAX; producer_cnt <<= 1){
+        for(int kind = TEST_KIND_BOUNDED; kind <= TEST_KIND_CRITICAL; kind++){
+            t = run((enum test_kind)kind, producer_cnt, TEST_ITEM_CNT);
+            eh_infofl("%2d producers %-15s %.2fM items/s", producer_cnt, name[kind],
+                t ? (double)producer_cnt * TEST_ITEM_CNT * 1000.0 / (double)t : 0.0);
+        }
+    }
+}
+
+int main(void){
+    int fail = 0;
+
+    eh_global_init();
+    if(test_bounded_basics() < 0)
+        fail++;
+    if(test_list_basics() < 0)
+        fail++;
+    if(test_threads() < 0)
+        fail++;
+    bench();
+    eh_infofl("fail=%d", fail);
+    eh_global_exit();
+    return fail ? -1 : 0;
+}
@@ -0,0 +1,248 @@
+/**
+ * @file test_msgring.c
+ * @brief eh_msgring测试，检查记录的连续性、尾部填充、提交时缩短、满/空判断、单读单写线程下的记录顺序与内容，
+ *        并对比在 eh_ringbuf 上手工编码长度前缀再用 eh_ringbuf_peek_copy 解析与 eh_msgring 0拷贝读取的耗时
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <eh.h>
+#include <eh_debug.h>
+#include <eh_error.h>
+#include <eh_ringbuf.h>
+#include <eh_msgring.h>
+
+#define TEST_RING_SIZE          (4096)
+#define TEST_RECORD_CNT         (200000)
+#define TEST_RECORD_MAX         (512)
+#define TEST_BENCH_BATCH        (16)
+#define TEST_BENCH_ROUND        (5)
+
+void stdout_write(void *stream, const uint8_t *buf, size_t size){
+    (void)stream;
+    printf("%.*s", (int)size, (const char*)buf);
+}
+
+static uint64_t now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t record_len(uint32_t seq){
+    uint32_t x = seq * 2654435761U;
+    return (x >> 16) % TEST_RECORD_MAX;
+}
+
+static void record_fill(uint8_t *record, uint32_t seq, uint32_t len){
+    for(uint32_t i = 0; i < len; i++)
+        record[i] = (uint8_t)(seq + i);
+}
+
+static int record_check(const uint8_t *record, uint32_t seq, uint32_t len){
+    if(len != record_len(seq))
+        return -1;
+    for(uint32_t i = 0; i < len; i++){
+        if(record[i] != (uint8_t)(seq + i))
+            return -1;
+    }
+    return 0;
+}
+
+static int test_basics(void){
+    eh_msgring_t *msgring;
+    const uint8_t *record;
+    uint8_t *slot;
+    uint32_t len;
+
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(eh_msgring_create(100, NULL)) != EH_RET_INVALID_PARAM, return -1);
+    msgring = eh_msgring_create(256, NULL);
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(msgring) < 0, return -1);
+    EH_DBG_ERROR_EXEC(eh_msgring_max_len(msgring) != 120, goto error);
+    EH_DBG_ERROR_EXEC(!eh_msgring_empty(msgring) || eh_msgring_peek(msgring, &len) != NULL, goto error);
+    EH_DBG_ERROR_EXEC(eh_msgring_reserve(msgring, 121) != NULL, goto error);
+    EH_DBG_ERROR_EXEC(eh_msgring_write(msgring, "x", 121) != EH_RET_INVALID_PARAM, goto error);
+
+    /* 预留100字节只提交3字节，多出的空间还给缓冲区 */
+    slot = eh_msgring_reserve(msgring, 100);
+    EH_DBG_ERROR_EXEC(slot == NULL || ((uintptr_t)slot & 7), goto error);
+    memcpy(slot, "abc", 3);
+    EH_DBG_ERROR_EXEC(eh_msgring_commit(msgring, 3) != 0, goto error);
+    /* 没有未提交的预留 */
+    EH_DBG_ERROR_EXEC(eh_msgring_commit(msgring, 3) != EH_RET_INVALID_PARAM, goto error);
+    EH_DBG_ERROR_EXEC(eh_msgring_write(msgring, "0123456789abcdefghijklmnopqrstuvwxyz", 36) != 0, goto error);
+    EH_DBG_ERROR_EXEC(eh_msgring_reserve(msgring, 100) == NULL, goto error);
+    /* 提交长度不能超过预留长度 */
+    EH_DBG_ERROR_EXEC(eh_msgring_commit(msgring, 101) != EH_RET_INVALID_PARAM, goto error);
+    EH_DBG_ERROR_EXEC(eh_msgring_commit(msgring, 100) != 0, goto error);
+    /* 三条记录共占16+48+112字节，尾部剩余80字节，需要88字节的记录放不下 */
+    EH_DBG_ERROR_EXEC(eh_msgring_write(msgring, "", 73) != EH_RET_BUSY, goto error);
+    record = eh_msgring_peek(msgring, &len);
+    EH_DBG_ERROR_EXEC(record == NULL || len != 3 || memcmp(record, "abc", 3) != 0, goto error);
+    eh_msgring_release(msgring);
+    record = eh_msgring_peek(msgring, &len);
+    EH_DBG_ERROR_EXEC(record == NULL || len != 36 || record[35] != 'z', goto error);
+    eh_msgring_release(msgring);
+    /* 总空闲144字节，但开头只有64字节，不拆成两段 */
+    EH_DBG_ERROR_EXEC(eh_msgring_reserve(msgring, 80) != NULL, goto error);
+    record = eh_msgring_peek(msgring, &len);
+    EH_DBG_ERROR_EXEC(record == NULL || len != 100, goto error);
+    eh_msgring_release(msgring);
+
+    /* 尾部填充80字节后从开头重新开始 */
+    slot = eh_msgring_reserve(msgring, 80);
+    EH_DBG_ERROR_EXEC(slot != msgring->buf + 8, goto error);
+    memset(slot, 0x5a, 80);
+    eh_msgring_commit(msgring, 80);
+    /* 读者跳过填充记录 */
+    record = eh_msgring_peek(msgring, &len);
+    EH_DBG_ERROR_EXEC(record != msgring->buf + 8 || len != 80 || record[79] != 0x5a, goto error);
+    eh_msgring_release(msgring);
+    EH_DBG_ERROR_EXEC(!eh_msgring_empty(msgring), goto error);
+    eh_msgring_destroy(msgring);
+    return 0;
+error:
+    eh_msgring_destroy(msgring);
+    return -1;
+}
+
+static void* producer_function(void *arg){
+    eh_msgring_t *msgring = (eh_msgring_t *)arg;
+    uint8_t *slot;
+    uint32_t len;
+
+    for(uint32_t seq = 0; seq < TEST_RECORD_CNT; seq++){
+        len = record_len(seq);
+        while((slot = eh_msgring_reserve(msgring, len)) == NULL)
+            sched_yield();
+        record_fill(slot, seq, len);
+        eh_msgring_commit(msgring, len);
+    }
+    return NULL;
+}
+
+static int test_threads(void){
+    eh_msgring_t *msgring;
+    const uint8_t *record;
+    pthread_t thread;
+    uint32_t seq = 0, len;
+    int ret = 0;
+
+    msgring = eh_msgring_create(TEST_RING_SIZE, NULL);
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(msgring) < 0, return -1);
+    pthread_create(&thread, NULL, producer_function, msgring);
+    while(seq < TEST_RECORD_CNT){
+        record = eh_msgring_peek(msgring, &len);
+        if(record == NULL){
+            sched_yield();
+            continue;
+        }
+        if(ret == 0 && record_check(record, seq, len) < 0){
+            eh_errfl("record %u mismatch, len %u", seq, len);
+            ret = -1;
+        }
+        eh_msgring_release(msgring);
+        seq++;
+    }
+    pthread_join(thread, NULL);
+    if(!eh_msgring_empty(msgring))
+        ret = -1;
+    eh_msgring_destroy(msgring);
+    return ret;
+}
+
+static uint64_t bench_ringbuf(eh_ringbuf_t *ringbuf, const uint8_t *src, uint32_t *sum){
+    uint8_t record[TEST_RECORD_MAX];
+    uint32_t seq = 0, len;
+    uint64_t t = now_ns();
+
+    while(seq < TEST_RECORD_CNT){
+        for(int i = 0; i < TEST_BENCH_BATCH && seq + (uint32_t)i < TEST_RECORD_CNT; i++){
+            len = record_len(seq + (uint32_t)i);
+            eh_ringbuf_write(ringbuf, (const uint8_t *)&len, sizeof(len));
+            eh_ringbuf_write(ringbuf, src, (int32_t)len);
+        }
+        while(eh_ringbuf_peek_copy(ringbuf, 0, (uint8_t *)&len, sizeof(len)) == sizeof(len)){
+            eh_ringbuf_read_skip(ringbuf, sizeof(len));
+            eh_ringbuf_read(ringbuf, record, (int32_t)len);
+            *sum += len ? record[len - 1] : 0;
+            seq++;
+        }
+    }
+    return now_ns() - t;
+}
+
+static uint64_t bench_msgring(eh_msgring_t *msgring, const uint8_t *src, uint32_t *sum){
+    const uint8_t *record;
+    uint8_t *slot;
+    uint32_t seq = 0, len;
+    uint64_t t = now_ns();
+
+    while(seq < TEST_RECORD_CNT){
+        for(int i = 0; i < TEST_BENCH_BATCH && seq + (uint32_t)i < TEST_RECORD_CNT; i++){
+            len = record_len(seq + (uint32_t)i);
+            slot = eh_msgring_reserve(msgring, len);
+            memcpy(slot, src, len);
+            eh_msgring_commit(msgring, len);
+        }
+        while((record = eh_msgring_peek(msgring, &len)) != NULL){
+            *sum += len ? record[len - 1] : 0;
+            eh_msgring_release(msgring);
+            seq++;
+        }
+    }
+    return now_ns() - t;
+}
+
+static void bench(void){
+    static uint8_t src[TEST_RECORD_MAX];
+    eh_ringbuf_t *ringbuf;
+    eh_msgring_t *msgring;
+    uint64_t t, ringbuf_ns = UINT64_MAX, msgring_ns = UINT64_MAX;
+    uint32_t ringbuf_sum = 0, msgring_sum = 0;
+
+    ringbuf = eh_ringbuf_create(TEST_RING_SIZE * 4, NULL);
+    msgring = eh_msgring_create(TEST_RING_SIZE * 4, NULL);
+    if(eh_ptr_to_error(ringbuf) < 0 || eh_ptr_to_error(msgring) < 0)
+        goto out;
+    for(int i = 0; i < TEST_RECORD_MAX; i++)
+        src[i] = (uint8_t)i;
+    for(int r = 0; r < TEST_BENCH_ROUND; r++){
+        t = bench_ringbuf(ringbuf, src, &ringbuf_sum);
+        ringbuf_ns = t < ringbuf_ns ? t : ringbuf_ns;
+        t = bench_msgring(msgring, src, &msgring_sum);
+        msgring_ns = t < msgring_ns ? t : msgring_ns;
+    }
+    if(ringbuf_sum != msgring_sum)
+        eh_errfl("checksum mismatch %u %u", ringbuf_sum, msgring_sum);
+    eh_infofl("%d records of 0~%d bytes: ringbuf length prefix %.1fns/record, msgring %.1fns/record",
+        TEST_RECORD_CNT, TEST_RECORD_MAX - 1, (double)ringbuf_ns / TEST_RECORD_CNT, (double)msgring_ns / TEST_RECORD_CNT);
+out:
+    if(eh_ptr_to_error(ringbuf) >= 0)
+        eh_ringbuf_destroy(ringbuf);
+    if(eh_ptr_to_error(msgring) >= 0)
+        eh_msgring_destroy(msgring);
+}
+
+int main(void){
+    int fail = 0;
+
+    eh_global_init();
+    if(test_basics() < 0)
+        fail++;
+    if(test_threads() < 0)
+        fail++;
+    bench();
+    eh_infofl("fail=%d", fail);
+    eh_global_exit();
+    return fail ? -1 : 0;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file test_offload.c
+ * @brief 阻塞调用卸载测试，多个任务同时卸载阻塞调用，计时任务不应被阻塞
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <eh.h>
+#include <eh_debug.h>
+#include <eh_sleep.h>
+#include <eh_platform.h>
+#include <eh_offload.h>
+
+#define TEST_TASK_CNT       8
+
+void stdout_write(void *stream, const uint8_t *buf, size_t size){
+    (void)stream;
+    printf("%.*s", (int)size, (const char*)buf);
+}
+
+static void* blocking_call(void *arg){
+    intptr_t n = (intptr_t)arg;
+    /* 模拟一个慢速的 fsync */
+    usleep(200*1000);
+    return (void*)(n * n);
+}
+
+static int task_offload(void *arg){
+    void *result;
+    int ret;
+    ret = __await eh_offload(blocking_call, arg, &result);
+    EH_DBG_ERROR_EXEC(ret < 0, return ret);
+    eh_infofl("offload %d result=%d", (int)(intptr_t)arg, (int)(intptr_t)result);
+    return (int)(intptr_t)result == (int)((intptr_t)arg * (intptr_t)arg) ? 0 : -1;
+}
+
+static int task_ticker(void *arg){
+    volatile bool *stop = (volatile bool *)arg;
+    eh_clock_t last, now, max_gap = 0;
+    last = eh_get_clock_monotonic_time();
+    while(!*stop){
+        __await eh_usleep(10*1000);
+        now = eh_get_clock_monotonic_time();
+        if(now - last > max_gap)
+            max_gap = now - last;
+        last = now;
+    }
+    eh_infofl("ticker max gap %lluus", (unsigned long long)eh_clock_to_usec(max_gap));
+    return 0;
+}
+
+int task_app(void *arg){
+    (void)arg;
+    eh_task_t *tasks[TEST_TASK_CNT];
+    eh_task_t *ticker;
+    struct eh_offload_stat stat;
+    volatile bool stop = false;
+    eh_clock_t start;
+    int task_ret, fail = 0;
+
+    ticker = eh_task_create("ticker", 0, 12*1024, (void*)&stop, task_ticker);
+    start = eh_get_clock_monotonic_time();
+    for(intptr_t i = 0; i < TEST_TASK_CNT; i++)
+        tasks[i] = eh_task_create("offload", 0, 12*1024, (void*)(i + 1), task_offload);
+    for(int i = 0; i < TEST_TASK_CNT; i++){
+        __await eh_task_join(tasks[i], &task_ret, EH_TIME_FOREVER);
+        if(task_ret < 0)
+            fail++;
+    }
+    eh_infofl("all done in %llums fail=%d",
+        (unsigned long long)eh_clock_to_msec(eh_get_clock_monotonic_time() - start), fail);
+    stop = true;
+    __await eh_task_join(ticker, NULL, EH_TIME_FOREVER);
+
+    eh_offload_get_stat(&stat);
+    eh_infofl("workers=%u busy=%u queue_depth=%u max_queue_depth=%u submit=%llu complete=%llu",
+        stat.worker_cnt, stat.busy_worker_cnt, stat.queue_depth, stat.max_queue_depth,
+        (unsigned long long)stat.submit_cnt, (unsigned long long)stat.complete_cnt);
+    eh_infofl("avg wait=%lluus avg run=%lluus max latency=%lluus",
+        (unsigned long long)eh_clock_to_usec(stat.total_wait_time / stat.complete_cnt),
+        (unsigned long long)eh_clock_to_usec(stat.total_run_time / stat.complete_cnt),
+        (unsigned long long)eh_clock_to_usec(stat.max_latency));
+    return fail ? -1 : 0;
+}
+
+int main(void){
+    int ret;
+    eh_global_init();
+    ret = task_app("task_app");
+    eh_global_exit();
+    return ret;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file test_posix_signal.c
+ * @brief POSIX信号测试，SIGUSR1由槽函数处理，大量子进程退出产生的SIGCHLD在槽函数中批量回收
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <eh.h>
+#include <eh_debug.h>
+#include <eh_signal.h>
+#include <eh_timer.h>
+#include <eh_posix_signal.h>
+
+#define TEST_CHILD_CNT      32
+
+static int reaped_cnt;
+static int usr1_cnt;
+
+void stdout_write(void *stream, const uint8_t *buf, size_t size){
+    (void)stream;
+    printf("%.*s", (int)size, (const char*)buf);
+}
+
+static void slot_sigusr1(eh_event_t *e, void *slot_param){
+    (void)e;
+    (void)slot_param;
+    usr1_cnt++;
+    eh_infofl("SIGUSR1 from pid %u, total %u",
+        eh_posix_signal_last_info(SIGUSR1)->ssi_pid, eh_posix_signal_cnt(SIGUSR1));
+}
+
+static void slot_sigchld(eh_event_t *e, void *slot_param){
+    (void)e;
+    (void)slot_param;
+    int status;
+    /* 多个SIGCHLD可能被合并为一次通知，必须回收到没有为止 */
+    while(waitpid(-1, &status, WNOHANG) > 0)
+        reaped_cnt++;
+    if(reaped_cnt == TEST_CHILD_CNT)
+        eh_signal_dispatch_loop_request_quit();
+}
+
+static void slot_timeout(eh_event_t *e, void *slot_param){
+    (void)e;
+    (void)slot_param;
+    eh_errfl("timeout!");
+    eh_signal_dispatch_loop_request_quit();
+}
+
+EH_DEFINE_SLOT(sigusr1_slot, slot_sigusr1, NULL);
+EH_DEFINE_SLOT(sigchld_slot, slot_sigchld, NULL);
+EH_DEFINE_SLOT(timeout_slot, slot_timeout, NULL);
+EH_DEFINE_STATIC_CUSTOM_SIGNAL(timeout_signal, eh_event_timer_t, EH_TIMER_INIT(timeout_signal.custom_event));
+
+int task_app(void *arg){
+    (void)arg;
+    pid_t pid;
+
+    EH_DBG_ERROR_EXEC(eh_posix_signal_enable(SIGUSR1) < 0, return -1);
+    EH_DBG_ERROR_EXEC(eh_posix_signal_enable(SIGCHLD) < 0, return -1);
+    EH_DBG_ERROR_EXEC(eh_posix_signal_enable(SIGKILL) != EH_RET_INVALID_PARAM, return -1);
+
+    eh_signal_slot_connect(eh_posix_signal(SIGUSR1), &sigusr1_slot);
+    eh_signal_slot_connect(eh_posix_signal(SIGCHLD), &sigchld_slot);
+    eh_timer_advanced_init(eh_signal_to_custom_event(&timeout_signal),
+        (eh_sclock_t)eh_msec_to_clock(5000), 0);
+    eh_signal_slot_connect(&timeout_signal, &timeout_slot);
+    eh_timer_start(eh_signal_to_custom_event(&timeout_signal));
+
+    kill(getpid(), SIGUSR1);
+    for(int i = 0; i < TEST_CHILD_CNT; i++){
+        pid = fork();
+        if(pid == 0)
+            _exit(0);
+        EH_DBG_ERROR_EXEC(pid < 0, break);
+    }
+
+    eh_signal_dispatch_loop();
+
+    eh_infofl("usr1_cnt=%d reaped=%d sigchld_cnt=%u",
+        usr1_cnt, reaped_cnt, eh_posix_signal_cnt(SIGCHLD));
+
+    eh_timer_stop(eh_signal_to_custom_event(&timeout_signal));
+    eh_signal_slot_clean(&timeout_signal);
+    eh_signal_slot_clean(eh_posix_signal(SIGUSR1));
+    eh_signal_slot_clean(eh_posix_signal(SIGCHLD));
+    eh_posix_signal_disable(SIGUSR1);
+    eh_posix_signal_disable(SIGCHLD);
+    return (usr1_cnt == 1 && reaped_cnt == TEST_CHILD_CNT) ? 0 : -1;
+}
+
+int main(void){
+    int ret;
+    eh_global_init();
+    ret = task_app("task_app");
+    eh_global_exit();
+    return ret;
+}
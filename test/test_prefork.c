@@ -0,0 +1,255 @@
+/**
+ * @file test_prefork.c
+ * @brief 多进程预派生测试，回环地址连接速率基准测试(N=1/2/4)，以及工作进程异常退出后的重启
+ *        工作进程接受连接后回复自己的pid，客户端据此统计连接在各进程间的分布
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <eh.h>
+#include <eh_debug.h>
+#include <eh_event.h>
+#include <eh_platform.h>
+#include <eh_fd_event.h>
+#include <eh_posix_signal.h>
+#include <eh_prefork.h>
+
+#define TEST_CLIENT_THREAD_CNT  4
+#define TEST_DURATION_MS        1000
+#define TEST_PID_SLOT_CNT       8
+
+struct client_ctx{
+    pthread_t                   thread;
+    uint64_t                    conn_cnt;
+    pid_t                       pids[TEST_PID_SLOT_CNT];
+    uint64_t                    pid_cnt[TEST_PID_SLOT_CNT];
+};
+
+static struct sockaddr_in test_addr;
+static volatile bool client_stop;
+
+void stdout_write(void *stream, const uint8_t *buf, size_t size){
+    (void)stream;
+    printf("%.*s", (int)size, (const char*)buf);
+}
+
+static int worker_main(unsigned int worker_id, void *arg){
+    (void)worker_id;
+    (void)arg;
+    eh_fd_event_t listen_event;
+    eh_epoll_t epoll;
+    eh_epoll_slot_t epoll_slot[2];
+    int32_t pid = (int32_t)getpid();
+    bool quit = false;
+    int listen_fd, fd;
+    int ret;
+
+    EH_DBG_ERROR_EXEC(eh_posix_signal_enable(SIGTERM) < 0, return -1);
+    listen_fd = eh_prefork_reuseport_listen((struct sockaddr *)&test_addr, sizeof(test_addr), 1024);
+    EH_DBG_ERROR_EXEC(listen_fd < 0, return -1);
+    EH_DBG_ERROR_EXEC(eh_fd_event_init(&listen_event, listen_fd) < 0, return -1);
+
+    epoll = eh_epoll_new();
+    eh_epoll_add_event(epoll, eh_fd_event_readable(&listen_event), NULL);
+    eh_epoll_add_event(epoll, &eh_posix_signal(SIGTERM)->event, NULL);
+    while(!quit){
+        ret = eh_epoll_wait(epoll, epoll_slot, 2, EH_TIME_FOREVER);
+        if(ret < 0)
+            break;
+        for(int i = 0; i < ret; i++){
+            if(epoll_slot[i].event == &eh_posix_signal(SIGTERM)->event){
+                quit = true;
+                continue;
+            }
+            while((fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC)) >= 0){
+                if(write(fd, &pid, sizeof(pid)) < 0)
+                    eh_warnfl("write error %d", errno);
+                close(fd);
+            }
+        }
+    }
+    eh_epoll_del(epoll);
+    eh_fd_event_clean(&listen_event);
+    close(listen_fd);
+    return 0;
+}
+
+static pid_t client_connect_once(void){
+    struct linger linger = {.l_onoff = 1, .l_linger = 0};
+    int32_t pid = -1;
+    int fd;
+
+    fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(fd < 0)
+        return -1;
+    if( connect(fd, (struct sockaddr *)&test_addr, sizeof(test_addr)) < 0 ||
+        read(fd, &pid, sizeof(pid)) != sizeof(pid) )
+        pid = -1;
+    /* 客户端以RST关闭，避免大量TIME_WAIT耗尽端口 */
+    setsockopt(fd, SOL_SOCKET, SO_LINGER, &linger, sizeof(linger));
+    close(fd);
+    return (pid_t)pid;
+}
+
+static void* client_thread(void *arg){
+    struct client_ctx *ctx = (struct client_ctx *)arg;
+    pid_t pid;
+    int i;
+    while(!client_stop){
+        pid = client_connect_once();
+        if(pid <= 0)
+            continue;
+        ctx->conn_cnt++;
+        for(i = 0; i < TEST_PID_SLOT_CNT && ctx->pids[i] && ctx->pids[i] != pid; i++);
+        if(i < TEST_PID_SLOT_CNT){
+            ctx->pids[i] = pid;
+            ctx->pid_cnt[i]++;
+        }
+    }
+    return NULL;
+}
+
+static pid_t supervisor_start(unsigned int worker_cnt, bool restart){
+    struct eh_prefork_config config = {
+        .worker_cnt = worker_cnt,
+        .cpu_affinity = true,
+        .restart = restart,
+        .worker_main = worker_main,
+        .arg = NULL,
+    };
+    pid_t pid;
+    fflush(NULL);
+    pid = fork();
+    if(pid != 0)
+        return pid;
+    _exit(eh_prefork_run(&config) < 0 ? 1 : 0);
+}
+
+static int supervisor_wait_ready(void){
+    for(int i = 0; i < 200; i++){
+        if(client_connect_once() > 0)
+            return 0;
+        usleep(10*1000);
+    }
+    return -1;
+}
+
+static int supervisor_stop(pid_t supervisor){
+    int status;
+    kill(supervisor, SIGTERM);
+    if(waitpid(supervisor, &status, 0) < 0)
+        return -1;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : -1;
+}
+
+static int bench(unsigned int worker_cnt){
+    struct client_ctx ctx[TEST_CLIENT_THREAD_CNT];
+    pid_t pids[TEST_PID_SLOT_CNT] = {0};
+    uint64_t pid_cnt[TEST_PID_SLOT_CNT] = {0};
+    uint64_t total = 0;
+    pid_t supervisor;
+    int i, j, k;
+
+    supervisor = supervisor_start(worker_cnt, false);
+    EH_DBG_ERROR_EXEC(supervisor < 0, return -1);
+    EH_DBG_ERROR_EXEC(supervisor_wait_ready() < 0, goto error);
+    /* 等待所有工作进程完成监听 */
+    usleep(100*1000);
+
+    memset(ctx, 0, sizeof(ctx));
+    client_stop = false;
+    for(i = 0; i < TEST_CLIENT_THREAD_CNT; i++)
+        pthread_create(&ctx[i].thread, NULL, client_thread, &ctx[i]);
+    usleep(TEST_DURATION_MS*1000);
+    client_stop = true;
+    for(i = 0; i < TEST_CLIENT_THREAD_CNT; i++){
+        pthread_join(ctx[i].thread, NULL);
+        total += ctx[i].conn_cnt;
+        for(j = 0; j < TEST_PID_SLOT_CNT && ctx[i].pids[j]; j++){
+            for(k = 0; k < TEST_PID_SLOT_CNT && pids[k] && pids[k] != ctx[i].pids[j]; k++);
+            if(k == TEST_PID_SLOT_CNT)
+                continue;
+            pids[k] = ctx[i].pids[j];
+            pid_cnt[k] += ctx[i].pid_cnt[j];
+        }
+    }
+    eh_infofl("workers=%u conn/s=%llu", worker_cnt,
+        (unsigned long long)(total * 1000 / TEST_DURATION_MS));
+    for(k = 0; k < TEST_PID_SLOT_CNT && pids[k]; k++)
+        eh_infofl("    worker pid %d: %llu", pids[k], (unsigned long long)pid_cnt[k]);
+    return supervisor_stop(supervisor);
+error:
+    supervisor_stop(supervisor);
+    return -1;
+}
+
+static int restart_test(void){
+    pid_t supervisor, victim, pid;
+    int i;
+
+    supervisor = supervisor_start(1, true);
+    EH_DBG_ERROR_EXEC(supervisor < 0, return -1);
+    EH_DBG_ERROR_EXEC(supervisor_wait_ready() < 0, goto error);
+    victim = client_connect_once();
+    EH_DBG_ERROR_EXEC(victim <= 0, goto error);
+    kill(victim, SIGKILL);
+    for(i = 0; i < 200; i++){
+        pid = client_connect_once();
+        if(pid > 0 && pid != victim)
+            break;
+        usleep(10*1000);
+    }
+    EH_DBG_ERROR_EXEC(i == 200, goto error);
+    eh_infofl("worker %d killed, restarted as %d", victim, pid);
+    return supervisor_stop(supervisor);
+error:
+    supervisor_stop(supervisor);
+    return -1;
+}
+
+int main(void){
+    socklen_t len = sizeof(test_addr);
+    unsigned int worker_cnts[] = {1, 2, 4};
+    int fail = 0;
+    int fd;
+
+    signal(SIGPIPE, SIG_IGN);
+    /* 先借用一个临时套接字拿到空闲端口 */
+    memset(&test_addr, 0, sizeof(test_addr));
+    test_addr.sin_family = AF_INET;
+    test_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    fd = socket(AF_INET, SOCK_STREAM, 0);
+    EH_DBG_ERROR_EXEC(fd < 0, return -1);
+    EH_DBG_ERROR_EXEC(bind(fd, (struct sockaddr *)&test_addr, sizeof(test_addr)) < 0, return -1);
+    getsockname(fd, (struct sockaddr *)&test_addr, &len);
+    close(fd);
+    eh_infofl("listen 127.0.0.1:%u, online cpu %ld", ntohs(test_addr.sin_port), sysconf(_SC_NPROCESSORS_ONLN));
+
+    for(size_t i = 0; i < sizeof(worker_cnts)/sizeof(worker_cnts[0]); i++){
+        if(bench(worker_cnts[i]) < 0)
+            fail++;
+    }
+    if(restart_test() < 0)
+        fail++;
+    eh_infofl("fail=%d", fail);
+    return fail ? -1 : 0;
+}
@@ -228,6 +228,253 @@ ringbuf_create_error:
     return ret;
 }
 
+/* 写线程直接往预留的空间里填数据 */
+void* thread_test_random_reserve_function(void* arg){
+    struct random_wr* rw = (struct random_wr*)arg;
+    struct eh_ringbuf_iovec vec[2];
+    int w_len_sum = 0;
+    for(int i=0; i < rw->cnt && !(volatile bool)rw->exit ; i++){
+        int fsize = eh_ringbuf_free_size(rw->ringbuf);
+        if(fsize == 0){
+            usleep(10);
+            continue;
+        }
+        int w_size = eh_ringbuf_write_reserve(rw->ringbuf, vec, rand() % (fsize+1));
+        for(int n=0, k=0; n < 2; n++){
+            for(int j=0; j < vec[n].len; j++, k++)
+                vec[n].base[j] = (uint8_t)(k+w_len_sum);
+        }
+        w_len_sum += eh_ringbuf_write_commit(rw->ringbuf, w_size);
+        eh_event_notify(&rw->w_event);
+    }
+    eh_event_notify(&rw->exit_event);
+    return 0;
+}
+
+int test_random_reserve_acquire(int32_t size, uint32_t cnt){
+    struct random_wr rw;
+    struct eh_ringbuf_iovec vec[2];
+    eh_epoll_slot_t  epoll_slot;
+    eh_epoll_t       test_epoll;
+    pthread_t thread_id;
+    int ret = 0;
+    int r_len_sum = 0;
+    rw.cnt = (int)cnt;
+    rw.exit = false;
+    srand((unsigned int)time(NULL));
+    eh_event_init(&rw.exit_event);
+    eh_event_init(&rw.w_event);
+    test_epoll = eh_epoll_new();
+    if(eh_ptr_to_error(test_epoll))
+        return -1;
+    EH_DBG_ERROR_EXEC((rw.ringbuf = eh_ringbuf_create(size, NULL)) == NULL, ret= -1; goto ringbuf_create_error );
+    
+    eh_epoll_add_event(test_epoll, &rw.w_event, NULL);
+    eh_epoll_add_event(test_epoll, &rw.exit_event, NULL);
+
+    if (pthread_create(&thread_id, NULL, thread_test_random_reserve_function, &rw) != 0) {
+        eh_debugfl("pthread_create error!");
+        return -1;
+    }
+
+    while(1){
+        ret = eh_epoll_wait(test_epoll, &epoll_slot, 1, EH_TIME_FOREVER);
+        if(ret < 0){
+            eh_errfl("epoll_wait error %d", ret);
+            goto out;
+        }
+        
+        if(epoll_slot.affair != EH_EPOLL_AFFAIR_EVENT_TRIGGER){
+            ret = -1;
+            goto out;
+        }
+
+        if(epoll_slot.event == &rw.exit_event){
+            ret = 0;
+            goto out;
+        }
+        
+        int n = (rand()%5) + 1;
+        int r_len;
+        for(int i=0; i < n && eh_ringbuf_size(rw.ringbuf); i++){
+            r_len = eh_ringbuf_read_acquire(rw.ringbuf, vec, rand()%(eh_ringbuf_size(rw.ringbuf)+1));
+            ret = test_buf_check(vec[0].base, (size_t)vec[0].len, (uint8_t)r_len_sum);
+            if(ret == 0)
+                ret = test_buf_check(vec[1].base, (size_t)vec[1].len, (uint8_t)(r_len_sum + vec[0].len));
+            if(ret < 0)
+                goto out;
+            r_len_sum += eh_ringbuf_read_release(rw.ringbuf, r_len);
+        }
+        
+    }
+
+out:
+    rw.exit = true;
+    pthread_join(thread_id, NULL);
+    eh_event_clean(&rw.exit_event);
+    eh_event_clean(&rw.w_event);
+    eh_ringbuf_destroy(rw.ringbuf);
+ringbuf_create_error:
+    eh_epoll_del(test_epoll);
+    return ret;
+}
+
+/* 预留/提交、获取/释放接口测试 */
+int test_reserve_interface(eh_ringbuf_t* ringbuf){
+    struct eh_ringbuf_iovec vec[2];
+    uint8_t test_buf[TEST_BUF_SIZE];
+
+    /* 用例1 未绕回时只有一段，提交前读者看不到数据 */
+    eh_ringbuf_reset(ringbuf);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_write_reserve(ringbuf, vec, 100) != 100, return -1);
+    EH_DBG_ERROR_EXEC(vec[0].base != ringbuf->buf || vec[0].len != 100 || vec[1].len != 0, return -1);
+    test_buf_init(vec[0].base, 100);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_size(ringbuf) != 0, return -1);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_write_commit(ringbuf, 100) != 100, return -1);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_size(ringbuf) != 100, return -1);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_read_acquire(ringbuf, vec, TEST_BUF_SIZE) != 100, return -1);
+    EH_DBG_ERROR_EXEC(vec[0].len != 100 || vec[1].len != 0 || test_buf_check(vec[0].base, 100, 0), return -1);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_free_size(ringbuf) != TEST_BUF_SIZE - 100, return -1);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_read_release(ringbuf, 100) != 100, return -1);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_size(ringbuf) != 0, return -1);
+
+    /* 用例2 绕回时分成两段 */
+    eh_ringbuf_reset(ringbuf);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_write(ringbuf, test_buf, TEST_BUF_SIZE - 10) != TEST_BUF_SIZE - 10, return -1);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_read_skip(ringbuf, TEST_BUF_SIZE - 10) != TEST_BUF_SIZE - 10, return -1);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_write_reserve(ringbuf, vec, TEST_BUF_SIZE + 1) != TEST_BUF_SIZE, return -1);
+    EH_DBG_ERROR_EXEC(vec[0].base != ringbuf->buf + TEST_BUF_SIZE - 10 || vec[0].len != 10, return -1);
+    EH_DBG_ERROR_EXEC(vec[1].base != ringbuf->buf || vec[1].len != TEST_BUF_SIZE - 10, return -1);
+    test_buf_init(vec[0].base, 10);
+    for(int i = 0; i < 30; i++)
+        vec[1].base[i] = (uint8_t)(10 + i);
+    /* 只提交写入的部分 */
+    EH_DBG_ERROR_EXEC(eh_ringbuf_write_commit(ringbuf, 40) != 40, return -1);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_read_acquire(ringbuf, vec, 40) != 40, return -1);
+    EH_DBG_ERROR_EXEC(vec[0].len != 10 || vec[1].len != 30, return -1);
+    EH_DBG_ERROR_EXEC(test_buf_check(vec[0].base, 10, 0) || test_buf_check(vec[1].base, 30, 10), return -1);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_read(ringbuf, test_buf, 40) != 40 || test_buf_check(test_buf, 40, 0), return -1);
+
+    /* 用例3 满时预留为0，空时获取为0 */
+    eh_ringbuf_reset(ringbuf);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_read_acquire(ringbuf, vec, 10) != 0 || vec[0].len != 0 || vec[1].len != 0, return -1);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_write(ringbuf, test_buf, TEST_BUF_SIZE) != TEST_BUF_SIZE, return -1);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_write_reserve(ringbuf, vec, 10) != 0 || vec[0].len != 0 || vec[1].len != 0, return -1);
+    eh_ringbuf_reset(ringbuf);
+
+    /* 用例4 并行随机预留/获取测试 */
+    EH_DBG_ERROR_EXEC(test_random_reserve_acquire(100049, 10000)!=0, return -1);
+    return 0;
+}
+
+/* 聚集写/分散读接口测试 */
+int test_vector_interface(void){
+    eh_ringbuf_t *ringbuf;
+    uint8_t test_buf[TEST_BUF_SIZE];
+    uint8_t a[100], b[300], c[700];
+    struct eh_ringbuf_iovec iov[3] = {{a, sizeof(a)}, {b, sizeof(b)}, {c, sizeof(c)}};
+
+    /* 非2的幂大小走取模路径 */
+    EH_DBG_ERROR_EXEC((ringbuf = eh_ringbuf_create(1000, NULL)) == NULL, return -1);
+    EH_DBG_ERROR_EXEC(ringbuf->flags & EH_RINGBUF_FLAGS_POW2, goto error);
+
+    /* 用例1 写入空间不足时只写入放得下的部分 */
+    test_buf_init(a, sizeof(a));
+    for(int i = 0; i < (int)sizeof(b); i++)
+        b[i] = (uint8_t)(sizeof(a) + (size_t)i);
+    for(int i = 0; i < (int)sizeof(c); i++)
+        c[i] = (uint8_t)(sizeof(a) + sizeof(b) + (size_t)i);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_writev(ringbuf, iov, 3) != 1000, goto error);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_read(ringbuf, test_buf, 1000) != 1000, goto error);
+    EH_DBG_ERROR_EXEC(test_buf_check(test_buf, 1000, 0), goto error);
+
+    /* 用例2 绕回时聚集写入与分散读出 */
+    EH_DBG_ERROR_EXEC(eh_ringbuf_writev(ringbuf, iov, 2) != 400, goto error);
+    memset(a, 0, sizeof(a));
+    memset(b, 0, sizeof(b));
+    EH_DBG_ERROR_EXEC(eh_ringbuf_readv(ringbuf, iov, 3) != 400, goto error);
+    EH_DBG_ERROR_EXEC(test_buf_check(a, sizeof(a), 0) || test_buf_check(b, sizeof(b), sizeof(a)), goto error);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_readv(ringbuf, iov, 3) != 0, goto error);
+    eh_ringbuf_destroy(ringbuf);
+
+    /* 用例3 2的幂大小走掩码路径，读写指针自由增长 */
+    EH_DBG_ERROR_EXEC((ringbuf = eh_ringbuf_create(512, NULL)) == NULL, return -1);
+    EH_DBG_ERROR_EXEC(!(ringbuf->flags & EH_RINGBUF_FLAGS_POW2), goto error);
+    for(int round = 0; round < 100; round++){
+        EH_DBG_ERROR_EXEC(eh_ringbuf_writev(ringbuf, iov, 2) != 400, goto error);
+        EH_DBG_ERROR_EXEC(eh_ringbuf_size(ringbuf) != 400 || eh_ringbuf_free_size(ringbuf) != 112, goto error);
+        EH_DBG_ERROR_EXEC(eh_ringbuf_read(ringbuf, test_buf, 400) != 400, goto error);
+        EH_DBG_ERROR_EXEC(test_buf_check(test_buf, 400, 0), goto error);
+    }
+    eh_ringbuf_destroy(ringbuf);
+    return 0;
+error:
+    eh_ringbuf_destroy(ringbuf);
+    return -1;
+}
+
+static uint64_t now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static double bench_rate(int32_t size, int32_t chunk, uint64_t total){
+    static uint8_t in[4096], out[4096];
+    eh_ringbuf_t *ringbuf;
+    uint64_t t;
+
+    ringbuf = eh_ringbuf_create(size, NULL);
+    if(eh_ptr_to_error(ringbuf) < 0)
+        return 0;
+    t = now_ns();
+    for(uint64_t n = 0; n < total; n += (uint64_t)chunk){
+        eh_ringbuf_write(ringbuf, in, chunk);
+        eh_ringbuf_read(ringbuf, out, chunk);
+    }
+    t = now_ns() - t;
+    eh_ringbuf_destroy(ringbuf);
+    return (double)total / ((double)t / 1e9) / (1024 * 1024);
+}
+
+/* 对比取模路径(非2的幂)与掩码路径的吞吐，单位MiB/s */
+static void bench(void){
+    static const int32_t chunk_tbl[] = {1, 64, 4096};
+    static const uint64_t total_tbl[] = {32ULL << 20, 512ULL << 20, 4096ULL << 20};
+    uint8_t a[16], b[16], c[16], d[16], out[64];
+    struct eh_ringbuf_iovec iov[4] = {{a, 16}, {b, 16}, {c, 16}, {d, 16}};
+    eh_ringbuf_t *ringbuf;
+    uint64_t t, write_ns, writev_ns;
+    double mod, mask;
+
+    for(size_t i = 0; i < EH_ARRAY_SIZE(chunk_tbl); i++){
+        mod = bench_rate((1 << 16) - 1, chunk_tbl[i], total_tbl[i]);
+        mask = bench_rate(1 << 16, chunk_tbl[i], total_tbl[i]);
+        eh_infofl("%4dB transfers: mod %.1fMiB/s, mask %.1fMiB/s", chunk_tbl[i], mod, mask);
+    }
+
+    ringbuf = eh_ringbuf_create(1 << 16, NULL);
+    if(eh_ptr_to_error(ringbuf) < 0)
+        return ;
+    t = now_ns();
+    for(int n = 0; n < 1000000; n++){
+        eh_ringbuf_write(ringbuf, a, 16);
+        eh_ringbuf_write(ringbuf, b, 16);
+        eh_ringbuf_write(ringbuf, c, 16);
+        eh_ringbuf_write(ringbuf, d, 16);
+        eh_ringbuf_read(ringbuf, out, 64);
+    }
+    write_ns = now_ns() - t;
+    t = now_ns();
+    for(int n = 0; n < 1000000; n++){
+        eh_ringbuf_writev(ringbuf, iov, 4);
+        eh_ringbuf_read(ringbuf, out, 64);
+    }
+    writev_ns = now_ns() - t;
+    eh_ringbuf_destroy(ringbuf);
+    eh_infofl("4 x 16B pieces: 4 x write %.1fns, writev %.1fns", (double)write_ns / 1e6, (double)writev_ns / 1e6);
+}
+
 /* 基础接口测试 */
 int test_basics_interface(eh_ringbuf_t* ringbuf){
     uint8_t test_buf[TEST_BUF_SIZE*2] = {0};
@@ -616,6 +863,9 @@ int test_basics_interface(eh_ringbuf_t* ringbuf){
 
     /* 用例22 并行随机偷看写测试 */
     EH_DBG_ERROR_EXEC(test_random_wr_peek(1024*200, 10000)!=0, return -1);
+
+    /* 用例23 2的幂大小(掩码路径)并行随机读写测试 */
+    EH_DBG_ERROR_EXEC(test_random_wr(1 << 16, 10000)!=0, return -1);
     
 
     return 0;
@@ -640,9 +890,25 @@ int task_app(void *arg){
         eh_errfl("test_basics_interface Fail");
         return -1;
     }
-    eh_ringbuf_destroy(ringbuf);
     eh_debugfl("test_basics_interface Pass");
 
+    ret = test_reserve_interface(ringbuf);
+    if(ret){
+        eh_errfl("test_reserve_interface Fail");
+        return -1;
+    }
+    eh_ringbuf_destroy(ringbuf);
+    eh_debugfl("test_reserve_interface Pass");
+
+    ret = test_vector_interface();
+    if(ret){
+        eh_errfl("test_vector_interface Fail");
+        return -1;
+    }
+    eh_debugfl("test_vector_interface Pass");
+
+    bench();
+
     return 0;
 }
 
@@ -0,0 +1,170 @@
+/**
+ * @file test_ringbuf_fd.c
+ * @brief 环形缓冲区fd搬运测试，用非阻塞socketpair检查跨越末尾的readv/writev、EAGAIN/满/EOF的返回值，
+ *        并对比经过中间缓冲区与直接readv/writev在两个pipe之间转发数据的耗时
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <eh.h>
+#include <eh_debug.h>
+#include <eh_error.h>
+#include <eh_ringbuf.h>
+#include <eh_ringbuf_fd.h>
+
+#define TEST_RING_SIZE          (4096)
+#define TEST_BENCH_RING_SIZE    (64*1024)
+#define TEST_BENCH_CHUNK        (16*1024)
+#define TEST_BENCH_TOTAL        (256*1024*1024U)
+#define TEST_BENCH_ROUND        (5)
+
+void stdout_write(void *stream, const uint8_t *buf, size_t size){
+    (void)stream;
+    printf("%.*s", (int)size, (const char*)buf);
+}
+
+static uint64_t now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void set_nonblock(int fd){
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+static int test_socket(void){
+    static uint8_t in[TEST_RING_SIZE], out[TEST_RING_SIZE];
+    eh_ringbuf_t *ringbuf;
+    int sv[2], ret = -1;
+    int i;
+
+    EH_DBG_ERROR_EXEC(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0, return -1);
+    set_nonblock(sv[0]);
+    set_nonblock(sv[1]);
+    ringbuf = eh_ringbuf_create(TEST_RING_SIZE, NULL);
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(ringbuf) < 0, goto ringbuf_error);
+    for(i = 0; i < TEST_RING_SIZE; i++)
+        in[i] = (uint8_t)(i * 3);
+
+    /* 无数据时与EOF区分开 */
+    EH_DBG_ERROR_EXEC(eh_ringbuf_read_from_fd(ringbuf, sv[0]) != EH_RET_AGAIN, goto error);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_write_to_fd(ringbuf, sv[0]) != 0, goto error);
+
+    /* 把读写指针推到末尾附近，之后的readv/writev都跨越末尾 */
+    EH_DBG_ERROR_EXEC(eh_ringbuf_write(ringbuf, in, TEST_RING_SIZE - 100) != TEST_RING_SIZE - 100, goto error);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_read_skip(ringbuf, TEST_RING_SIZE - 100) != TEST_RING_SIZE - 100, goto error);
+    EH_DBG_ERROR_EXEC(write(sv[1], in, 1000) != 1000, goto error);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_read_from_fd(ringbuf, sv[0]) != 1000, goto error);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_write_to_fd(ringbuf, sv[0]) != 1000, goto error);
+    EH_DBG_ERROR_EXEC(read(sv[1], out, sizeof(out)) != 1000 || memcmp(out, in, 1000) != 0, goto error);
+
+    /* 缓冲区满 */
+    EH_DBG_ERROR_EXEC(write(sv[1], in, TEST_RING_SIZE) != TEST_RING_SIZE, goto error);
+    EH_DBG_ERROR_EXEC(write(sv[1], in, 10) != 10, goto error);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_read_from_fd(ringbuf, sv[0]) != TEST_RING_SIZE, goto error);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_read_from_fd(ringbuf, sv[0]) != EH_RET_BUSY, goto error);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_read(ringbuf, out, TEST_RING_SIZE) != TEST_RING_SIZE, goto error);
+    EH_DBG_ERROR_EXEC(memcmp(out, in, TEST_RING_SIZE) != 0, goto error);
+
+    /* 剩余数据读完后对端关闭返回0 */
+    shutdown(sv[1], SHUT_WR);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_read_from_fd(ringbuf, sv[0]) != 10, goto error);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_read_from_fd(ringbuf, sv[0]) != 0, goto error);
+
+    /* 其他错误 */
+    EH_DBG_ERROR_EXEC(eh_ringbuf_write_to_fd(ringbuf, -1) != EH_RET_FAULT, goto error);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_size(ringbuf) != 10, goto error);
+    ret = 0;
+error:
+    eh_ringbuf_destroy(ringbuf);
+ringbuf_error:
+    close(sv[0]);
+    close(sv[1]);
+    return ret;
+}
+
+/* src -> ringbuf -> dst，bounce为真时经过中间缓冲区 */
+static uint64_t bench_forward(bool bounce){
+    static uint8_t payload[TEST_BENCH_CHUNK], tmp[TEST_BENCH_RING_SIZE];
+    eh_ringbuf_t *ringbuf;
+    int src[2], dst[2];
+    uint64_t t, moved = 0;
+    ssize_t n;
+
+    if(pipe(src) < 0)
+        return 0;
+    if(pipe(dst) < 0){
+        close(src[0]);
+        close(src[1]);
+        return 0;
+    }
+    set_nonblock(src[0]);
+    set_nonblock(dst[1]);
+    ringbuf = eh_ringbuf_create(TEST_BENCH_RING_SIZE, NULL);
+    t = now_ns();
+    while(eh_ptr_to_error(ringbuf) == 0 && moved < TEST_BENCH_TOTAL){
+        if(write(src[1], payload, sizeof(payload)) < 0)
+            break;
+        if(bounce){
+            n = read(src[0], tmp, (size_t)eh_ringbuf_free_size(ringbuf));
+            if(n > 0)
+                eh_ringbuf_write(ringbuf, tmp, (int32_t)n);
+            n = eh_ringbuf_peek_copy(ringbuf, 0, tmp, eh_ringbuf_size(ringbuf));
+            n = write(dst[1], tmp, (size_t)n);
+            if(n > 0)
+                eh_ringbuf_read_skip(ringbuf, (int32_t)n);
+        }else{
+            eh_ringbuf_read_from_fd(ringbuf, src[0]);
+            n = eh_ringbuf_write_to_fd(ringbuf, dst[1]);
+        }
+        while((n = read(dst[0], tmp, sizeof(tmp))) == sizeof(tmp));
+        moved += sizeof(payload);
+    }
+    t = now_ns() - t;
+    if(eh_ptr_to_error(ringbuf) == 0)
+        eh_ringbuf_destroy(ringbuf);
+    close(src[0]);
+    close(src[1]);
+    close(dst[0]);
+    close(dst[1]);
+    return t;
+}
+
+static void bench(void){
+    uint64_t bounce_ns = UINT64_MAX, direct_ns = UINT64_MAX, t;
+    /* 交替运行取最小值，减少调度抖动的影响 */
+    for(int r = 0; r < TEST_BENCH_ROUND; r++){
+        t = bench_forward(true);
+        bounce_ns = t < bounce_ns ? t : bounce_ns;
+        t = bench_forward(false);
+        direct_ns = t < direct_ns ? t : direct_ns;
+    }
+    eh_infofl("forward %uMiB pipe->ringbuf->pipe: bounce buffer %.1fMiB/s, readv/writev %.1fMiB/s",
+        TEST_BENCH_TOTAL / 1024 / 1024,
+        (double)TEST_BENCH_TOTAL / 1024 / 1024 / ((double)bounce_ns / 1e9),
+        (double)TEST_BENCH_TOTAL / 1024 / 1024 / ((double)direct_ns / 1e9));
+}
+
+int main(void){
+    int fail = 0;
+
+    eh_global_init();
+    if(test_socket() < 0)
+        fail++;
+    bench();
+    eh_infofl("fail=%d", fail);
+    eh_global_exit();
+    return fail ? -1 : 0;
+}
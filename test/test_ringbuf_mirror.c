@@ -0,0 +1,189 @@
+/**
+ * @file test_ringbuf_mirror.c
+ * @brief 镜像环形缓冲区测试，检查两段映射互为别名、跨越末尾的读写/预留/偷看只返回一段连续内存、
+ *        随机读写的数据完整性，并对比普通与镜像环形缓冲区上原地解析报文的耗时
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <eh.h>
+#include <eh_debug.h>
+#include <eh_error.h>
+#include <eh_ringbuf.h>
+#include <eh_ringbuf_mirror.h>
+
+#define TEST_RING_SIZE          (64*1024)
+#define TEST_MSG_SIZE           (1500)
+#define TEST_BENCH_MSG_CNT      (200000)
+
+void stdout_write(void *stream, const uint8_t *buf, size_t size){
+    (void)stream;
+    printf("%.*s", (int)size, (const char*)buf);
+}
+
+static uint64_t now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int test_alias(void){
+    eh_ringbuf_t *ringbuf;
+    int32_t size;
+
+    /* 不是页大小整数倍的请求会向上取整 */
+    ringbuf = eh_ringbuf_create_mirrored(1000);
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(ringbuf) < 0, return -1);
+    size = eh_ringbuf_total_size(ringbuf);
+    EH_DBG_ERROR_EXEC(size != (int32_t)sysconf(_SC_PAGESIZE), goto error);
+    ringbuf->buf[0] = 0x11;
+    ringbuf->buf[size + 1] = 0x22;
+    EH_DBG_ERROR_EXEC(ringbuf->buf[size] != 0x11 || ringbuf->buf[1] != 0x22, goto error);
+    eh_ringbuf_destroy_mirrored(ringbuf);
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(eh_ringbuf_create_mirrored(0)) != EH_RET_INVALID_PARAM, return -1);
+    return 0;
+error:
+    eh_ringbuf_destroy_mirrored(ringbuf);
+    return -1;
+}
+
+static int test_wrap(void){
+    static uint8_t in[TEST_RING_SIZE], out[TEST_RING_SIZE];
+    struct eh_ringbuf_iovec vec[2];
+    const uint8_t *p;
+    eh_ringbuf_t *ringbuf;
+    int32_t len;
+    int i;
+
+    ringbuf = eh_ringbuf_create_mirrored(TEST_RING_SIZE);
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(ringbuf) < 0, return -1);
+    for(i = 0; i < TEST_RING_SIZE; i++)
+        in[i] = (uint8_t)(i * 7);
+    /* 把读写指针推到末尾前100字节处 */
+    EH_DBG_ERROR_EXEC(eh_ringbuf_write(ringbuf, in, TEST_RING_SIZE - 100) != TEST_RING_SIZE - 100, goto error);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_read_skip(ringbuf, TEST_RING_SIZE - 100) != TEST_RING_SIZE - 100, goto error);
+
+    /* 预留跨越末尾时只有一段 */
+    EH_DBG_ERROR_EXEC(eh_ringbuf_write_reserve(ringbuf, vec, 1000) != 1000, goto error);
+    EH_DBG_ERROR_EXEC(vec[0].len != 1000 || vec[1].len != 0, goto error);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_write(ringbuf, in, 1000) != 1000, goto error);
+
+    /* 偷看跨越末尾的数据也是0拷贝 */
+    len = 1000;
+    p = eh_ringbuf_peek(ringbuf, 0, out, &len);
+    EH_DBG_ERROR_EXEC(p != ringbuf->buf + TEST_RING_SIZE - 100 || len != 1000, goto error);
+    EH_DBG_ERROR_EXEC(memcmp(p, in, 1000) != 0, goto error);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_read_acquire(ringbuf, vec, 1000) != 1000 || vec[1].len != 0, goto error);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_read(ringbuf, out, 1000) != 1000 || memcmp(out, in, 1000) != 0, goto error);
+
+    /* 写满整个缓冲区 */
+    EH_DBG_ERROR_EXEC(eh_ringbuf_write(ringbuf, in, TEST_RING_SIZE) != TEST_RING_SIZE, goto error);
+    EH_DBG_ERROR_EXEC(eh_ringbuf_peek_copy(ringbuf, 0, out, TEST_RING_SIZE) != TEST_RING_SIZE, goto error);
+    EH_DBG_ERROR_EXEC(memcmp(out, in, TEST_RING_SIZE) != 0, goto error);
+    eh_ringbuf_destroy_mirrored(ringbuf);
+    return 0;
+error:
+    eh_ringbuf_destroy_mirrored(ringbuf);
+    return -1;
+}
+
+static int test_random(void){
+    static uint8_t in[TEST_RING_SIZE], out[TEST_RING_SIZE];
+    eh_ringbuf_t *ringbuf;
+    uint32_t w_sum = 0, r_sum = 0;
+    int32_t len, n;
+
+    ringbuf = eh_ringbuf_create_mirrored(TEST_RING_SIZE);
+    EH_DBG_ERROR_EXEC(eh_ptr_to_error(ringbuf) < 0, return -1);
+    srand((unsigned int)time(NULL));
+    for(int round = 0; round < 20000; round++){
+        len = rand() % (eh_ringbuf_free_size(ringbuf) + 1);
+        for(int32_t i = 0; i < len; i++)
+            in[i] = (uint8_t)(w_sum + (uint32_t)i);
+        w_sum += (uint32_t)eh_ringbuf_write(ringbuf, in, len);
+        len = rand() % (eh_ringbuf_size(ringbuf) + 1);
+        n = eh_ringbuf_read(ringbuf, out, len);
+        for(int32_t i = 0; i < n; i++){
+            EH_DBG_ERROR_EXEC(out[i] != (uint8_t)(r_sum + (uint32_t)i), goto error);
+        }
+        r_sum += (uint32_t)n;
+    }
+    eh_ringbuf_destroy_mirrored(ringbuf);
+    return 0;
+error:
+    eh_ringbuf_destroy_mirrored(ringbuf);
+    return -1;
+}
+
+/* 模拟解析器: 报文头部2字节长度，直接在偷看到的内存上计算校验和 */
+static uint64_t bench_parse(eh_ringbuf_t *ringbuf, size_t *copy_cnt){
+    static uint8_t msg[TEST_MSG_SIZE], tmp[TEST_MSG_SIZE];
+    const uint8_t *p;
+    uint32_t sum = 0;
+    int32_t len;
+    uint64_t t;
+
+    memset(msg, 0x5a, sizeof(msg));
+    msg[0] = (uint8_t)(TEST_MSG_SIZE >> 8);
+    msg[1] = (uint8_t)TEST_MSG_SIZE;
+    *copy_cnt = 0;
+    t = now_ns();
+    for(int i = 0; i < TEST_BENCH_MSG_CNT; i++){
+        eh_ringbuf_write(ringbuf, msg, TEST_MSG_SIZE);
+        len = TEST_MSG_SIZE;
+        p = eh_ringbuf_peek(ringbuf, 0, tmp, &len);
+        if(p == tmp)
+            (*copy_cnt)++;
+        len = (int32_t)((p[0] << 8) | p[1]);
+        for(int32_t j = 2; j < len; j += 64)
+            sum += p[j];
+        eh_ringbuf_read_skip(ringbuf, len);
+    }
+    t = now_ns() - t;
+    (void)sum;
+    return t;
+}
+
+static void bench(void){
+    eh_ringbuf_t *plain, *mirrored;
+    size_t plain_copy, mirrored_copy;
+    uint64_t plain_ns, mirrored_ns;
+
+    plain = eh_ringbuf_create(TEST_RING_SIZE, NULL);
+    mirrored = eh_ringbuf_create_mirrored(TEST_RING_SIZE);
+    if(eh_ptr_to_error(plain) < 0 || eh_ptr_to_error(mirrored) < 0)
+        return ;
+    plain_ns = bench_parse(plain, &plain_copy);
+    mirrored_ns = bench_parse(mirrored, &mirrored_copy);
+    eh_infofl("parse %d x %dB msgs: plain %lluns/msg (%lu copies), mirrored %lluns/msg (%lu copies)",
+        TEST_BENCH_MSG_CNT, TEST_MSG_SIZE,
+        (unsigned long long)(plain_ns / TEST_BENCH_MSG_CNT), (unsigned long)plain_copy,
+        (unsigned long long)(mirrored_ns / TEST_BENCH_MSG_CNT), (unsigned long)mirrored_copy);
+    eh_ringbuf_destroy(plain);
+    eh_ringbuf_destroy_mirrored(mirrored);
+}
+
+int main(void){
+    int fail = 0;
+
+    eh_global_init();
+    if(test_alias() < 0)
+        fail++;
+    if(test_wrap() < 0)
+        fail++;
+    if(test_random() < 0)
+        fail++;
+    bench();
+    eh_infofl("fail=%d", fail);
+    eh_global_exit();
+    return fail ? -1 : 0;
+}
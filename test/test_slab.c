@@ -0,0 +1,157 @@
+/**
+ * @file test_slab.c
+ * @brief 对象缓存测试，跨多个块分配后乱序释放，检查块的申请与回收以及统计信息，
+ *        并和 eh_malloc 对比分配释放耗时，最后打印运行时内部各对象缓存的统计
+ * @author simon.xiaoapeng (simon.xiaoapeng@gmail.com)
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026  simon.xiaoapeng@gmail.com
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <eh.h>
+#include <eh_debug.h>
+#include <eh_event.h>
+#include <eh_mem.h>
+#include <eh_mutex.h>
+#include <eh_sem.h>
+#include <eh_slab.h>
+
+#define TEST_OBJ_NUM            (EH_CONFIG_SLAB_CHUNK_OBJ_CNT * 10 + 3)
+#define TEST_BENCH_CNT          (200000)
+
+struct test_obj{
+    uint64_t                    id;
+    uint8_t                     data[40];
+};
+
+EH_DEFINE_STATIC_SLAB_CACHE(test_obj_cache, struct test_obj);
+
+static struct test_obj *objs[TEST_OBJ_NUM];
+
+void stdout_write(void *stream, const uint8_t *buf, size_t size){
+    (void)stream;
+    printf("%.*s", (int)size, (const char*)buf);
+}
+
+static uint64_t now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void stat_print(const struct eh_slab_cache_stat *stat){
+    eh_infofl("%-24s size %-4lu chunk %-3lu inuse %-5lu max %-5lu alloc %-8lu fail %lu",
+        stat->name, (unsigned long)stat->obj_size, (unsigned long)stat->chunk_cnt,
+        (unsigned long)stat->inuse_cnt, (unsigned long)stat->max_inuse_cnt,
+        (unsigned long)stat->alloc_cnt, (unsigned long)stat->fail_cnt);
+}
+
+static int test_alloc_free(void){
+    struct eh_slab_cache_stat stat;
+    size_t i;
+
+    for(i = 0; i < TEST_OBJ_NUM; i++){
+        objs[i] = eh_slab_alloc(&test_obj_cache);
+        EH_DBG_ERROR_EXEC(objs[i] == NULL, return -1);
+        EH_DBG_ERROR_EXEC(((uintptr_t)objs[i] & (_Alignof(struct test_obj) - 1)) != 0, return -1);
+        objs[i]->id = i;
+        memset(objs[i]->data, (int)i, sizeof(objs[i]->data));
+    }
+    eh_slab_cache_get_stat(&test_obj_cache, &stat);
+    stat_print(&stat);
+    EH_DBG_ERROR_EXEC(stat.inuse_cnt != TEST_OBJ_NUM, return -1);
+    EH_DBG_ERROR_EXEC(stat.chunk_cnt != (TEST_OBJ_NUM + EH_CONFIG_SLAB_CHUNK_OBJ_CNT - 1) / EH_CONFIG_SLAB_CHUNK_OBJ_CNT, return -1);
+
+    /* 先释放奇数项，块都还有对象在用，不应该被回收 */
+    for(i = 1; i < TEST_OBJ_NUM; i += 2){
+        EH_DBG_ERROR_EXEC(objs[i]->id != i, return -1);
+        eh_slab_free(&test_obj_cache, objs[i]);
+        objs[i] = NULL;
+    }
+    eh_slab_cache_get_stat(&test_obj_cache, &stat);
+    stat_print(&stat);
+    EH_DBG_ERROR_EXEC(stat.chunk_cnt != (TEST_OBJ_NUM + EH_CONFIG_SLAB_CHUNK_OBJ_CNT - 1) / EH_CONFIG_SLAB_CHUNK_OBJ_CNT, return -1);
+
+    /* 重新分配，应该复用已有块中的空闲对象 */
+    for(i = 1; i < TEST_OBJ_NUM; i += 2){
+        objs[i] = eh_slab_alloc(&test_obj_cache);
+        EH_DBG_ERROR_EXEC(objs[i] == NULL, return -1);
+        objs[i]->id = i;
+    }
+    eh_slab_cache_get_stat(&test_obj_cache, &stat);
+    EH_DBG_ERROR_EXEC(stat.chunk_cnt != (TEST_OBJ_NUM + EH_CONFIG_SLAB_CHUNK_OBJ_CNT - 1) / EH_CONFIG_SLAB_CHUNK_OBJ_CNT, return -1);
+
+    for(i = 0; i < TEST_OBJ_NUM; i++){
+        EH_DBG_ERROR_EXEC(objs[i]->id != i, return -1);
+        eh_slab_free(&test_obj_cache, objs[i]);
+        objs[i] = NULL;
+    }
+    eh_slab_cache_get_stat(&test_obj_cache, &stat);
+    stat_print(&stat);
+    /* 全部释放后只保留一个块 */
+    EH_DBG_ERROR_EXEC(stat.inuse_cnt != 0 || stat.chunk_cnt != 1, return -1);
+    return 0;
+}
+
+static void bench(void){
+    uint64_t t, slab_ns, malloc_ns;
+    void *p[16];
+    int i, j;
+
+    t = now_ns();
+    for(i = 0; i < TEST_BENCH_CNT; i++){
+        for(j = 0; j < 16; j++)
+            p[j] = eh_slab_alloc(&test_obj_cache);
+        for(j = 0; j < 16; j++)
+            eh_slab_free(&test_obj_cache, p[j]);
+    }
+    slab_ns = now_ns() - t;
+
+    t = now_ns();
+    for(i = 0; i < TEST_BENCH_CNT; i++){
+        for(j = 0; j < 16; j++)
+            p[j] = eh_malloc(sizeof(struct test_obj));
+        for(j = 0; j < 16; j++)
+            eh_free(p[j]);
+    }
+    malloc_ns = now_ns() - t;
+
+    eh_infofl("alloc+free pair: slab %lluns, eh_malloc %lluns",
+        (unsigned long long)(slab_ns / (TEST_BENCH_CNT * 16ULL)),
+        (unsigned long long)(malloc_ns / (TEST_BENCH_CNT * 16ULL)));
+}
+
+int main(void){
+    eh_mutex_t mutex;
+    eh_sem_t sem;
+    eh_epoll_t epoll;
+    EH_DEFINE_EVENT(event);
+    int ret = 0;
+
+    eh_global_init();
+    if(test_alloc_free() < 0){
+        eh_errfl("test_alloc_free failed");
+        ret = -1;
+    }
+    bench();
+
+    mutex = eh_mutex_create(EH_MUTEX_TYPE_NORMAL);
+    sem = eh_sem_create(0);
+    epoll = eh_epoll_new();
+    eh_epoll_add_event(epoll, &event, NULL);
+    eh_infofl("slab caches:");
+    eh_slab_stat_dump(stat_print);
+    eh_epoll_del(epoll);
+    eh_sem_destroy(sem);
+    eh_mutex_destroy(mutex);
+    eh_event_clean(&event);
+
+    eh_infofl("result: %s", ret == 0 ? "pass" : "fail");
+    eh_global_exit();
+    return ret;
+}